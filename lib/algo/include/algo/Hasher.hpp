@@ -0,0 +1 @@
+#include "../../src/Hasher.hpp"
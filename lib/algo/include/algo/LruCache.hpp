@@ -0,0 +1 @@
+#include "../../src/LruCache.hpp"
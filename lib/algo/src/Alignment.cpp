@@ -18,12 +18,12 @@
  ***************************************************************************/
 
 
+#include <bitset>
 #include <cassert>
 #include <cmath>
 
 
 #include <boost/optional.hpp>
-#include <boost/variant.hpp>
 
 
 #include "Alignment.hpp"
@@ -46,13 +46,6 @@ _Pair::_Pair(size_t key, size_t value)
 {}
 
 
-struct _PrevNext
-{
-   boost::optional<_Pair> prevPair;
-   boost::optional<_Pair> nextPair;
-};
-
-
 size_t _valueByNormalizedKeyAndKeyRange(
    size_t key,
    size_t keyMax,
@@ -214,49 +207,6 @@ size_t _valueByKeyAndKeyRange(
 }
 
 
-template<typename Map>
-boost::variant<size_t, _PrevNext> _lookupMap(const Map &map, size_t key)
-{
-   typedef typename Map::const_iterator const_iterator;
-   const std::pair<const_iterator, const_iterator> er = map.equal_range(key);
-   const const_iterator begin = map.begin();
-   const const_iterator end = map.end();
-   const_iterator lower = er.first;
-   const const_iterator upper = er.second;
-
-   _PrevNext pn;
-
-   if (lower != end)
-   {
-      while (lower->first > key && lower != begin)
-      {
-         --lower;
-      }
-
-      if (lower->first == key)
-      {
-         return boost::variant<size_t, _PrevNext>(lower->second);
-      }
-      else if (lower->first < key)
-      {
-         pn.prevPair = _Pair(lower->first, lower->second);
-      }
-   }
-   else if (!map.empty())
-   {
-      --lower;
-      pn.prevPair = _Pair(lower->first, lower->second);
-   }
-
-   if (upper != end)
-   {
-      pn.nextPair = _Pair(upper->first, upper->second);
-   }
-
-   return boost::variant<size_t, _PrevNext>(pn);
-}
-
-
 }
 
 
@@ -295,7 +245,7 @@ Alignment::const_iterator & Alignment::const_iterator::operator++()
 {
    if (m_alignment)
    {
-      if (m_nextIt == m_alignment->bimapEnd())
+      if (m_nextIt == m_alignment->matchEnd())
       {
          if (m_left)
          {
@@ -370,8 +320,8 @@ Alignment::const_iterator::const_iterator(
    {
       if (begin)
       {
-         m_nextIt = m_alignment->bimapBegin();
-         if (m_nextIt != m_alignment->bimapEnd())
+         m_nextIt = m_alignment->matchBegin();
+         if (m_nextIt != m_alignment->matchEnd())
          {
             if (!m_nextIt->left && !m_nextIt->right)
             {
@@ -392,7 +342,7 @@ Alignment::const_iterator::const_iterator(
       }
       else
       {
-         m_nextIt = m_alignment->bimapEnd();
+         m_nextIt = m_alignment->matchEnd();
       }
       assert(!m_left || *m_left < m_alignment->leftSize());
       assert(!m_right || *m_right < m_alignment->rightSize());
@@ -407,37 +357,15 @@ Alignment::const_iterator::const_iterator(
 
 size_t Alignment::rightIndex(size_t leftIndex) const
 {
-   boost::variant<size_t, _PrevNext> v = _lookupMap(m_bimap.left, leftIndex);
-   if (_PrevNext * prevNext = boost::get<_PrevNext>(&v))
-   {
-      return _valueByKeyAndKeyRange(
-         prevNext->prevPair,
-         prevNext->nextPair,
-         leftIndex,
-         m_leftSize,
-         m_rightSize
-      );
-   }
-
-   return *boost::get<size_t>(&v);
+   assert(leftIndex < m_rightByLeft.size());
+   return m_rightByLeft[leftIndex];
 }
 
 
 size_t Alignment::leftIndex(size_t rightIndex) const
 {
-   boost::variant<size_t, _PrevNext> v = _lookupMap(m_bimap.right, rightIndex);
-   if (_PrevNext * prevNext = boost::get<_PrevNext>(&v))
-   {
-      return _valueByKeyAndKeyRange(
-         prevNext->prevPair,
-         prevNext->nextPair,
-         rightIndex,
-         m_rightSize,
-         m_leftSize
-      );
-   }
-
-   return *boost::get<size_t>(&v);
+   assert(rightIndex < m_leftByRight.size());
+   return m_leftByRight[rightIndex];
 }
 
 
@@ -447,11 +375,76 @@ size_t Alignment::index(size_t i, bool rightByLeft) const
 }
 
 
+size_t Alignment::lcsLength(const uint64_t * column, size_t rows)
+{
+   size_t ones = 0;
+   for (size_t w = 0, count = rows / 64; w < count; ++w)
+   {
+      ones += std::bitset<64>(column[w]).count();
+   }
+   if (rows % 64)
+   {
+      const uint64_t mask = (uint64_t(1) << (rows % 64)) - 1;
+      ones += std::bitset<64>(column[rows / 64] & mask).count();
+   }
+   return rows - ones;
+}
+
+
+void Alignment::initializeIndices()
+{
+   if (!m_leftSize || !m_rightSize)
+   {
+      return;
+   }
+
+   m_rightByLeft.resize(m_leftSize);
+   m_leftByRight.resize(m_rightSize);
+   boost::optional<_Pair> prevByLeft;
+   boost::optional<_Pair> prevByRight;
+   size_t leftIndex = 0;
+   size_t rightIndex = 0;
+   for (size_t i = 0, count = m_matches.size(); i <= count; ++i)
+   {
+      // Elements between two matches are placed proportionally;
+      boost::optional<_Pair> nextByLeft;
+      boost::optional<_Pair> nextByRight;
+      if (i < count)
+      {
+         const Match & match = m_matches[i];
+         nextByLeft = _Pair(match.left, match.right);
+         nextByRight = _Pair(match.right, match.left);
+      }
+      const size_t leftEnd = (i < count) ? m_matches[i].left : m_leftSize;
+      for (; leftIndex < leftEnd; ++leftIndex)
+      {
+         m_rightByLeft[leftIndex] = _valueByKeyAndKeyRange(
+            prevByLeft, nextByLeft, leftIndex, m_leftSize, m_rightSize
+         );
+      }
+      const size_t rightEnd = (i < count) ? m_matches[i].right : m_rightSize;
+      for (; rightIndex < rightEnd; ++rightIndex)
+      {
+         m_leftByRight[rightIndex] = _valueByKeyAndKeyRange(
+            prevByRight, nextByRight, rightIndex, m_rightSize, m_leftSize
+         );
+      }
+      if (i < count)
+      {
+         m_rightByLeft[leftIndex++] = m_matches[i].right;
+         m_leftByRight[rightIndex++] = m_matches[i].left;
+      }
+      prevByLeft = nextByLeft;
+      prevByRight = nextByRight;
+   }
+}
+
+
 std::ostream & operator<<(std::ostream & os, const Alignment & al)
 {
    os << "{";
-   Alignment::const_bimap_iterator it = al.bimapBegin();
-   Alignment::const_bimap_iterator ite = al.bimapEnd();
+   Alignment::const_match_iterator it = al.matchBegin();
+   Alignment::const_match_iterator ite = al.matchEnd();
    for (bool isFirst = true; it != ite; ++it)
    {
       if (isFirst)
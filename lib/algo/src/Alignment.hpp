@@ -22,12 +22,14 @@
 #define ALGO_ALIGNMENT_HPP
 
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <functional>
+#include <unordered_map>
 #include <vector>
 
 
-#include <boost/bimap.hpp>
 #include <boost/multi_array.hpp>
 #include <boost/optional.hpp>
 
@@ -103,8 +105,13 @@ LcsMatrix::LcsMatrix(
 class Alignment
 {
    public:
-      typedef boost::bimap<size_t, size_t>::const_iterator
-         const_bimap_iterator;
+      struct Match
+      {
+         size_t left;
+         size_t right;
+      };
+
+      typedef std::vector<Match>::const_iterator const_match_iterator;
 
       class const_iterator
       {
@@ -124,7 +131,7 @@ class Alignment
             const_iterator(const Alignment * alignment, bool begin);
 
             const Alignment * m_alignment;
-            const_bimap_iterator m_nextIt;
+            const_match_iterator m_nextIt;
             boost::optional<size_t> m_left;
             boost::optional<size_t> m_right;
       };
@@ -143,28 +150,56 @@ class Alignment
       size_t leftIndex(size_t rightIndex) const;
       size_t index(size_t i, bool rightByLeft) const;
 
-      inline const_bimap_iterator bimapBegin() const;
-      inline const_bimap_iterator bimapEnd() const;
+      inline const_match_iterator matchBegin() const;
+      inline const_match_iterator matchEnd() const;
 
       inline const_iterator begin() const;
       inline const_iterator end() const;
 
    private:
-      boost::bimap<size_t, size_t> m_bimap;
+      // Bit masks of the left elements matching each right one, one mask of
+      // the given words per distinct right element. Elements compared by
+      // std::equal_to are hashed, any other equals is called per pair;
+      template<typename T>
+      static void matchMasks(
+         const std::vector<T> & left,
+         const std::vector<T> & right,
+         const std::equal_to<T> & equals,
+         size_t words,
+         std::vector<uint64_t> & masks,
+         std::vector<size_t> & maskByRight
+      );
+      template<typename T, typename Equals>
+      static void matchMasks(
+         const std::vector<T> & left,
+         const std::vector<T> & right,
+         const Equals & equals,
+         size_t words,
+         std::vector<uint64_t> & masks,
+         std::vector<size_t> & maskByRight
+      );
+
+      static size_t lcsLength(const uint64_t * column, size_t rows);
+      void initializeIndices();
+
+      std::vector<Match> m_matches; // Ordered by both sides;
       size_t m_leftSize;
       size_t m_rightSize;
+      // Mapped or interpolated index for every element of each side;
+      std::vector<size_t> m_rightByLeft;
+      std::vector<size_t> m_leftByRight;
 };
 
 
-inline Alignment::const_bimap_iterator Alignment::bimapBegin() const
+inline Alignment::const_match_iterator Alignment::matchBegin() const
 {
-   return m_bimap.begin();
+   return m_matches.begin();
 }
 
 
-inline Alignment::const_bimap_iterator Alignment::bimapEnd() const
+inline Alignment::const_match_iterator Alignment::matchEnd() const
 {
-   return m_bimap.end();
+   return m_matches.end();
 }
 
 
@@ -190,33 +225,133 @@ Alignment::Alignment(
    const Equals & equals
 ) : m_leftSize(left.size()), m_rightSize(right.size())
 {
-   LcsMatrix matrix(left, right, equals);
-   //assert(matrix.shape()[0] == m_leftSize + 1);
-   //assert(matrix.shape()[1] == m_rightSize + 1);
+   // Bit-parallel LCS (Hyyro), instead of a whole LcsMatrix every column
+   // keeps one bit per left element, a clear bit telling that the element
+   // lengthens the LCS of the left prefix with the right one.
+   // All the columns are kept, n * m / 64 words rather than the O(n + m) of
+   // Hirschberg's split. The split solves halves whose own LCS ties are
+   // broken differently from the walk over the whole matrix, so it gives
+   // other matches, while crossing-over relies on exactly these. Chromosomes
+   // are a few hundred instructions long, which keeps the columns small;
+   const size_t words = (m_leftSize + 63) / 64;
+   std::vector<uint64_t> masks;
+   std::vector<size_t> maskByRight;
+   matchMasks(left, right, equals, words, masks, maskByRight);
+
+   std::vector<uint64_t> columns((m_rightSize + 1) * words, ~uint64_t(0));
+   for (size_t j = 0; j < m_rightSize; ++j)
+   {
+      const uint64_t * matches = masks.data() + maskByRight[j] * words;
+      const uint64_t * v = columns.data() + j * words;
+      uint64_t * next = columns.data() + (j + 1) * words;
+      uint64_t carry = 0;
+      for (size_t w = 0; w < words; ++w)
+      {
+         const uint64_t u = v[w] & matches[w];
+         const uint64_t sum = v[w] + u;
+         const uint64_t total = sum + carry;
+         carry = ((sum < u) || (total < carry)) ? 1 : 0;
+         next[w] = total | (v[w] & ~matches[w]);
+      }
+   }
 
+   // Same walk back as over the LcsMatrix: take matches, otherwise go up
+   // only when going left shortens the LCS;
    size_t i = m_leftSize;
    size_t j = m_rightSize;
+   size_t length = lcsLength(columns.data() + j * words, i);
    while (i > 0 && j > 0)
    {
-      if (equals(left[i - 1], right[j - 1]))
+      const size_t word = (i - 1) / 64;
+      const size_t shift = (i - 1) % 64;
+      if ((masks[maskByRight[j - 1] * words + word] >> shift) & 1)
       {
-         m_bimap.insert(m_bimap.begin(),
-            boost::bimap<size_t, size_t>::value_type(i - 1, j - 1));
+         m_matches.push_back(Match());
+         m_matches.back().left = i - 1;
+         m_matches.back().right = j - 1;
          --i;
          --j;
+         --length;
       }
-      else if (matrix.at(i - 1, j) > matrix.at(i, j - 1))
+      else
       {
-         --i;
+         const uint64_t bit = columns[j * words + word] >> shift;
+         const size_t upLength = length - ((bit & 1) ? 0 : 1);
+         const size_t leftLength =
+            lcsLength(columns.data() + (j - 1) * words, i);
+         if (upLength > leftLength)
+         {
+            --i;
+            length = upLength;
+         }
+         else
+         {
+            --j;
+            length = leftLength;
+         }
       }
-      else
+   }
+   std::reverse(m_matches.begin(), m_matches.end());
+   initializeIndices();
+}
+
+
+template<typename T>
+void Alignment::matchMasks(
+   const std::vector<T> & left,
+   const std::vector<T> & right,
+   const std::equal_to<T> &,
+   size_t words,
+   std::vector<uint64_t> & masks,
+   std::vector<size_t> & maskByRight
+)
+{
+   std::unordered_map<T, size_t> maskByKey;
+   maskByRight.reserve(right.size());
+   for (const T & key : right)
+   {
+      maskByRight.push_back(
+         maskByKey.insert(std::make_pair(key, maskByKey.size())).first->second
+      );
+   }
+
+   masks.assign(maskByKey.size() * words, 0);
+   for (size_t i = 0, count = left.size(); i < count; ++i)
+   {
+      const auto it = maskByKey.find(left[i]);
+      if (it != maskByKey.end())
       {
-         --j;
+         masks[it->second * words + i / 64] |= uint64_t(1) << (i % 64);
       }
    }
 }
 
 
+template<typename T, typename Equals>
+void Alignment::matchMasks(
+   const std::vector<T> & left,
+   const std::vector<T> & right,
+   const Equals & equals,
+   size_t words,
+   std::vector<uint64_t> & masks,
+   std::vector<size_t> & maskByRight
+)
+{
+   masks.assign(right.size() * words, 0);
+   maskByRight.reserve(right.size());
+   for (size_t j = 0, rightCount = right.size(); j < rightCount; ++j)
+   {
+      for (size_t i = 0, leftCount = left.size(); i < leftCount; ++i)
+      {
+         if (equals(left[i], right[j]))
+         {
+            masks[j * words + i / 64] |= uint64_t(1) << (i % 64);
+         }
+      }
+      maskByRight.push_back(j);
+   }
+}
+
 }
 
 
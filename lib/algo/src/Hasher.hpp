@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#ifndef ALGO_HASHER_HPP
+#define ALGO_HASHER_HPP
+
+
+#include <cstdint>
+
+
+namespace algo {
+
+
+// The SplitMix64 finalizer, spreads every bit of the value over all bits of
+// the result;
+inline uint64_t mix64(uint64_t z)
+{
+   z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+   z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+   return z ^ (z >> 31);
+}
+
+
+/***************************************************************************
+ *   Hasher class declaration                                              *
+ ***************************************************************************/
+
+
+// FNV-1a over words, finished by mix64(), as FNV-1a alone leaves the last
+// words in the low bits only. Good for keys of caches and for pinning
+// results, not meant to resist collisions made on purpose;
+class Hasher
+{
+   public:
+      // The seed tells apart hashes of different kinds of data;
+      inline explicit Hasher(uint64_t seed = 0)
+         : m_state(0xcbf29ce484222325ull ^ seed)
+      {}
+
+      inline void add(uint64_t word)
+      {
+         m_state = (m_state ^ word) * 0x100000001b3ull;
+      }
+
+      inline uint64_t value() const {return mix64(m_state);}
+
+   private:
+      uint64_t m_state;
+};
+
+
+}
+
+
+#endif
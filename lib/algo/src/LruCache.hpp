@@ -0,0 +1,177 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#ifndef ALGO_LRUCACHE_HPP
+#define ALGO_LRUCACHE_HPP
+
+
+#include <cstdlib>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+
+#include <boost/optional.hpp>
+
+
+namespace algo {
+
+
+/***************************************************************************
+ *   LruCache class declaration                                            *
+ ***************************************************************************/
+
+
+// Values by their keys, each one with its cost. The costs are held within a
+// budget, the least recently used values are dropped first; a value costing
+// more than the whole budget is not held at all. Not thread-safe;
+template <typename Key, typename Value, typename Hash = std::hash<Key> >
+class LruCache
+{
+   public:
+      explicit LruCache(size_t budget);
+
+      // Found values become the most recently used;
+      boost::optional<Value> find(const Key & key);
+      // A key held already keeps its value, which becomes the most recently
+      // used;
+      void insert(const Key & key, const Value & value, size_t cost);
+
+      void clear();
+
+      size_t budget() const;
+      void setBudget(size_t budget);
+
+      size_t size() const;
+      size_t cost() const;
+
+   private:
+      struct Item
+      {
+         Key key;
+         Value value;
+         size_t cost;
+      };
+
+      typedef std::list<Item> Items;
+
+      void trim();
+
+      size_t m_budget;
+      size_t m_cost;
+      Items m_items; // The most recently used first;
+      std::unordered_map<Key, typename Items::iterator, Hash> m_index;
+};
+
+
+template <typename Key, typename Value, typename Hash>
+LruCache<Key, Value, Hash>::LruCache(size_t budget)
+   : m_budget(budget), m_cost(0)
+{
+}
+
+
+template <typename Key, typename Value, typename Hash>
+boost::optional<Value> LruCache<Key, Value, Hash>::find(const Key & key)
+{
+   const auto it = m_index.find(key);
+   if (it == m_index.end())
+   {
+      return boost::none;
+   }
+   m_items.splice(m_items.begin(), m_items, it->second);
+   return it->second->value;
+}
+
+
+template <typename Key, typename Value, typename Hash>
+void LruCache<Key, Value, Hash>::insert(
+   const Key & key,
+   const Value & value,
+   size_t cost
+)
+{
+   const auto it = m_index.find(key);
+   if (it != m_index.end())
+   {
+      m_items.splice(m_items.begin(), m_items, it->second);
+      return;
+   }
+   m_items.push_front(Item{key, value, cost});
+   m_index.insert(std::make_pair(key, m_items.begin()));
+   m_cost += cost;
+   trim();
+}
+
+
+template <typename Key, typename Value, typename Hash>
+void LruCache<Key, Value, Hash>::clear()
+{
+   m_index.clear();
+   m_items.clear();
+   m_cost = 0;
+}
+
+
+template <typename Key, typename Value, typename Hash>
+size_t LruCache<Key, Value, Hash>::budget() const
+{
+   return m_budget;
+}
+
+
+template <typename Key, typename Value, typename Hash>
+void LruCache<Key, Value, Hash>::setBudget(size_t budget)
+{
+   m_budget = budget;
+   trim();
+}
+
+
+template <typename Key, typename Value, typename Hash>
+size_t LruCache<Key, Value, Hash>::size() const
+{
+   return m_items.size();
+}
+
+
+template <typename Key, typename Value, typename Hash>
+size_t LruCache<Key, Value, Hash>::cost() const
+{
+   return m_cost;
+}
+
+
+template <typename Key, typename Value, typename Hash>
+void LruCache<Key, Value, Hash>::trim()
+{
+   while (m_cost > m_budget)
+   {
+      m_cost -= m_items.back().cost;
+      m_index.erase(m_items.back().key);
+      m_items.pop_back();
+   }
+}
+
+
+}
+
+
+#endif
@@ -19,10 +19,12 @@
 
 
 #include <cassert>
-#include <cstdlib>
+#include <cmath>
+#include <limits>
 
 
 #include "Probability.hpp"
+#include "random_generators.hpp"
 
 
 namespace algo {
@@ -34,15 +36,37 @@ namespace algo {
 
 
 Probability::Probability(float p)
-   : m_p(p), m_limit(static_cast<int>(p * static_cast<float>(RAND_MAX))) // FIXME: float precision;
+   : m_p(p),
+   m_logFailure(std::log1p(-double(p)))
 {
    assert(p >= 0.0f && p <= 1.0f);
 }
 
 
-bool Probability::random() const
+bool Probability::random(CounterRandomGenerator & random) const
 {
-   return (rand() < m_limit); // FIXME: p == 0 && p == 1;
+   // Values are below one, so one always passes and zero never does;
+   return (random.generateNormalizedFloat() < m_p);
+}
+
+
+size_t Probability::skip(CounterRandomGenerator & random) const
+{
+   static const size_t never = std::numeric_limits<size_t>::max();
+   if (m_p >= 1.0f)
+   {
+      return 0;
+   }
+   if (m_p <= 0.0f)
+   {
+      return never;
+   }
+
+   // Inverse of the geometric distribution, 53 bits of the value make u
+   // uniform over (0, 1];
+   const double u = ((random.generate64() >> 11) + 1) / 9007199254740992.0;
+   const double skip = std::floor(std::log(u) / m_logFailure);
+   return (skip < double(never)) ? size_t(skip) : never;
 }
 
 
@@ -22,9 +22,15 @@
 #define ALGO_PROBABILITY_HPP
 
 
+#include <cstddef>
+
+
 namespace algo {
 
 
+class CounterRandomGenerator;
+
+
 /***************************************************************************
  *   Probability class declaration                                         *
  ***************************************************************************/
@@ -36,11 +42,15 @@ class Probability
       explicit Probability(float p);
 
       inline float get() const {return m_p;}
-      bool random() const;
+      bool random(CounterRandomGenerator & random) const;
+      // Number of failed trials before the next passed one, distributed as if
+      // random() were called until it passed. Zero probability never passes,
+      // so the maximum size_t is returned;
+      size_t skip(CounterRandomGenerator & random) const;
 
    private:
       float m_p;
-      int m_limit;
+      double m_logFailure; // Log of 1 - p, for skip();
 };
 
 
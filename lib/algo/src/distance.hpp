@@ -23,11 +23,15 @@
 
 
 #include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
 #include <functional>
 #include <vector>
 
 
 #include <boost/multi_array.hpp>
+#include <boost/optional.hpp>
 
 
 namespace algo {
@@ -97,6 +101,229 @@ float getLevenshteinDistanceSimilarity(
 }
 
 
+namespace detail {
+
+// One column of a 64 row block of the Myers/Hyyro bit-vector algorithm.
+// Pv and Mv hold the positive and negative vertical deltas of the column,
+// hin is the horizontal delta entering the top row. Returns the horizontal
+// delta leaving the row selected by the mask;
+inline int advanceLevenshteinBlock(
+   uint64_t & pv,
+   uint64_t & mv,
+   uint64_t eq,
+   int hin,
+   uint64_t outMask
+)
+{
+   const uint64_t hinIsNegative = (hin < 0) ? 1 : 0;
+   const uint64_t xv = eq | mv;
+   eq |= hinIsNegative;
+   const uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+   uint64_t ph = mv | ~(xh | pv);
+   uint64_t mh = pv & xh;
+
+   const int hout = (ph & outMask) ? 1 : ((mh & outMask) ? -1 : 0);
+
+   ph <<= 1;
+   mh <<= 1;
+   mh |= hinIsNegative;
+   ph |= (hin > 0) ? 1 : 0;
+   pv = mh | ~(xv | ph);
+   mv = ph & xv;
+   return hout;
+}
+
+} // namespace detail;
+
+
+// Same distance as getLevenshteinDistance for elements compared by keys,
+// equal keys meaning equal elements, as long as it does not exceed the
+// given maximum. The shorter sequence is split into blocks of 64 elements
+// and the longer one is scanned column by column, 64 cells per step. Only
+// the band of blocks that may still lie on an alignment within the maximum
+// is computed (Ukkonen cut-off), so the scan gives up early on sequences
+// that are too far apart. Memory is linear in the lengths;
+template<typename Key>
+boost::optional<size_t> getBoundedLevenshteinDistance(
+   const std::vector<Key> & left,
+   const std::vector<Key> & right,
+   size_t maxDistance
+)
+{
+   const std::vector<Key> & pattern =
+      (left.size() <= right.size()) ? left : right;
+   const std::vector<Key> & text = (left.size() <= right.size()) ? right : left;
+   const ptrdiff_t m = pattern.size();
+   const ptrdiff_t n = text.size();
+   const ptrdiff_t k = std::min<size_t>(maxDistance, n);
+   if (n - m > k)
+   {
+      return boost::none;
+   }
+   if (!m)
+   {
+      return static_cast<size_t>(n);
+   }
+
+   // Elements are replaced by the indices of the distinct pattern keys, text
+   // keys that are not in the pattern get the index past them;
+   std::vector<Key> keys(pattern);
+   std::sort(keys.begin(), keys.end());
+   keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+   const ptrdiff_t blockCount = (m + 63) / 64;
+   std::vector<uint64_t> peq((keys.size() + 1) * blockCount, 0);
+   for (ptrdiff_t i = 0; i < m; ++i)
+   {
+      const size_t id =
+         std::lower_bound(keys.begin(), keys.end(), pattern[i]) - keys.begin();
+      peq[id * blockCount + i / 64] |= uint64_t(1) << (i % 64);
+   }
+   std::vector<uint32_t> textIds(n);
+   for (ptrdiff_t j = 0; j < n; ++j)
+   {
+      const auto it = std::lower_bound(keys.begin(), keys.end(), text[j]);
+      textIds[j] = (it != keys.end() && !(text[j] < *it)) ?
+         (it - keys.begin()) : keys.size();
+   }
+
+   // Rows are numbered from 1, row 0 being the empty pattern prefix, block b
+   // ends at row bottom(b) where score[b] is its distance in the current
+   // column. Blocks [first, last] form the band, block -1 stands for row 0;
+   std::vector<uint64_t> pv(blockCount);
+   std::vector<uint64_t> mv(blockCount);
+   std::vector<ptrdiff_t> score(blockCount);
+   const auto bottom = [m](ptrdiff_t b)
+   {
+      return std::min<ptrdiff_t>(64 * (b + 1), m);
+   };
+   // A cell may lie on an alignment within the maximum only if its distance
+   // plus the difference of the remaining lengths does not exceed it;
+   const auto isReachable = [m, n, k](ptrdiff_t row, ptrdiff_t d, ptrdiff_t j)
+   {
+      return d + std::abs((m - row) - (n - j)) <= k;
+   };
+   // The same bound for the best cell of a block, distances decrease by
+   // at most one per row up from its bottom;
+   const auto isBlockReachable = [&](ptrdiff_t b, ptrdiff_t j)
+   {
+      const ptrdiff_t a = (m - bottom(b)) - (n - j);
+      const ptrdiff_t rows = bottom(b) - 64 * b;
+      return score[b] + ((a + rows - 1 >= 0) ? a : -a - 2 * (rows - 1)) <= k;
+   };
+
+   ptrdiff_t first = 0;
+   ptrdiff_t last = -1;
+   for (ptrdiff_t j = 0; j <= n; ++j)
+   {
+      // Cells above the band only matter through the distances they give,
+      // these are assumed to grow by one per column;
+      const uint64_t * eq = j ? &peq[textIds[j - 1] * blockCount] : 0;
+      int hout = 1;
+      for (ptrdiff_t b = first; b <= last; ++b)
+      {
+         hout = detail::advanceLevenshteinBlock(
+            pv[b], mv[b], eq[b], hout, uint64_t(1) << (bottom(b) - 64 * b - 1)
+         );
+         score[b] += hout;
+      }
+
+      // The block below joins the band when the bottom of the last one may
+      // lie on an alignment in this column or the previous one. Its cells in
+      // the previous column are assumed to grow by one per row, which may
+      // only overestimate them;
+      while (last + 1 < blockCount)
+      {
+         const ptrdiff_t row = (last < 0) ? 0 : bottom(last);
+         const ptrdiff_t d = (last < 0) ? j : score[last];
+         if (!isReachable(row, d, j) && !(j && isReachable(row, d - hout, j - 1)))
+         {
+            break;
+         }
+         ++last;
+         pv[last] = ~uint64_t(0);
+         mv[last] = 0;
+         score[last] = d + (bottom(last) - row);
+         if (j)
+         {
+            score[last] -= hout;
+            hout = detail::advanceLevenshteinBlock(
+               pv[last], mv[last], eq[last], hout,
+               uint64_t(1) << (bottom(last) - 64 * last - 1)
+            );
+            score[last] += hout;
+         }
+      }
+
+      // An alignment crosses every column, so once the cells of a column
+      // down to some row are out of reach they stay so in later columns;
+      while (last >= first && !isBlockReachable(last, j))
+      {
+         --last;
+      }
+      while (first <= last && !isBlockReachable(first, j) &&
+         (first || !isReachable(0, j, j)))
+      {
+         ++first;
+      }
+      if (first > last && (first || !isReachable(0, j, j)))
+      {
+         return boost::none;
+      }
+   }
+
+   if (last + 1 == blockCount && score[last] <= k)
+   {
+      return static_cast<size_t>(score[last]);
+   }
+   return boost::none;
+}
+
+
+template<typename Key>
+size_t getBitParallelLevenshteinDistance(
+   const std::vector<Key> & left,
+   const std::vector<Key> & right
+)
+{
+   return *getBoundedLevenshteinDistance(
+      left, right, std::max(left.size(), right.size())
+   );
+}
+
+
+template<typename Key>
+float getBitParallelLevenshteinDistanceSimilarity(
+   const std::vector<Key> & left,
+   const std::vector<Key> & right
+)
+{
+   const size_t ld = getBitParallelLevenshteinDistance(left, right);
+   return 1.0f - (static_cast<float>(ld) / static_cast<float>(
+      std::max(left.size(), right.size())));
+}
+
+
+// Exact similarity when it is at least the given minimum, otherwise an
+// upper bound of it that is still below the minimum;
+template<typename Key>
+float getBoundedLevenshteinDistanceSimilarity(
+   const std::vector<Key> & left,
+   const std::vector<Key> & right,
+   float minSimilarity
+)
+{
+   const size_t size = std::max(left.size(), right.size());
+   // One more edit absorbs the rounding of the bound;
+   const float bound = (1.0f - minSimilarity) * static_cast<float>(size);
+   const size_t maxDistance = (bound < static_cast<float>(size)) ?
+      (static_cast<size_t>(std::max(bound, 0.0f)) + 1) : size;
+   const boost::optional<size_t> ld =
+      getBoundedLevenshteinDistance(left, right, maxDistance);
+   return 1.0f - (static_cast<float>(ld ? *ld : (maxDistance + 1)) /
+      static_cast<float>(size));
+}
+
+
 } // namespace algo;
 
 
@@ -23,8 +23,11 @@
 
 
 #include <algorithm>
+#include <functional>
+#include <limits>
 #include <ostream>
 #include <set>
+#include <thread>
 #include <vector>
 
 
@@ -71,18 +74,27 @@ template <typename Metric>
 class MetricMatrix
 {
    public:
+      // Metrics are evaluated on the given number of threads, zero means as
+      // many as the hardware runs, but only for matrices large enough to
+      // benefit from them. The compare must then be safe to call
+      // concurrently;
       template <typename T, typename SymmetricCompare>
       explicit MetricMatrix(
          const std::vector<T> & data,
          SymmetricCompare compare,
-         METRIC_SENSE metricSense
+         METRIC_SENSE metricSense,
+         size_t threadCount = 1
       );
       MetricMatrix(const MetricMatrix & other);
+      MetricMatrix(MetricMatrix && other);
       virtual ~MetricMatrix();
 
       void remove(size_t rowAndColumn);
+      // Given a threshold, the metrics that do not pass it are all replaced
+      // by the same one beyond it first, so that nothing ranks by them;
       void reduce(const boost::optional<Metric> & threshold);
 
+      inline METRIC_SENSE metricSense() const {return m_metricSense;}
       inline size_t size() const {return m_size;}
       Metric at(size_t row, size_t column) const;
 
@@ -92,11 +104,52 @@ class MetricMatrix
 
       roommates::Matrix<size_t> roommatesMatrix() const;
       std::pair<size_t, size_t> globalExtremum() const;
+      // Pairs rows by repeatedly taking the global extremum and removing
+      // both of its rows, without modifying the matrix. Pairs are returned
+      // in that order as (row, column) with row greater than column;
+      std::vector<std::pair<size_t, size_t> > greedyPairs() const;
 
    private:
       template <typename T>
       static void moveToEnd(size_t index, T * array, size_t size);
 
+      // Index of the first metric of the row in the lower triangle;
+      static inline size_t rowOffset(size_t row) {return row * (row - 1) / 2;}
+
+      template <typename T, typename SymmetricCompare>
+      void evaluate(
+         const std::vector<T> & data,
+         SymmetricCompare & compare,
+         size_t begin,
+         size_t end
+      );
+
+      struct Candidate
+      {
+         Metric metric;
+         size_t row;
+         size_t column;
+      };
+
+      // Orders candidates the way globalExtremum() scans them, the most
+      // alike pair is the greatest one;
+      class CandidateComparator
+      {
+         public:
+            explicit CandidateComparator(METRIC_SENSE metricSense);
+            bool operator()(const Candidate & lhs, const Candidate & rhs) const;
+
+         private:
+            METRIC_SENSE m_metricSense;
+      };
+
+      // The best pair of the row with rows not taken yet;
+      boost::optional<Candidate> bestCandidate(
+         size_t row,
+         const std::vector<bool> & taken,
+         const CandidateComparator & comparator
+      ) const;
+
       class Comparator
       {
          public:
@@ -112,8 +165,8 @@ class MetricMatrix
       size_t m_originalSize;
       size_t m_size;
       Metric m_diagonal; // All diagonal items are considered to be the same;
-      Metric ** m_data; // Original size - 1;
-      size_t *m_proxy; // Original size;
+      std::vector<Metric> m_data; // Lower triangle, row by row;
+      std::vector<size_t> m_proxy; // Original size;
 };
 
 
@@ -122,31 +175,56 @@ template <typename T, typename SymmetricCompare>
 MetricMatrix<Metric>::MetricMatrix(
    const std::vector<T> & data,
    SymmetricCompare compare,
-   METRIC_SENSE metricSense
+   METRIC_SENSE metricSense,
+   size_t threadCount
 ) : m_metricSense(metricSense),
    m_originalSize(data.size()),
    m_size(data.size()),
-   m_data(0),
-   m_proxy(0)
+   m_diagonal()
 {
    if (m_size > 1)
    {
-      m_data = new Metric *[m_size - 1];
-      for (size_t row = 1; row < m_size; ++row)
+      const size_t count = rowOffset(m_size);
+      m_data.resize(count);
+      if (!threadCount)
+      {
+         static const size_t minMetricsPerThread = 256;
+         threadCount = std::min<size_t>(
+            std::thread::hardware_concurrency(),
+            count / minMetricsPerThread
+         );
+      }
+      threadCount = std::max<size_t>(std::min(threadCount, count), 1);
+
+      if (threadCount == 1)
       {
-         Metric * rowMetrics = new Metric[row];
-         for (size_t column = 0; column < row; ++column)
+         evaluate(data, compare, 0, count);
+      }
+      else
+      {
+         // Every thread fills its own range of the buffer with a copy of the
+         // compare;
+         std::vector<std::thread> threads;
+         for (size_t t = 0; t < threadCount; ++t)
          {
-            rowMetrics[column] = compare(data[row], data[column]);
+            const size_t begin = count * t / threadCount;
+            const size_t end = count * (t + 1) / threadCount;
+            threads.push_back(std::thread([=, &data]() {
+               SymmetricCompare threadCompare(compare);
+               evaluate(data, threadCompare, begin, end);
+            }));
+         }
+         for (size_t t = 0; t < threadCount; ++t)
+         {
+            threads[t].join();
          }
-         m_data[row - 1] = rowMetrics;
       }
    }
 
    if (m_size)
    {
       m_diagonal = compare(data[0], data[0]);
-      m_proxy = new size_t[m_size];
+      m_proxy.resize(m_size);
       for (size_t i = 0; i < m_size; ++i)
       {
          m_proxy[i] = i;
@@ -161,47 +239,29 @@ MetricMatrix<Metric>::MetricMatrix(const MetricMatrix<Metric> & other)
    m_originalSize(other.m_originalSize),
    m_size(other.m_size),
    m_diagonal(other.m_diagonal),
-   m_data(0),
-   m_proxy(0)
+   m_data(other.m_data),
+   m_proxy(other.m_proxy)
 {
-   if (m_originalSize > 1)
-   {
-      m_data = new Metric *[m_originalSize - 1];
-      for (size_t row = 1; row < m_originalSize; ++row)
-      {
-         Metric * otherRowMetrics = other.m_data[row - 1];
-         Metric * rowMetrics = new Metric[row];
-         for (size_t column = 0; column < row; ++column)
-         {
-            rowMetrics[column] = otherRowMetrics[column];
-         }
-         m_data[row - 1] = rowMetrics;
-      }
-   }
+}
 
-   if (m_originalSize)
-   {
-      m_proxy = new size_t[m_originalSize];
-      for (size_t i = 0; i < m_originalSize; ++i)
-      {
-         m_proxy[i] = other.m_proxy[i];
-      }
-   }
+
+template <typename Metric>
+MetricMatrix<Metric>::MetricMatrix(MetricMatrix<Metric> && other)
+   : m_metricSense(other.m_metricSense),
+   m_originalSize(other.m_originalSize),
+   m_size(other.m_size),
+   m_diagonal(std::move(other.m_diagonal)),
+   m_data(std::move(other.m_data)),
+   m_proxy(std::move(other.m_proxy))
+{
+   other.m_originalSize = 0;
+   other.m_size = 0;
 }
 
 
 template <typename Metric>
 MetricMatrix<Metric>::~MetricMatrix()
 {
-   if (m_originalSize > 1)
-   {
-      for (size_t i = 0, count = m_originalSize - 1; i < count; ++i)
-      {
-         delete[] m_data[i];
-      }
-   }
-   delete[] m_data;
-   delete[] m_proxy;
 }
 
 
@@ -210,7 +270,7 @@ void MetricMatrix<Metric>::remove(size_t rowAndColumn)
 {
    if (m_size && (rowAndColumn < m_size))
    {
-      moveToEnd(rowAndColumn, m_proxy, m_size);
+      moveToEnd(rowAndColumn, m_proxy.data(), m_size);
       --m_size;
    }
 }
@@ -220,10 +280,24 @@ template <typename Metric>
 void MetricMatrix<Metric>::reduce(const boost::optional<Metric> & threshold)
 {
    const bool max = (m_metricSense == MS_MORE_METRIC_MORE_ALIKE);
+   if (threshold)
+   {
+      const Metric failed = (max ?
+         std::numeric_limits<Metric>::lowest() :
+         std::numeric_limits<Metric>::max());
+      for (Metric & m : m_data)
+      {
+         if (!doesMetricPassThreshold(m, threshold, m_metricSense))
+         {
+            m = failed;
+         }
+      }
+   }
+
    if (m_size > 1)
    {
       // Find extremum for all rows (except diagonal elements);
-      Metric *extremum = new Metric[m_size];
+      std::vector<Metric> extremum(m_size);
       for (size_t row = 0; row < m_size; ++row)
       {
          bool init = false;
@@ -255,14 +329,14 @@ void MetricMatrix<Metric>::reduce(const boost::optional<Metric> & threshold)
             {
                if (m_size % 2)
                {
-                  moveToEnd(row, extremum, m_size);
+                  moveToEnd(row, extremum.data(), m_size);
                   remove(row);
                }
                else if (next)
                {
-                  moveToEnd(*next, extremum, m_size);
+                  moveToEnd(*next, extremum.data(), m_size);
                   remove(*next);
-                  moveToEnd(row, extremum, m_size);
+                  moveToEnd(row, extremum.data(), m_size);
                   remove(row);
                   next = boost::none;
                }
@@ -290,8 +364,6 @@ void MetricMatrix<Metric>::reduce(const boost::optional<Metric> & threshold)
          }
          remove(extRow);
       }
-
-      delete[] extremum;
    }
    else if (m_size == 1)
    {
@@ -310,11 +382,11 @@ Metric MetricMatrix<Metric>::at(size_t row, size_t column) const
       const size_t j = m_proxy[column];
       if (i > j)
       {
-         return m_data[i - 1][j];
+         return m_data[rowOffset(i) + j];
       }
       else if (i < j)
       {
-         return m_data[j - 1][i];
+         return m_data[rowOffset(j) + i];
       }
    }
    return m_diagonal;
@@ -339,7 +411,7 @@ size_t MetricMatrix<Metric>::tailSize() const
 template <typename Metric>
 const size_t * MetricMatrix<Metric>::tail() const
 {
-   return ((m_size < m_originalSize) ? (m_proxy + m_size) : 0);
+   return ((m_size < m_originalSize) ? (m_proxy.data() + m_size) : 0);
 }
 
 
@@ -387,6 +459,112 @@ std::pair<size_t, size_t> MetricMatrix<Metric>::globalExtremum() const
 }
 
 
+template <typename Metric>
+std::vector<std::pair<size_t, size_t> > MetricMatrix<Metric>::greedyPairs()
+   const
+{
+   // The heap holds the best candidate of every row. Candidates of rows
+   // whose partner has been taken since are found again when they surface,
+   // until then they are only better than the actual ones;
+   const CandidateComparator comparator(m_metricSense);
+   std::vector<bool> taken(m_size, false);
+   std::vector<Candidate> heap;
+   heap.reserve(m_size);
+   for (size_t row = 0; row < m_size; ++row)
+   {
+      const boost::optional<Candidate> candidate =
+         bestCandidate(row, taken, comparator);
+      if (candidate)
+      {
+         heap.push_back(*candidate);
+      }
+   }
+   std::make_heap(heap.begin(), heap.end(), comparator);
+
+   std::vector<std::pair<size_t, size_t> > result;
+   result.reserve(m_size / 2);
+   while (!heap.empty())
+   {
+      std::pop_heap(heap.begin(), heap.end(), comparator);
+      const Candidate candidate = heap.back();
+      heap.pop_back();
+      if (!taken[candidate.row] && !taken[candidate.column])
+      {
+         taken[candidate.row] = true;
+         taken[candidate.column] = true;
+         result.push_back(std::make_pair(candidate.row, candidate.column));
+      }
+      else if (!taken[candidate.row] || !taken[candidate.column])
+      {
+         const size_t row =
+            (taken[candidate.row] ? candidate.column : candidate.row);
+         const boost::optional<Candidate> next =
+            bestCandidate(row, taken, comparator);
+         if (next)
+         {
+            heap.push_back(*next);
+            std::push_heap(heap.begin(), heap.end(), comparator);
+         }
+      }
+   }
+   return result;
+}
+
+
+template <typename Metric>
+boost::optional<typename MetricMatrix<Metric>::Candidate>
+MetricMatrix<Metric>::bestCandidate(
+   size_t row,
+   const std::vector<bool> & taken,
+   const CandidateComparator & comparator
+) const
+{
+   boost::optional<Candidate> result;
+   for (size_t i = 0; i < m_size; ++i)
+   {
+      if (i != row && !taken[i])
+      {
+         const Candidate candidate = {
+            at(row, i), std::max(row, i), std::min(row, i)
+         };
+         if (!result || comparator(*result, candidate))
+         {
+            result = candidate;
+         }
+      }
+   }
+   return result;
+}
+
+
+template <typename Metric>
+template <typename T, typename SymmetricCompare>
+void MetricMatrix<Metric>::evaluate(
+   const std::vector<T> & data,
+   SymmetricCompare & compare,
+   size_t begin,
+   size_t end
+)
+{
+   // Find the row the range starts in;
+   size_t row = 1;
+   while (rowOffset(row + 1) <= begin)
+   {
+      ++row;
+   }
+   size_t column = begin - rowOffset(row);
+   for (size_t i = begin; i < end; ++i)
+   {
+      m_data[i] = compare(data[row], data[column]);
+      if (++column == row)
+      {
+         ++row;
+         column = 0;
+      }
+   }
+}
+
+
 template <typename Metric>
 template <typename T>
 void MetricMatrix<Metric>::moveToEnd(size_t index, T * array, size_t size)
@@ -404,6 +582,34 @@ void MetricMatrix<Metric>::moveToEnd(size_t index, T * array, size_t size)
 }
 
 
+template <typename Metric>
+MetricMatrix<Metric>::CandidateComparator::CandidateComparator(
+   METRIC_SENSE metricSense
+) : m_metricSense(metricSense)
+{
+}
+
+
+template <typename Metric>
+bool MetricMatrix<Metric>::CandidateComparator::operator()(
+   const Candidate & lhs,
+   const Candidate & rhs
+) const
+{
+   if (lhs.metric < rhs.metric)
+   {
+      return (m_metricSense == MS_MORE_METRIC_MORE_ALIKE);
+   }
+   if (rhs.metric < lhs.metric)
+   {
+      return (m_metricSense == MS_LESS_METRIC_MORE_ALIKE);
+   }
+   // The scan takes the first of equal extremums;
+   return ((lhs.row > rhs.row) ||
+      (lhs.row == rhs.row && lhs.column > rhs.column));
+}
+
+
 template <typename Metric>
 MetricMatrix<Metric>::Comparator::Comparator(
    const MetricMatrix<Metric> & matrix,
@@ -467,16 +673,15 @@ std::ostream & operator<<(std::ostream & os, const MetricMatrix<Metric> & mm)
 }
 
 
-template <typename Metric, typename T, typename SymmetricCompare>
+template <typename Metric>
 std::vector<Pair<Metric> > resolve(
-   const std::vector<T> & data,
-   SymmetricCompare compare,
-   METRIC_SENSE metricSense,
+   MetricMatrix<Metric> & matrix,
    const boost::optional<Metric> & threshold = boost::none)
 {
+   const METRIC_SENSE metricSense = matrix.metricSense();
+   const size_t dataSize = matrix.size() + matrix.tailSize();
    size_t usedItems = 0;
 
-   MetricMatrix<Metric> matrix(data, compare, metricSense);
    matrix.reduce(threshold);
    assert(!(matrix.size() % 2));
 
@@ -484,7 +689,7 @@ std::vector<Pair<Metric> > resolve(
    const size_t tailSize = matrix.tailSize();
 
    std::vector<Pair<Metric> > pairs;
-   pairs.reserve(data.size());
+   pairs.reserve(dataSize);
    roommates::Matrix<size_t> rmMatrix = std::move(matrix.roommatesMatrix());
    std::vector<size_t> rmPartners;
    if (roommates::resolve(rmMatrix, rmPartners))
@@ -519,25 +724,11 @@ std::vector<Pair<Metric> > resolve(
    else
    {
       // Greedy algorithm;
-      while (matrix.size())
+      const std::vector<std::pair<size_t, size_t> > greedy =
+         matrix.greedyPairs();
+      for (size_t i = 0, count = greedy.size(); i < count; ++i)
       {
-         // Find global extremum (except diagonal elements);
-         std::pair<size_t, size_t> ext = matrix.globalExtremum();
-         assert(ext.first != ext.second);
-         if (ext.first > ext.second)
-         {
-            matrix.remove(ext.first);
-            matrix.remove(ext.second);
-         }
-         else if (ext.first < ext.second)
-         {
-            matrix.remove(ext.second);
-            matrix.remove(ext.first);
-         }
-         else // Impossible case;
-         {
-            matrix.remove(ext.first);
-         }
+         const std::pair<size_t, size_t> & ext = greedy[i];
          size_t left = matrix.originalIndex(ext.first);
          size_t right = matrix.originalIndex(ext.second);
          if (left > right)
@@ -565,13 +756,51 @@ std::vector<Pair<Metric> > resolve(
       ++usedItems;
    }
 
-   assert(usedItems == data.size());
+   assert(usedItems == dataSize);
    pairs.shrink_to_fit();
    std::sort(pairs.begin(), pairs.end());
    return pairs;
 }
 
 
+template <typename Metric, typename T, typename SymmetricCompare>
+std::vector<Pair<Metric> > resolve(
+   const std::vector<T> & data,
+   SymmetricCompare compare,
+   METRIC_SENSE metricSense,
+   const boost::optional<Metric> & threshold = boost::none,
+   size_t threadCount = 1)
+{
+   MetricMatrix<Metric> matrix(data, compare, metricSense, threadCount);
+   return resolve(matrix, threshold);
+}
+
+
+// The compare is also given the threshold, for pairs that do not pass it
+// it may return any metric that does not pass it either instead of the
+// exact one. Such pairs are never paired, so the comparison can give up as
+// soon as it is clear that the threshold is out of reach. The matrix ranks
+// all metrics that do not pass as the same one, see MetricMatrix::reduce(),
+// so the pairs are those resolve makes of the exact metrics;
+template <typename Metric, typename T, typename BoundedSymmetricCompare>
+std::vector<Pair<Metric> > resolveBounded(
+   const std::vector<T> & data,
+   BoundedSymmetricCompare compare,
+   METRIC_SENSE metricSense,
+   const Metric & threshold,
+   size_t threadCount = 1)
+{
+   MetricMatrix<Metric> matrix(
+      data,
+      std::bind(compare, std::placeholders::_1, std::placeholders::_2,
+         threshold),
+      metricSense,
+      threadCount
+   );
+   return resolve(matrix, boost::optional<Metric>(threshold));
+}
+
+
 } // namespace pairing;
 
 
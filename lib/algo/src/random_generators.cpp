@@ -18,23 +18,77 @@
  ***************************************************************************/
 
 
-#include <cmath>
-#include <cstdlib>
-
-
+#include "Hasher.hpp"
 #include "random_generators.hpp"
 
 
 namespace algo {
 
 
+namespace {
+
+const uint64_t _golden = 0x9e3779b97f4a7c15ull;
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   CounterRandomGenerator class implementation                           *
+ ***************************************************************************/
+
+
+CounterRandomGenerator::CounterRandomGenerator(uint64_t seed)
+   : m_key(mix64(seed)), m_counter(0)
+{
+}
+
+
+CounterRandomGenerator CounterRandomGenerator::stream(uint64_t index) const
+{
+   CounterRandomGenerator result;
+   result.m_key = mix64(m_key ^ mix64(index + _golden));
+   return result;
+}
+
+
+uint64_t CounterRandomGenerator::generate64()
+{
+   return mix64(m_key + (++m_counter) * _golden);
+}
+
+
+uint32_t CounterRandomGenerator::generate()
+{
+   return static_cast<uint32_t>(generate64() >> 32);
+}
+
+
+uint32_t CounterRandomGenerator::generate(uint32_t upperLimit)
+{
+   // Multiply and shift, free of the bias of the remainder for small limits;
+   return static_cast<uint32_t>(
+      (static_cast<uint64_t>(generate()) * upperLimit) >> 32
+   );
+}
+
+
+float CounterRandomGenerator::generateNormalizedFloat()
+{
+   return static_cast<float>(generate() >> 8) * (1.0f / 16777216.0f);
+}
+
+
 /***************************************************************************
  *   UniformUInt16RandomGenerator class implementation                     *
  ***************************************************************************/
 
 
-UniformUInt16RandomGenerator::UniformUInt16RandomGenerator(uint16_t upperLimit)
-   : m_upperLimit(upperLimit), m_predefinedValueIndex(0)
+UniformUInt16RandomGenerator::UniformUInt16RandomGenerator(
+   uint16_t upperLimit,
+   CounterRandomGenerator & random
+) : m_upperLimit(upperLimit),
+   m_random(&random),
+   m_predefinedValueIndex(0)
 {
 }
 
@@ -42,6 +96,7 @@ UniformUInt16RandomGenerator::UniformUInt16RandomGenerator(uint16_t upperLimit)
 UniformUInt16RandomGenerator::UniformUInt16RandomGenerator(
    const std::vector<uint16_t> & predefinedValues
 ) : m_upperLimit(0),
+   m_random(0),
    m_predefinedValues(predefinedValues),
    m_predefinedValueIndex(0)
 {
@@ -54,7 +109,9 @@ uint16_t UniformUInt16RandomGenerator::generate() const
    {
       return m_predefinedValues[m_predefinedValueIndex++];
    }
-   return static_cast<uint16_t>(m_upperLimit ? (rand() % m_upperLimit) : 0);
+   return static_cast<uint16_t>(
+      m_random ? m_random->generate(m_upperLimit) : 0
+   );
 }
 
 
@@ -63,15 +120,18 @@ uint16_t UniformUInt16RandomGenerator::generate() const
  ***************************************************************************/
 
 
-UniformNormalizedFloatRandomGenerator::UniformNormalizedFloatRandomGenerator()
-   : m_predefinedValueIndex(0)
+UniformNormalizedFloatRandomGenerator::UniformNormalizedFloatRandomGenerator(
+   CounterRandomGenerator & random
+) : m_random(&random),
+   m_predefinedValueIndex(0)
 {
 }
 
 
 UniformNormalizedFloatRandomGenerator::UniformNormalizedFloatRandomGenerator(
    const std::vector<float> & predefinedValues
-) : m_predefinedValues(predefinedValues),
+) : m_random(0),
+   m_predefinedValues(predefinedValues),
    m_predefinedValueIndex(0)
 {
 }
@@ -83,7 +143,7 @@ float UniformNormalizedFloatRandomGenerator::generate() const
    {
       return m_predefinedValues[m_predefinedValueIndex++];
    }
-   return (static_cast<float>(rand()) / static_cast<float>(RAND_MAX));
+   return (m_random ? m_random->generateNormalizedFloat() : 0.0f);
 }
 
 
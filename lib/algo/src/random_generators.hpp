@@ -22,6 +22,7 @@
 #define ALGO_RANDOM_GENERATORS_HPP
 
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -29,6 +30,41 @@
 namespace algo {
 
 
+/***************************************************************************
+ *   CounterRandomGenerator class declaration                              *
+ ***************************************************************************/
+
+
+// SplitMix64 in counter form: the n-th value is a mix of the key and n. The
+// generator is a pair of integers, it is seeded and copied for free, and
+// streams derived from it by index do not depend on how much other streams
+// have been used. Not to be shared between threads, give every thread its
+// own stream instead;
+class CounterRandomGenerator
+{
+   public:
+      explicit CounterRandomGenerator(uint64_t seed = 0);
+
+      // Independent generator for the index, the same for the same key and
+      // index. This generator is not advanced;
+      CounterRandomGenerator stream(uint64_t index) const;
+
+      uint64_t generate64();
+      uint32_t generate();
+      // Uniform in [0, upperLimit), zero for the zero limit;
+      uint32_t generate(uint32_t upperLimit);
+      // Uniform in [0, 1);
+      float generateNormalizedFloat();
+
+      inline uint64_t key() const {return m_key;}
+      inline uint64_t counter() const {return m_counter;}
+
+   private:
+      uint64_t m_key;
+      uint64_t m_counter;
+};
+
+
 /***************************************************************************
  *   UniformUInt16RandomGenerator class declaration                        *
  ***************************************************************************/
@@ -37,7 +73,11 @@ namespace algo {
 class UniformUInt16RandomGenerator
 {
    public:
-      explicit UniformUInt16RandomGenerator(uint16_t upperLimit);
+      explicit UniformUInt16RandomGenerator(
+         uint16_t upperLimit,
+         CounterRandomGenerator & random
+      );
+      // Predefined values are followed by zeros;
       explicit UniformUInt16RandomGenerator(
          const std::vector<uint16_t> & predefinedValues
       );
@@ -46,6 +86,7 @@ class UniformUInt16RandomGenerator
 
    private:
       uint16_t m_upperLimit;
+      CounterRandomGenerator * m_random;
       std::vector<uint16_t> m_predefinedValues;
       mutable size_t m_predefinedValueIndex;
 };
@@ -59,7 +100,10 @@ class UniformUInt16RandomGenerator
 class UniformNormalizedFloatRandomGenerator
 {
    public:
-      explicit UniformNormalizedFloatRandomGenerator();
+      explicit UniformNormalizedFloatRandomGenerator(
+         CounterRandomGenerator & random
+      );
+      // Predefined values are followed by zeros;
       explicit UniformNormalizedFloatRandomGenerator(
          const std::vector<float> & predefinedValues
       );
@@ -67,6 +111,7 @@ class UniformNormalizedFloatRandomGenerator
       float generate() const;
 
    private:
+      CounterRandomGenerator * m_random;
       std::vector<float> m_predefinedValues;
       mutable size_t m_predefinedValueIndex;
 };
@@ -18,6 +18,11 @@
  ***************************************************************************/
 
 
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
 #include <boost/test/unit_test.hpp>
 
 
@@ -27,6 +32,83 @@
 using namespace algo;
 
 
+namespace {
+
+// Matches found by walking back over a whole LcsMatrix;
+template<typename Equals = std::equal_to<int> >
+std::vector<std::pair<size_t, size_t> > _matrixMatches(
+   const std::vector<int> & left,
+   const std::vector<int> & right,
+   const Equals & equals = Equals()
+)
+{
+   const LcsMatrix matrix(left, right, equals);
+   std::vector<std::pair<size_t, size_t> > matches;
+   size_t i = left.size();
+   size_t j = right.size();
+   while (i > 0 && j > 0)
+   {
+      if (equals(left[i - 1], right[j - 1]))
+      {
+         matches.insert(matches.begin(), std::make_pair(i - 1, j - 1));
+         --i;
+         --j;
+      }
+      else if (matrix.at(i - 1, j) > matrix.at(i, j - 1))
+      {
+         --i;
+      }
+      else
+      {
+         --j;
+      }
+   }
+   return matches;
+}
+
+
+// Not std::equal_to, so the alignment compares every pair of elements;
+bool _equalParity(int lhs, int rhs)
+{
+   return (lhs % 2) == (rhs % 2);
+}
+
+
+template<typename Equals>
+void _requireMatrixMatches(
+   const std::vector<int> & left,
+   const std::vector<int> & right,
+   const Equals & equals
+)
+{
+   const std::vector<std::pair<size_t, size_t> > expected =
+      _matrixMatches(left, right, equals);
+   const Alignment alignment(left, right, equals);
+   BOOST_REQUIRE(static_cast<size_t>(std::distance(
+      alignment.matchBegin(), alignment.matchEnd())) ==
+      expected.size());
+   Alignment::const_match_iterator it = alignment.matchBegin();
+   for (size_t k = 0; k < expected.size(); ++k, ++it)
+   {
+      BOOST_REQUIRE(it->left == expected[k].first);
+      BOOST_REQUIRE(it->right == expected[k].second);
+   }
+}
+
+
+std::vector<int> _randomSequence(size_t length, int alphabet)
+{
+   std::vector<int> sequence(length);
+   for (size_t i = 0; i < length; ++i)
+   {
+      sequence[i] = rand() % alphabet;
+   }
+   return sequence;
+}
+
+}
+
+
 /***************************************************************************
  *   Alignment class test                                                  *
  ***************************************************************************/
@@ -86,8 +168,8 @@ BOOST_AUTO_TEST_CASE(test_constructor)
       //                               0     1  2
       Alignment alignment(s1, s2);
 
-      Alignment::const_bimap_iterator bit = alignment.bimapBegin();
-      Alignment::const_bimap_iterator bite = alignment.bimapEnd();
+      Alignment::const_match_iterator bit = alignment.matchBegin();
+      Alignment::const_match_iterator bite = alignment.matchEnd();
       BOOST_REQUIRE(bit != bite && bit->left == 1 && bit->right == 0);
       ++bit;
       BOOST_REQUIRE(bit != bite && bit->left == 3 && bit->right == 1);
@@ -116,8 +198,8 @@ BOOST_AUTO_TEST_CASE(test_constructor)
       //                            0  1  2  3  4
       Alignment alignment(s1, s2);
 
-      Alignment::const_bimap_iterator bit = alignment.bimapBegin();
-      Alignment::const_bimap_iterator bite = alignment.bimapEnd();
+      Alignment::const_match_iterator bit = alignment.matchBegin();
+      Alignment::const_match_iterator bite = alignment.matchEnd();
       BOOST_REQUIRE(bit != bite && bit->left == 0 && bit->right == 1);
       ++bit;
       BOOST_REQUIRE(bit != bite && bit->left == 1 && bit->right == 3);
@@ -146,8 +228,8 @@ BOOST_AUTO_TEST_CASE(test_constructor)
       //                            0  1  2     3
       Alignment alignment(s1, s2);
 
-      Alignment::const_bimap_iterator bit = alignment.bimapBegin();
-      Alignment::const_bimap_iterator bite = alignment.bimapEnd();
+      Alignment::const_match_iterator bit = alignment.matchBegin();
+      Alignment::const_match_iterator bite = alignment.matchEnd();
       BOOST_REQUIRE(bit != bite && bit->left == 0 && bit->right == 0);
       ++bit;
       BOOST_REQUIRE(bit != bite && bit->left == 1 && bit->right == 1);
@@ -180,8 +262,8 @@ BOOST_AUTO_TEST_CASE(test_constructor)
       //                            0  1  2  3  4, 5
       Alignment alignment(s1, s2);
 
-      Alignment::const_bimap_iterator bit = alignment.bimapBegin();
-      Alignment::const_bimap_iterator bite = alignment.bimapEnd();
+      Alignment::const_match_iterator bit = alignment.matchBegin();
+      Alignment::const_match_iterator bite = alignment.matchEnd();
       BOOST_REQUIRE(bit != bite && bit->left == 0 && bit->right == 0);
       ++bit;
       BOOST_REQUIRE(bit != bite && bit->left == 1 && bit->right == 1);
@@ -214,8 +296,8 @@ BOOST_AUTO_TEST_CASE(test_constructor)
       //                            0  1  2  3  4
       Alignment alignment(s1, s2);
 
-      Alignment::const_bimap_iterator bit = alignment.bimapBegin();
-      Alignment::const_bimap_iterator bite = alignment.bimapEnd();
+      Alignment::const_match_iterator bit = alignment.matchBegin();
+      Alignment::const_match_iterator bite = alignment.matchEnd();
       BOOST_REQUIRE(bit != bite && bit->left == 2 && bit->right == 2);
       ++bit;
       BOOST_REQUIRE(bit != bite && bit->left == 4 && bit->right == 4);
@@ -721,4 +803,76 @@ BOOST_AUTO_TEST_CASE(test_index)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_matrixEquivalence)
+{
+   srand(1);
+   const size_t lengths[] = {0, 1, 5, 63, 64, 65, 130};
+   for (size_t leftLength : lengths)
+   {
+      for (size_t rightLength : lengths)
+      {
+         for (int alphabet : {2, 4, 30})
+         {
+            const std::vector<int> left = _randomSequence(leftLength, alphabet);
+            const std::vector<int> right =
+               _randomSequence(rightLength, alphabet);
+            _requireMatrixMatches(left, right, std::equal_to<int>());
+            _requireMatrixMatches(left, right, _equalParity);
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   Alignment benchmark                                                   *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libalgo_Alignment_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_Alignment)
+{
+   srand(1);
+   const size_t lengths[] = {64, 256, 1024};
+   for (size_t length : lengths)
+   {
+      const std::vector<int> left = _randomSequence(length, 16);
+      const std::vector<int> right = _randomSequence(length, 16);
+      const size_t repeats = std::max<size_t>(1, (1 << 22) / length / length);
+
+      size_t matrixCount = 0;
+      const auto matrixStart = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; ++i)
+      {
+         matrixCount += _matrixMatches(left, right).size();
+      }
+      const std::chrono::duration<double> matrix =
+         std::chrono::steady_clock::now() - matrixStart;
+
+      size_t alignmentCount = 0;
+      const auto alignmentStart = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; ++i)
+      {
+         const Alignment alignment(left, right);
+         alignmentCount += alignment.matchEnd() - alignment.matchBegin();
+      }
+      const std::chrono::duration<double> alignment =
+         std::chrono::steady_clock::now() - alignmentStart;
+
+      BOOST_REQUIRE(matrixCount == alignmentCount);
+      std::cout << length << " x " << length << ", " << repeats <<
+         " times: LcsMatrix " << matrix.count() << " s, Alignment " <<
+         alignment.count() << " s" << std::endl;
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
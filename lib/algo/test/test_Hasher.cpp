@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Hasher.hpp"
+
+
+using namespace algo;
+
+
+/***************************************************************************
+ *   Hasher class test                                                     *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libalgo_Hasher)
+
+
+BOOST_AUTO_TEST_CASE(test_value)
+{
+   // Keys of stored figures are made with it, so the values are pinned;
+   Hasher hasher(3);
+   hasher.add(1);
+   hasher.add(2);
+   hasher.add(3);
+   BOOST_REQUIRE(hasher.value() == 0x0ef1b633c90fa8d9ull);
+   BOOST_REQUIRE(Hasher().value() == 0xf52a15e9a9b5e89bull);
+
+   // The order of the words and the seed both count;
+   Hasher swapped(3);
+   swapped.add(2);
+   swapped.add(1);
+   swapped.add(3);
+   BOOST_REQUIRE(swapped.value() != hasher.value());
+   Hasher seeded(4);
+   seeded.add(1);
+   seeded.add(2);
+   seeded.add(3);
+   BOOST_REQUIRE(seeded.value() != hasher.value());
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <string>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "LruCache.hpp"
+
+
+using namespace algo;
+
+
+/***************************************************************************
+ *   LruCache class test                                                   *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libalgo_LruCache)
+
+
+BOOST_AUTO_TEST_CASE(test_find)
+{
+   LruCache<int, std::string> cache(10);
+   BOOST_REQUIRE(!cache.find(1));
+   cache.insert(1, "one", 3);
+   cache.insert(2, "two", 4);
+   BOOST_REQUIRE(cache.size() == 2 && cache.cost() == 7);
+   BOOST_REQUIRE(cache.find(1) && *cache.find(1) == "one");
+   BOOST_REQUIRE(cache.find(2) && *cache.find(2) == "two");
+   BOOST_REQUIRE(!cache.find(3));
+
+   // The first value stays, and so does its cost;
+   cache.insert(1, "uno", 5);
+   BOOST_REQUIRE(cache.size() == 2 && cache.cost() == 7);
+   BOOST_REQUIRE(*cache.find(1) == "one");
+
+   cache.clear();
+   BOOST_REQUIRE(!cache.size() && !cache.cost());
+   BOOST_REQUIRE(!cache.find(1));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_budget)
+{
+   LruCache<int, int> cache(10);
+   cache.insert(1, 10, 3);
+   cache.insert(2, 20, 3);
+   cache.insert(3, 30, 3);
+   BOOST_REQUIRE(cache.cost() == 9);
+
+   // Both finding and inserting again make a value the most recently used,
+   // the least recently used ones go first until the costs fit, which may
+   // add up to the budget exactly;
+   BOOST_REQUIRE(cache.find(1));
+   cache.insert(2, 0, 1);
+   cache.insert(4, 40, 4);
+   BOOST_REQUIRE(cache.size() == 3 && cache.cost() == 10);
+   BOOST_REQUIRE(!cache.find(3));
+   BOOST_REQUIRE(*cache.find(1) == 10 && *cache.find(2) == 20);
+   BOOST_REQUIRE(*cache.find(4) == 40);
+
+   cache.insert(5, 50, 3);
+   BOOST_REQUIRE(cache.size() == 3 && cache.cost() == 10);
+   BOOST_REQUIRE(!cache.find(1));
+
+   // A value costing more than the budget is dropped at once;
+   cache.insert(6, 60, 11);
+   BOOST_REQUIRE(!cache.find(6));
+   BOOST_REQUIRE(!cache.size() && !cache.cost());
+
+   // A smaller budget trims the held values right away;
+   cache.insert(1, 10, 2);
+   cache.insert(2, 20, 2);
+   cache.insert(3, 30, 2);
+   cache.setBudget(4);
+   BOOST_REQUIRE(cache.budget() == 4);
+   BOOST_REQUIRE(cache.size() == 2 && cache.cost() == 4);
+   BOOST_REQUIRE(!cache.find(1) && cache.find(2) && cache.find(3));
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,11 @@
  ***************************************************************************/
 
 
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
 #include <boost/test/unit_test.hpp>
 
 
@@ -27,8 +32,49 @@
 using namespace algo;
 
 
+namespace {
+
+std::vector<int> _randomSequence(size_t length, int alphabet)
+{
+   std::vector<int> sequence(length);
+   for (size_t i = 0; i < length; ++i)
+   {
+      sequence[i] = rand() % alphabet;
+   }
+   return sequence;
+}
+
+
+// About one edit in ten elements;
+std::vector<int> _mutated(const std::vector<int> & sequence, int alphabet)
+{
+   std::vector<int> result;
+   result.reserve(sequence.size() + sequence.size() / 10);
+   for (int element : sequence)
+   {
+      switch (rand() % 30)
+      {
+         case 0:
+            break;
+         case 1:
+            result.push_back(rand() % alphabet);
+            result.push_back(element);
+            break;
+         case 2:
+            result.push_back(rand() % alphabet);
+            break;
+         default:
+            result.push_back(element);
+      }
+   }
+   return result;
+}
+
+}
+
+
 /***************************************************************************
- *   PairingHelper test                                                    *
+ *   Levenshtein distance test                                             *
  ***************************************************************************/
 
 
@@ -44,4 +90,194 @@ BOOST_AUTO_TEST_CASE(test_getLevenshteinDistance)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_getBitParallelLevenshteinDistance)
+{
+   std::vector<int> left =  {0, 0, 0, 0, 0, 0};
+   std::vector<int> right = {1, 0, 0, 0, 1, 0, 2};
+
+   BOOST_REQUIRE(getBitParallelLevenshteinDistance(left, right) == 3);
+   BOOST_REQUIRE(getBitParallelLevenshteinDistance(right, left) == 3);
+   BOOST_REQUIRE(getBitParallelLevenshteinDistance(left, {}) == 6);
+   BOOST_REQUIRE(getBitParallelLevenshteinDistance({}, right) == 7);
+
+   // Lengths around the block boundaries, small alphabets give long runs of
+   // matches and large ones mostly mismatches;
+   srand(1);
+   const size_t lengths[] = {1, 2, 63, 64, 65, 127, 128, 129, 200};
+   const int alphabets[] = {2, 4, 50, 1000};
+   for (size_t leftLength : lengths)
+   {
+      for (size_t rightLength : lengths)
+      {
+         for (int alphabet : alphabets)
+         {
+            left = _randomSequence(leftLength, alphabet);
+            right = _randomSequence(rightLength, alphabet);
+            BOOST_REQUIRE(getBitParallelLevenshteinDistance(left, right) ==
+               getLevenshteinDistance(left, right));
+         }
+      }
+   }
+
+   // Related sequences, as homologous chromosomes are;
+   for (int i = 0; i < 50; ++i)
+   {
+      left = _randomSequence(300, 20);
+      right = _mutated(left, 20);
+      BOOST_REQUIRE(getBitParallelLevenshteinDistance(left, right) ==
+         getLevenshteinDistance(left, right));
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_getBoundedLevenshteinDistance)
+{
+   std::vector<int> left =  {0, 0, 0, 0, 0, 0};
+   std::vector<int> right = {1, 0, 0, 0, 1, 0, 2};
+
+   BOOST_REQUIRE(getBoundedLevenshteinDistance(left, right, 3) == size_t(3));
+   BOOST_REQUIRE(!getBoundedLevenshteinDistance(left, right, 2));
+   BOOST_REQUIRE(!getBoundedLevenshteinDistance(left, {}, 5));
+   BOOST_REQUIRE(getBoundedLevenshteinDistance({}, right, 7) == size_t(7));
+
+   srand(2);
+   const size_t lengths[] = {1, 63, 64, 65, 129, 200};
+   for (size_t leftLength : lengths)
+   {
+      for (size_t rightLength : lengths)
+      {
+         for (int alphabet : {2, 50})
+         {
+            left = _randomSequence(leftLength, alphabet);
+            right = (leftLength == rightLength) ?
+               _mutated(left, alphabet) : _randomSequence(rightLength, alphabet);
+            const size_t distance = getLevenshteinDistance(left, right);
+            for (size_t max = 0; max <= distance + 2; ++max)
+            {
+               const boost::optional<size_t> bounded =
+                  getBoundedLevenshteinDistance(left, right, max);
+               BOOST_REQUIRE((distance <= max) ?
+                  (bounded == distance) : !bounded);
+            }
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_getBoundedLevenshteinDistanceSimilarity)
+{
+   srand(3);
+   for (int i = 0; i < 200; ++i)
+   {
+      const std::vector<int> left = _randomSequence(1 + rand() % 150, 8);
+      const std::vector<int> right = (i % 2) ?
+         _mutated(left, 8) : _randomSequence(1 + rand() % 150, 8);
+      const float similarity = getLevenshteinDistanceSimilarity(left, right);
+      for (float min : {0.0f, 0.25f, 0.51f, 0.75f, 0.9f, 1.0f})
+      {
+         const float bounded =
+            getBoundedLevenshteinDistanceSimilarity(left, right, min);
+         if (similarity >= min)
+         {
+            BOOST_REQUIRE(bounded == similarity);
+         }
+         else
+         {
+            BOOST_REQUIRE(bounded < min);
+            BOOST_REQUIRE(bounded >= similarity);
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   Levenshtein distance benchmark                                        *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libalgo_distance_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_getLevenshteinDistance)
+{
+   srand(1);
+   const size_t lengths[] = {64, 256, 1024, 4096};
+   for (size_t length : lengths)
+   {
+      const std::vector<int> left = _randomSequence(length, 256);
+      const std::vector<int> right = _mutated(left, 256);
+      const size_t repeats = std::max<size_t>(1, (1 << 24) / length / length);
+
+      size_t matrixDistance = 0;
+      const auto matrixStart = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; ++i)
+      {
+         matrixDistance += getLevenshteinDistance(left, right);
+      }
+      const std::chrono::duration<double> matrix =
+         std::chrono::steady_clock::now() - matrixStart;
+
+      size_t bitDistance = 0;
+      const auto bitStart = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; ++i)
+      {
+         bitDistance += getBitParallelLevenshteinDistance(left, right);
+      }
+      const std::chrono::duration<double> bit =
+         std::chrono::steady_clock::now() - bitStart;
+
+      BOOST_REQUIRE(matrixDistance == bitDistance);
+      std::cout << length << " x " << right.size() << ", " << repeats <<
+         " times: matrix " << matrix.count() << " s, bit-parallel " <<
+         bit.count() << " s" << std::endl;
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(benchmark_getBoundedLevenshteinDistanceSimilarity)
+{
+   // Unrelated sequences, the common case when looking for homologs;
+   srand(1);
+   const size_t lengths[] = {64, 256, 1024, 4096};
+   for (size_t length : lengths)
+   {
+      const std::vector<int> left = _randomSequence(length, 256);
+      const std::vector<int> right = _randomSequence(length, 256);
+      const size_t repeats = std::max<size_t>(1, (1 << 24) / length / length);
+
+      float exactSum = 0.0f;
+      const auto exactStart = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; ++i)
+      {
+         exactSum += getBitParallelLevenshteinDistanceSimilarity(left, right);
+      }
+      const std::chrono::duration<double> exact =
+         std::chrono::steady_clock::now() - exactStart;
+
+      float boundedSum = 0.0f;
+      const auto boundedStart = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < repeats; ++i)
+      {
+         boundedSum +=
+            getBoundedLevenshteinDistanceSimilarity(left, right, 0.51f);
+      }
+      const std::chrono::duration<double> bounded =
+         std::chrono::steady_clock::now() - boundedStart;
+
+      BOOST_REQUIRE(exactSum <= boundedSum);
+      std::cout << length << " x " << right.size() << ", " << repeats <<
+         " times: exact " << exact.count() << " s, bounded at 0.51 " <<
+         bounded.count() << " s" << std::endl;
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
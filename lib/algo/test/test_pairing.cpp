@@ -20,7 +20,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
 
 
 #include <boost/test/unit_test.hpp>
@@ -67,6 +71,113 @@ float _stringSymmetricCompare(const char * lhs, const char * rhs)
 }
 
 
+float _sequenceSymmetricCompare(
+   const std::vector<char> & lhs,
+   const std::vector<char> & rhs
+)
+{
+   return getLevenshteinDistanceSimilarity(lhs, rhs);
+}
+
+
+float _boundedSequenceSymmetricCompare(
+   const std::vector<char> & lhs,
+   const std::vector<char> & rhs,
+   float threshold
+)
+{
+   return getBoundedLevenshteinDistanceSimilarity(lhs, rhs, threshold);
+}
+
+
+float _boundedStringSymmetricCompare(
+   const char * lhs,
+   const char * rhs,
+   float threshold
+)
+{
+   const std::vector<char> left(lhs, lhs + strlen(lhs));
+   const std::vector<char> right(rhs, rhs + strlen(rhs));
+   return getBoundedLevenshteinDistanceSimilarity(left, right, threshold);
+}
+
+
+// Pairs original indices the way the greedy branch of resolve used to,
+// scanning the whole matrix for every pair;
+template <typename Metric>
+std::vector<std::pair<size_t, size_t> > _greedyReference(
+   pairing::MetricMatrix<Metric> m
+)
+{
+   std::vector<std::pair<size_t, size_t> > result;
+   while (m.size() > 1)
+   {
+      const std::pair<size_t, size_t> ext = m.globalExtremum();
+      result.push_back(std::make_pair(
+         m.originalIndex(ext.first),
+         m.originalIndex(ext.second)
+      ));
+      m.remove(ext.first);
+      m.remove(ext.second);
+   }
+   return result;
+}
+
+
+template <typename Metric>
+std::vector<std::pair<size_t, size_t> > _greedyOriginal(
+   const pairing::MetricMatrix<Metric> & m
+)
+{
+   std::vector<std::pair<size_t, size_t> > result = m.greedyPairs();
+   for (size_t i = 0; i < result.size(); ++i)
+   {
+      result[i].first = m.originalIndex(result[i].first);
+      result[i].second = m.originalIndex(result[i].second);
+   }
+   return result;
+}
+
+
+// Strings mutated from a few ancestors, so that most of them have close
+// relatives;
+std::vector<std::string> _randomStrings(size_t count, size_t length)
+{
+   std::vector<std::string> ancestors(8);
+   for (size_t i = 0; i < ancestors.size(); ++i)
+   {
+      for (size_t j = 0; j < length; ++j)
+      {
+         ancestors[i].push_back('a' + rand() % 4);
+      }
+   }
+
+   std::vector<std::string> result;
+   for (size_t i = 0; i < count; ++i)
+   {
+      std::string s = ancestors[rand() % ancestors.size()];
+      const size_t mutations = rand() % (length / 4);
+      for (size_t j = 0; j < mutations; ++j)
+      {
+         s[rand() % s.size()] = 'a' + rand() % 4;
+      }
+      result.push_back(s);
+   }
+   return result;
+}
+
+
+float _stdStringSymmetricCompare(
+   const std::string & lhs,
+   const std::string & rhs
+)
+{
+   const std::vector<char> left(lhs.begin(), lhs.end());
+   const std::vector<char> right(rhs.begin(), rhs.end());
+   return getBitParallelLevenshteinDistanceSimilarity(left, right);
+}
+
+
 }
 
 
@@ -137,6 +248,50 @@ BOOST_AUTO_TEST_CASE(test_MetricMatrix_constructor)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_MetricMatrix_threads)
+{
+   std::vector<unsigned int> items;
+   for (unsigned int i = 0; i < 101; ++i)
+   {
+      items.push_back((i * 7919) % 1009);
+   }
+
+   pairing::MetricMatrix<unsigned int> reference(
+      items, _uintSymmetricCompare, pairing::MS_LESS_METRIC_MORE_ALIKE
+   );
+   for (size_t threadCount : {0, 2, 3, 4, 16, 10000})
+   {
+      pairing::MetricMatrix<unsigned int> m(
+         items,
+         _uintSymmetricCompare,
+         pairing::MS_LESS_METRIC_MORE_ALIKE,
+         threadCount
+      );
+      BOOST_REQUIRE(m.size() == items.size());
+      for (size_t row = 0; row < items.size(); ++row)
+      {
+         for (size_t column = 0; column < items.size(); ++column)
+         {
+            BOOST_REQUIRE(m.at(row, column) == reference.at(row, column));
+         }
+      }
+   }
+
+   // Copies are independent, moves leave the source empty;
+   pairing::MetricMatrix<unsigned int> copy(reference);
+   copy.remove(0);
+   BOOST_REQUIRE(copy.size() == items.size() - 1);
+   BOOST_REQUIRE(reference.size() == items.size());
+   BOOST_REQUIRE(copy.at(0, 1) == reference.at(1, 2));
+
+   pairing::MetricMatrix<unsigned int> moved(std::move(reference));
+   BOOST_REQUIRE(moved.size() == items.size());
+   BOOST_REQUIRE(moved.at(3, 5) == _uintSymmetricCompare(items[3], items[5]));
+   BOOST_REQUIRE(reference.size() == 0);
+   BOOST_REQUIRE(!reference.tailSize());
+}
+
+
 BOOST_AUTO_TEST_CASE(test_MetricMatrix_remove)
 {
    std::vector<unsigned int> items = {1, 10, 2, 12};
@@ -885,6 +1040,60 @@ BOOST_AUTO_TEST_CASE(test_MetricMatrix_globalExtremum)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_MetricMatrix_greedyPairs)
+{
+   {
+      std::vector<unsigned int> items;
+      pairing::MetricMatrix<unsigned int> m(
+         items, _uintSymmetricCompare, pairing::MS_LESS_METRIC_MORE_ALIKE
+      );
+      BOOST_REQUIRE(m.greedyPairs().empty());
+   }
+
+   {
+      std::vector<unsigned int> items = {3, 7, 9, 1};
+      pairing::MetricMatrix<unsigned int> m(
+         items, _uintSymmetricCompare, pairing::MS_LESS_METRIC_MORE_ALIKE
+      );
+      const std::vector<std::pair<size_t, size_t> > p = m.greedyPairs();
+      BOOST_REQUIRE(p.size() == 2);
+      BOOST_REQUIRE(p[0].first == 2 && p[0].second == 1);
+      BOOST_REQUIRE(p[1].first == 3 && p[1].second == 0);
+      BOOST_REQUIRE(m.size() == items.size());
+   }
+
+   // Small value ranges give many equal metrics, ties must be broken the
+   // way the scan breaks them;
+   srand(1);
+   for (size_t iteration = 0; iteration < 200; ++iteration)
+   {
+      std::vector<unsigned int> items(2 + rand() % 40);
+      for (size_t i = 0; i < items.size(); ++i)
+      {
+         items[i] = rand() % 16;
+      }
+
+      pairing::MetricMatrix<unsigned int> less(
+         items, _uintSymmetricCompare, pairing::MS_LESS_METRIC_MORE_ALIKE
+      );
+      if (iteration % 2)
+      {
+         less.reduce(boost::none);
+      }
+      BOOST_REQUIRE(_greedyOriginal(less) == _greedyReference(less));
+
+      pairing::MetricMatrix<float> more(
+         items, _floatSymmetricCompare, pairing::MS_MORE_METRIC_MORE_ALIKE
+      );
+      if (iteration % 2)
+      {
+         more.reduce(boost::none);
+      }
+      BOOST_REQUIRE(_greedyOriginal(more) == _greedyReference(more));
+   }
+}
+
+
 BOOST_AUTO_TEST_CASE(test_resolve)
 {
    #define _EQUALS(a, b) (fabs(a - b) <= 0.001f)
@@ -922,10 +1131,161 @@ BOOST_AUTO_TEST_CASE(test_resolve)
       BOOST_REQUIRE(p[4].left == 6 && !p[4].right && !p[4].metric);
    }
 
+   {
+      std::vector<pairing::Pair<float> > p = pairing::resolveBounded<float>(
+         items,
+         _boundedStringSymmetricCompare,
+         pairing::MS_MORE_METRIC_MORE_ALIKE,
+         0.5f
+      );
+      BOOST_REQUIRE(p.size() == 5);
+      BOOST_REQUIRE(p[0].left == 0 && p[0].right && *p[0].right == 4);
+      BOOST_REQUIRE(p[0].metric && _EQUALS(*p[0].metric, 0.571429f));
+      BOOST_REQUIRE(p[1].left == 1 && p[1].right && *p[1].right == 3);
+      BOOST_REQUIRE(p[1].metric && _EQUALS(*p[1].metric, 0.76923));
+      BOOST_REQUIRE(p[2].left == 2 && !p[2].right && !p[2].metric);
+      BOOST_REQUIRE(p[3].left == 5 && !p[3].right && !p[3].metric);
+      BOOST_REQUIRE(p[4].left == 6 && !p[4].right && !p[4].metric);
+   }
+
    // TODO: Try to write a case for the greedy branch of the algorithm;
 
    #undef _EQUALS
 }
 
 
+BOOST_AUTO_TEST_CASE(test_resolveBounded)
+{
+   // Families of related sequences among unrelated ones, so that some pairs
+   // pass the threshold and many do not. Sizes are both odd and even;
+   const float threshold = 0.51f;
+   srand(1);
+   for (size_t iteration = 0; iteration < 2000; ++iteration)
+   {
+      std::vector<std::vector<char> > items;
+      const size_t itemCount = 1 + rand() % 24;
+      while (items.size() < itemCount)
+      {
+         std::vector<char> base(8 + rand() % 40);
+         for (char & c : base)
+         {
+            c = 'a' + rand() % 4;
+         }
+         for (size_t copies = rand() % 3; copies; --copies)
+         {
+            std::vector<char> copy = base;
+            for (size_t edits = rand() % 8; edits; --edits)
+            {
+               copy[rand() % copy.size()] = 'a' + rand() % 4;
+            }
+            items.push_back(copy);
+         }
+         items.push_back(base);
+      }
+      items.resize(itemCount);
+
+      const std::vector<pairing::Pair<float> > exact = pairing::resolve<float>(
+         items,
+         _sequenceSymmetricCompare,
+         pairing::MS_MORE_METRIC_MORE_ALIKE,
+         threshold
+      );
+      const std::vector<pairing::Pair<float> > bounded =
+         pairing::resolveBounded<float>(
+            items,
+            _boundedSequenceSymmetricCompare,
+            pairing::MS_MORE_METRIC_MORE_ALIKE,
+            threshold
+         );
+
+      // Every item is returned once;
+      std::vector<size_t> counts(items.size(), 0);
+      for (const pairing::Pair<float> & pair : bounded)
+      {
+         ++counts[pair.left];
+         if (pair.right)
+         {
+            ++counts[*pair.right];
+         }
+      }
+      BOOST_REQUIRE(
+         std::count(counts.begin(), counts.end(), 1) ==
+            static_cast<std::ptrdiff_t>(items.size())
+      );
+
+      // Pairs pass the threshold with their exact metrics;
+      for (const pairing::Pair<float> & pair : bounded)
+      {
+         if (!pair.right)
+         {
+            BOOST_REQUIRE(!pair.metric);
+            continue;
+         }
+         BOOST_REQUIRE(pair.metric && *pair.metric >= threshold);
+         BOOST_REQUIRE(*pair.metric == _sequenceSymmetricCompare(
+            items[pair.left],
+            items[*pair.right]
+         ));
+      }
+
+      // And they are the very pairs of resolve;
+      BOOST_REQUIRE(bounded.size() == exact.size());
+      for (size_t i = 0; i < bounded.size(); ++i)
+      {
+         BOOST_REQUIRE(bounded[i].left == exact[i].left);
+         BOOST_REQUIRE(bounded[i].right == exact[i].right);
+         BOOST_REQUIRE(bounded[i].metric == exact[i].metric);
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   Pairing benchmark                                                     *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libalgo_pairing_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_greedyPairs)
+{
+   // Chromosome sized strings, as many as large genomes have;
+   srand(1);
+   const size_t counts[] = {100, 200, 400, 800, 1600};
+   for (size_t count : counts)
+   {
+      const std::vector<std::string> items = _randomStrings(count, 64);
+      pairing::MetricMatrix<float> m(
+         items,
+         _stdStringSymmetricCompare,
+         pairing::MS_MORE_METRIC_MORE_ALIKE,
+         0
+      );
+
+      const auto scanStart = std::chrono::steady_clock::now();
+      const std::vector<std::pair<size_t, size_t> > scanPairs =
+         _greedyReference(m);
+      const std::chrono::duration<double> scan =
+         std::chrono::steady_clock::now() - scanStart;
+
+      const auto heapStart = std::chrono::steady_clock::now();
+      const std::vector<std::pair<size_t, size_t> > heapPairs =
+         _greedyOriginal(m);
+      const std::chrono::duration<double> heap =
+         std::chrono::steady_clock::now() - heapStart;
+
+      BOOST_REQUIRE(scanPairs == heapPairs);
+      std::cout << count << " items: scan " << scan.count() <<
+         " s, heap " << heap.count() << " s" << std::endl;
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,174 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <cmath>
+#include <limits>
+#include <set>
+#include <vector>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Probability.hpp"
+#include "random_generators.hpp"
+
+
+using namespace algo;
+
+
+/***************************************************************************
+ *   CounterRandomGenerator class test                                     *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libalgo_random_generators)
+
+
+BOOST_AUTO_TEST_CASE(test_CounterRandomGenerator_determinism)
+{
+   CounterRandomGenerator a(42);
+   CounterRandomGenerator b(42);
+   CounterRandomGenerator c(43);
+   size_t differences = 0;
+   for (size_t i = 0; i < 1000; ++i)
+   {
+      const uint64_t value = a.generate64();
+      BOOST_REQUIRE(value == b.generate64());
+      differences += (value != c.generate64());
+   }
+   BOOST_REQUIRE(differences == 1000);
+   BOOST_REQUIRE(a.counter() == 1000);
+
+   // Copies go on from the same point;
+   CounterRandomGenerator copy(a);
+   BOOST_REQUIRE(copy.generate() == a.generate());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_CounterRandomGenerator_stream)
+{
+   CounterRandomGenerator random(7);
+   const CounterRandomGenerator first = random.stream(0);
+   random.generate64();
+   BOOST_REQUIRE(random.stream(0).key() == first.key());
+   BOOST_REQUIRE(random.stream(0).counter() == 0);
+
+   // Streams differ from each other and from the parent;
+   std::set<uint64_t> values;
+   for (uint64_t index = 0; index < 100; ++index)
+   {
+      CounterRandomGenerator stream = random.stream(index);
+      for (size_t i = 0; i < 10; ++i)
+      {
+         values.insert(stream.generate64());
+      }
+   }
+   CounterRandomGenerator parent(7);
+   for (size_t i = 0; i < 10; ++i)
+   {
+      values.insert(parent.generate64());
+   }
+   BOOST_REQUIRE(values.size() == 1010);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_CounterRandomGenerator_ranges)
+{
+   CounterRandomGenerator random(1);
+   BOOST_REQUIRE(random.generate(0) == 0);
+   BOOST_REQUIRE(random.generate(1) == 0);
+
+   // Every value of a small range comes up about as often as the others;
+   const size_t range = 10;
+   const size_t count = 100000;
+   std::vector<size_t> histogram(range, 0);
+   double sum = 0.0;
+   for (size_t i = 0; i < count; ++i)
+   {
+      const uint32_t value = random.generate(range);
+      BOOST_REQUIRE(value < range);
+      ++histogram[value];
+
+      const float f = random.generateNormalizedFloat();
+      BOOST_REQUIRE(f >= 0.0f && f < 1.0f);
+      sum += f;
+   }
+   for (size_t h : histogram)
+   {
+      BOOST_REQUIRE(std::abs(static_cast<double>(h) - count / range) <
+         0.05 * count / range);
+   }
+   BOOST_REQUIRE(std::abs(sum / count - 0.5) < 0.01);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_Probability)
+{
+   CounterRandomGenerator random(3);
+   const Probability never(0.0f);
+   const Probability always(1.0f);
+   const Probability quarter(0.25f);
+   size_t hits = 0;
+   for (size_t i = 0; i < 10000; ++i)
+   {
+      BOOST_REQUIRE(!never.random(random));
+      BOOST_REQUIRE(always.random(random));
+      hits += quarter.random(random);
+   }
+   BOOST_REQUIRE(hits > 2300 && hits < 2700);
+
+   // Skips are geometric, with (1 - p) / p failures on average;
+   size_t zeros = 0;
+   double sum = 0.0;
+   for (size_t i = 0; i < 10000; ++i)
+   {
+      BOOST_REQUIRE(never.skip(random) == std::numeric_limits<size_t>::max());
+      BOOST_REQUIRE(always.skip(random) == 0);
+      const size_t skip = quarter.skip(random);
+      zeros += (skip == 0);
+      sum += skip;
+   }
+   BOOST_REQUIRE(zeros > 2300 && zeros < 2700);
+   BOOST_REQUIRE(std::abs(sum / 10000 - 3.0) < 0.2);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_UniformGenerators)
+{
+   // Predefined values come first, the generator is used after them;
+   CounterRandomGenerator random(5);
+   CounterRandomGenerator reference(5);
+   const UniformUInt16RandomGenerator ints(1000, random);
+   for (size_t i = 0; i < 100; ++i)
+   {
+      BOOST_REQUIRE(ints.generate() == reference.generate(1000));
+   }
+
+   const UniformNormalizedFloatRandomGenerator floats(
+      std::vector<float>({0.5f, 0.25f})
+   );
+   BOOST_REQUIRE(floats.generate() == 0.5f);
+   BOOST_REQUIRE(floats.generate() == 0.25f);
+   BOOST_REQUIRE(floats.generate() == 0.0f);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
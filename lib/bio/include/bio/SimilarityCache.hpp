@@ -0,0 +1 @@
+#include "../../src/SimilarityCache.hpp"
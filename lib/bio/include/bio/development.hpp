@@ -0,0 +1 @@
+#include "../../src/development.hpp"
@@ -59,6 +59,13 @@ bool BaseAverageGeneParams::go() const
 }
 
 
+void BaseAverageGeneParams::mergeCounts(const BaseAverageGeneParams & other)
+{
+   m_count += other.m_count;
+   m_nopCount += other.m_nopCount;
+}
+
+
 /***************************************************************************
  *   AverageGeneI8I8I8Param class implementation                           *
  ***************************************************************************/
@@ -98,6 +105,18 @@ void AverageGeneParams<I8x3GeneParam, I8x3GeneParamSum>::add(
 }
 
 
+template <>
+void AverageGeneParams<I8x3GeneParam, I8x3GeneParamSum>::merge(
+   const AverageGeneParams & other
+)
+{
+   m_sum.a += other.m_sum.a;
+   m_sum.b += other.m_sum.b;
+   m_sum.c += other.m_sum.c;
+   mergeCounts(other);
+}
+
+
 template <>
 boost::optional<I8x3GeneParam> AverageGeneParams<I8x3GeneParam,
    I8x3GeneParamSum>::value() const
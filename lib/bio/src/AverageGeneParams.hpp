@@ -51,6 +51,7 @@ class BaseAverageGeneParams
 
    protected:
       bool go() const;
+      void mergeCounts(const BaseAverageGeneParams & other);
 
       uint32_t m_count;
 
@@ -71,6 +72,7 @@ class AverageGeneParams : public BaseAverageGeneParams
       explicit AverageGeneParams();
 
       void add(const StrongT & value);
+      void merge(const AverageGeneParams & other);
       boost::optional<StrongT> value() const;
 
    private:
@@ -93,6 +95,14 @@ void AverageGeneParams<StrongT, SumT>::add(const StrongT & value)
 }
 
 
+template <typename StrongT, typename SumT>
+void AverageGeneParams<StrongT, SumT>::merge(const AverageGeneParams & other)
+{
+   m_sum += other.m_sum;
+   mergeCounts(other);
+}
+
+
 template <typename StrongT, typename SumT>
 boost::optional<StrongT> AverageGeneParams<StrongT, SumT>::value() const
 {
@@ -146,6 +156,12 @@ void AverageGeneParams<I8x3GeneParam, I8x3GeneParamSum>::add(
 );
 
 
+template <>
+void AverageGeneParams<I8x3GeneParam, I8x3GeneParamSum>::merge(
+   const AverageGeneParams & other
+);
+
+
 template <>
 boost::optional<I8x3GeneParam> AverageGeneParams<I8x3GeneParam,
    I8x3GeneParamSum>::value() const;
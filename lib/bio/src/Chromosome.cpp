@@ -20,7 +20,11 @@
 
 #include <algorithm>
 #include <cassert>
-#include <cstdlib>
+#include <limits>
+
+
+#include "algo/Hasher.hpp"
+#include "algo/random_generators.hpp"
 
 
 #include "Chromosome.hpp"
@@ -30,51 +34,177 @@
 namespace bio {
 
 
+namespace {
+
+uint64_t _hash(const std::vector<uint32_t> & keys)
+{
+   algo::Hasher hasher(keys.size());
+   for (uint32_t key : keys)
+   {
+      hasher.add(key);
+   }
+   return hasher.value();
+}
+
+
+Instruction _randomInstruction(algo::CounterRandomGenerator & random)
+{
+   const uint32_t raw = random.generate();
+   return Instruction(raw, raw >> 8, raw >> 16);
+}
+
+
+// Position of the next passed trial at or after the given one;
+size_t _nextTrial(
+   const algo::Probability & probability,
+   algo::CounterRandomGenerator & random,
+   size_t position
+)
+{
+   const size_t skip = probability.skip(random);
+   return (skip < std::numeric_limits<size_t>::max() - position) ?
+      position + skip :
+      std::numeric_limits<size_t>::max();
+}
+
+
+// Every instruction has a trial of each kind, and one more insertion is
+// tried after the last one. A deleted instruction is not mutated. Only the
+// passed trials are drawn, the failed ones in between are skipped. Mutations
+// alone are made in place. Returns whether any trial passed;
+bool _skipTrials(
+   std::vector<Instruction> & code,
+   const MutationParams & params,
+   algo::CounterRandomGenerator & random
+)
+{
+   static const size_t none = std::numeric_limits<size_t>::max();
+   const size_t count = code.size();
+   size_t insertion = _nextTrial(params.instructionInsertion, random, 0);
+   size_t deletion = _nextTrial(params.instructionDeletion, random, 0);
+   size_t mutation = _nextTrial(params.instructionMutation, random, 0);
+   insertion = (insertion <= count) ? insertion : none;
+   deletion = (deletion < count) ? deletion : none;
+   const bool isResized = (insertion != none) || (deletion != none);
+   const bool isChanged = isResized || (mutation < count);
+
+   // Runs of instructions between insertions and deletions are copied at
+   // once, after their mutations are made. An insertion goes before a
+   // deletion at the same position;
+   std::vector<Instruction> newCode;
+   if (isResized)
+   {
+      newCode.reserve(count + count / 4 + 1);
+   }
+   size_t begin = 0;
+   for (size_t end = std::min(insertion, deletion);
+      end != none;
+      end = std::min(insertion, deletion))
+   {
+      for (; mutation < end; mutation = _nextTrial(
+         params.instructionMutation, random, mutation + 1))
+      {
+         code[mutation] = code[mutation].mutated(params, random);
+      }
+      newCode.insert(newCode.end(), code.begin() + begin, code.begin() + end);
+      if (insertion <= deletion)
+      {
+         newCode.push_back(_randomInstruction(random));
+         begin = end;
+         insertion = _nextTrial(params.instructionInsertion, random, end + 1);
+         insertion = (insertion <= count) ? insertion : none;
+      }
+      else
+      {
+         if (mutation == deletion)
+         {
+            mutation = _nextTrial(params.instructionMutation, random, end + 1);
+         }
+         begin = end + 1;
+         deletion = _nextTrial(params.instructionDeletion, random, end + 1);
+         deletion = (deletion < count) ? deletion : none;
+      }
+   }
+   for (; mutation < count; mutation = _nextTrial(
+      params.instructionMutation, random, mutation + 1))
+   {
+      code[mutation] = code[mutation].mutated(params, random);
+   }
+
+   if (isResized)
+   {
+      newCode.insert(newCode.end(), code.begin() + begin, code.end());
+      code = std::move(newCode);
+   }
+   return isChanged;
+}
+
+} // anonymous namespace;
+
+
 /***************************************************************************
  *   Chromosome class implementation                                       *
  ***************************************************************************/
 
 
 Chromosome::Chromosome()
+   : m_keysHash(0)
 {
 }
 
 
 Chromosome::Chromosome(const std::vector<Instruction> & code)
-   : m_code(code)
+   : m_code(code),
+   m_keysHash(0)
 {
 }
 
 
 Chromosome::Chromosome(std::initializer_list<Instruction> list)
-   : m_code(list)
+   : m_code(list),
+   m_keysHash(0)
 {
 }
 
 
-void Chromosome::applyMutations(const MutationParams & params)
+const std::vector<uint32_t> & Chromosome::keys(
+   const InstructionEquals & equals
+) const
 {
-   std::vector<Instruction> newCode;
-   newCode.reserve(m_code.size());
-   for (const Instruction & instr : m_code)
+   if (m_keysConfig != equals.config())
    {
-      if (params.instructionInsertion.random())
+      m_keys.clear();
+      m_keys.reserve(m_code.size());
+      for (const Instruction & instr : m_code)
       {
-         newCode.push_back(Instruction(rand(), rand(), rand()));
-      }
-      if (!params.instructionDeletion.random())
-      {
-         newCode.push_back(params.instructionMutation.random() ?
-            instr.mutated(params) : instr
-         );
+         m_keys.push_back(equals.key(instr));
       }
+      m_keysHash = _hash(m_keys);
+      m_keysConfig = equals.config();
    }
+   return m_keys;
+}
 
-   if (params.instructionInsertion.random())
+
+uint64_t Chromosome::keysHash(const InstructionEquals & equals) const
+{
+   keys(equals);
+   return m_keysHash;
+}
+
+
+void Chromosome::applyMutations(
+   const MutationParams & params,
+   algo::CounterRandomGenerator & random
+)
+{
+   // Unchanged code keeps its keys;
+   if (_skipTrials(m_code, params, random))
    {
-      newCode.push_back(Instruction(rand(), rand(), rand()));
+      m_keys.clear();
+      m_keysHash = 0;
+      m_keysConfig.reset();
    }
-   m_code = newCode; // FIXME: Optimization needed;
 }
 
 
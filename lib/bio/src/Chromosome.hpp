@@ -22,17 +22,27 @@
 #define BIO_CHROMOSOME_HPP
 
 
+#include <cstdint>
 #include <initializer_list>
 #include <ostream>
 #include <vector>
 
 
+#include <boost/shared_ptr.hpp>
+
+
 #include "InstructionSet.hpp"
 
 
+namespace algo {
+class CounterRandomGenerator;
+}
+
+
 namespace bio {
 
 
+struct Config;
 struct MutationParams;
 
 
@@ -50,10 +60,23 @@ class Chromosome
 
       inline const std::vector<Instruction> & code() const;
 
-      void applyMutations(const MutationParams & params);
+      // InstructionEquals keys of the code, computed on first use for the
+      // config of the comparator. Not to be called concurrently until the
+      // keys exist, Genome prepares them for its chromosomes;
+      const std::vector<uint32_t> & keys(const InstructionEquals & equals) const;
+      // Hash of the keys, made along with them;
+      uint64_t keysHash(const InstructionEquals & equals) const;
+
+      void applyMutations(
+         const MutationParams & params,
+         algo::CounterRandomGenerator & random
+      );
 
    private:
       std::vector<Instruction> m_code;
+      mutable std::vector<uint32_t> m_keys;
+      mutable uint64_t m_keysHash;
+      mutable boost::shared_ptr<const Config> m_keysConfig;
 };
 
 
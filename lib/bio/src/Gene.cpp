@@ -18,6 +18,9 @@
  ***************************************************************************/
 
 
+#include "algo/Hasher.hpp"
+
+
 #include "Config.hpp"
 #include "Gene.hpp"
 #include "GeneInitializer.hpp"
@@ -46,6 +49,19 @@ bio::RangeCondition<dt::Int16> _getRangeCondition(
    return bio::RangeCondition<dt::Int16>();
 }
 
+
+template <typename T>
+void _hash(algo::Hasher & hasher, const bio::RangeCondition<T> & condition)
+{
+   for (const boost::optional<T> & bound :
+      {condition.greaterOrEqual(), condition.lessOrEqual()})
+   {
+      hasher.add(
+         bound ? (0x10000u | static_cast<uint16_t>(bound->get())) : 0
+      );
+   }
+}
+
 } // anonymous namespace;
 
 
@@ -145,6 +161,32 @@ bool Gene::hasResponse() const
 }
 
 
+bool Gene::operator==(const Gene & other) const
+{
+   return (generationCondition == other.generationCondition) &&
+      (xCondition == other.xCondition) &&
+      (yCondition == other.yCondition) &&
+      (responses == other.responses);
+}
+
+
+uint64_t Gene::hash() const
+{
+   algo::Hasher hasher(responses.size());
+   _hash(hasher, generationCondition);
+   _hash(hasher, xCondition);
+   _hash(hasher, yCondition);
+   for (const Instruction & instr : responses)
+   {
+      hasher.add(
+         (static_cast<uint32_t>(instr.u16().get()) << 16) |
+            (static_cast<uint32_t>(instr.u8().get()) << 8) | instr.cmd()
+      );
+   }
+   return hasher.value();
+}
+
+
 std::ostream & operator<<(std::ostream & os, const Gene & gene)
 {
    /*os << "{" << cell.v0() << ", " << cell.v1() << ", " <<
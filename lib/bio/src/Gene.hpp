@@ -22,6 +22,7 @@
 #define BIO_GENE_HPP
 
 
+#include <cstdint>
 #include <ostream>
 #include <vector>
 
@@ -59,6 +60,11 @@ struct Gene
 
    bool hasResponse() const;
 
+   // Genes are equal when their conditions and responses are, equal genes
+   // have equal hashes;
+   bool operator==(const Gene & other) const;
+   uint64_t hash() const;
+
    // Conditions;
    RangeCondition<dt::UInt16> generationCondition;
    RangeCondition<dt::Int16> xCondition;
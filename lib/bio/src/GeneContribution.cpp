@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include "GeneContribution.hpp"
+#include "GeneInitializer.hpp"
+#include "InstructionSet.hpp"
+
+
+namespace bio {
+
+
+/***************************************************************************
+ *   GeneContribution structure implementation                             *
+ ***************************************************************************/
+
+
+GeneContribution::GeneContribution()
+   : commit(0), rollback(0)
+{
+}
+
+
+GeneContribution::GeneContribution(
+   const std::vector<Instruction> & responses,
+   const Config & config
+)
+{
+   GeneInitializer init;
+   for (const Instruction & instr : responses)
+   {
+      init.append(instr, config);
+   }
+   commit = init.commit;
+   rollback = init.rollback;
+   abcBud = init.abcBud;
+   acdBud = init.acdBud;
+   adbBud = init.adbBud;
+   bcdBud = init.bcdBud;
+}
+
+
+GeneContribution & GeneContribution::operator+=(const GeneContribution & other)
+{
+   commit += other.commit;
+   rollback += other.rollback;
+   abcBud.merge(other.abcBud);
+   acdBud.merge(other.acdBud);
+   adbBud.merge(other.adbBud);
+   bcdBud.merge(other.bcdBud);
+   return *this;
+}
+
+
+}
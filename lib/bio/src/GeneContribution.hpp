@@ -0,0 +1,70 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef BIO_GENECONTRIBUTION_H
+#define BIO_GENECONTRIBUTION_H
+
+
+#include <cstdint>
+#include <vector>
+
+
+#include "AverageGeneParams.hpp"
+
+
+namespace bio {
+
+
+class Instruction;
+struct Config;
+
+
+/***************************************************************************
+ *   GeneContribution structure declaration                                *
+ ***************************************************************************/
+
+
+// Responses of a gene decoded once. Expressing a set of genes is then a sum
+// of their contributions instead of interpreting every response instruction
+// of every gene again;
+struct GeneContribution
+{
+   explicit GeneContribution();
+   explicit GeneContribution(
+      const std::vector<Instruction> & responses,
+      const Config & config
+   );
+
+   GeneContribution & operator+=(const GeneContribution & other);
+
+   uint32_t commit;
+   uint32_t rollback;
+   AverageGeneI8x3Param abcBud;
+   AverageGeneI8x3Param acdBud;
+   AverageGeneI8x3Param adbBud;
+   AverageGeneI8x3Param bcdBud;
+};
+
+
+}
+
+
+#endif
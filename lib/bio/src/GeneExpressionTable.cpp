@@ -0,0 +1,138 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include "Cell.hpp"
+#include "GeneContribution.hpp"
+#include "GeneExpressionTable.hpp"
+#include "GeneIndex.hpp"
+
+
+namespace bio {
+
+
+namespace {
+
+uint64_t _key(const Cell & cell)
+{
+   return (static_cast<uint64_t>(cell.generation()) << 32) |
+      (static_cast<uint64_t>(static_cast<uint16_t>(cell.x())) << 16) |
+      static_cast<uint64_t>(static_cast<uint16_t>(cell.y()));
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   GeneExpression structure implementation                               *
+ ***************************************************************************/
+
+
+GeneExpression::GeneExpression()
+{
+}
+
+
+bool GeneExpression::hasBud() const
+{
+   return (buds[0] || buds[1] || buds[2] || buds[3]);
+}
+
+
+/***************************************************************************
+ *   GeneExpressionTable class implementation                              *
+ ***************************************************************************/
+
+
+GeneExpressionTable::GeneExpressionTable()
+   : m_hitCount(0), m_missCount(0)
+{
+}
+
+
+GeneExpressionTable::~GeneExpressionTable()
+{
+}
+
+
+const GeneExpression & GeneExpressionTable::expression(
+   const Cell & cell,
+   const std::vector<GeneContribution> & contributions,
+   const GeneIndex & index
+)
+{
+   const uint64_t key = _key(cell);
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const auto it = m_table.find(key);
+      if (it != m_table.end())
+      {
+         ++m_hitCount;
+         return it->second;
+      }
+      ++m_missCount;
+   }
+
+   // Apply genes to the cell, the table is not locked meanwhile;
+   GeneContribution sum;
+   const std::vector<size_t> matching = index.find(
+      dt::UInt16(cell.generation()),
+      dt::Int16(cell.x()),
+      dt::Int16(cell.y())
+   );
+   for (size_t i : matching)
+   {
+      sum += contributions[i];
+   }
+
+   GeneExpression expr;
+   expr.buds[0] = sum.abcBud.value();
+   expr.buds[1] = sum.acdBud.value();
+   expr.buds[2] = sum.adbBud.value();
+   expr.buds[3] = sum.bcdBud.value();
+
+   // Another thread could have got ahead, its result is the same;
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_table.insert(std::make_pair(key, expr)).first->second;
+}
+
+
+size_t GeneExpressionTable::size() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_table.size();
+}
+
+
+uint64_t GeneExpressionTable::hitCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_hitCount;
+}
+
+
+uint64_t GeneExpressionTable::missCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_missCount;
+}
+
+
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef BIO_GENEEXPRESSIONTABLE_H
+#define BIO_GENEEXPRESSIONTABLE_H
+
+
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+
+#include <boost/optional.hpp>
+
+
+#include "AverageGeneParams.hpp"
+
+
+namespace bio {
+
+
+class Cell;
+struct GeneContribution;
+class GeneIndex;
+
+
+/***************************************************************************
+ *   GeneExpression structure declaration                                  *
+ ***************************************************************************/
+
+
+struct GeneExpression
+{
+   explicit GeneExpression();
+
+   bool hasBud() const;
+
+   // Averaged bud responses for the TF_ABC, TF_ACD, TF_ADB and TF_BCD faces;
+   boost::optional<I8x3GeneParam> buds[4];
+};
+
+
+/***************************************************************************
+ *   GeneExpressionTable class declaration                                 *
+ ***************************************************************************/
+
+
+// Memoises gene expression by cell state. Conditions of genes depend only on
+// the generation and coordinates of a cell, so every cell with the same state
+// expresses the same responses. The table is thread-safe, references it
+// returns stay valid for its whole lifetime;
+class GeneExpressionTable
+{
+   public:
+      explicit GeneExpressionTable();
+      virtual ~GeneExpressionTable();
+
+      const GeneExpression & expression(
+         const Cell & cell,
+         const std::vector<GeneContribution> & contributions,
+         const GeneIndex & index
+      );
+
+      size_t size() const;
+      uint64_t hitCount() const;
+      uint64_t missCount() const;
+
+   private:
+      mutable std::mutex m_mutex;
+      std::unordered_map<uint64_t, GeneExpression> m_table;
+      uint64_t m_hitCount;
+      uint64_t m_missCount;
+};
+
+
+}
+
+
+#endif
@@ -0,0 +1,205 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+
+#include "Gene.hpp"
+#include "GeneIndex.hpp"
+
+
+namespace bio {
+
+
+namespace {
+
+struct _Interval
+{
+   int32_t first;
+   int32_t last;
+   size_t gene;
+};
+
+
+template <typename T>
+void _appendIntervals(
+   const RangeCondition<T> & condition,
+   size_t gene,
+   std::vector<_Interval> & intervals
+)
+{
+   typedef typename T::WeakType WeakType;
+   const int32_t min = std::numeric_limits<WeakType>::min();
+   const int32_t max = std::numeric_limits<WeakType>::max();
+   const boost::optional<T> ge = condition.greaterOrEqual();
+   const boost::optional<T> le = condition.lessOrEqual();
+   const int32_t first = (ge ? ge->get() : min);
+   const int32_t last = (le ? le->get() : max);
+   if (first > last)
+   {
+      // Both bounds are set, the range wraps around;
+      intervals.push_back(_Interval{min, last, gene});
+      intervals.push_back(_Interval{first, max, gene});
+   }
+   else
+   {
+      intervals.push_back(_Interval{first, last, gene});
+   }
+}
+
+
+template <typename T>
+void _build(
+   const std::vector<Gene> & genes,
+   RangeCondition<T> Gene::* condition,
+   size_t wordCount,
+   std::vector<int32_t> & bounds,
+   std::vector<uint64_t> & masks
+)
+{
+   std::vector<_Interval> intervals;
+   intervals.reserve(genes.size() * 2);
+   for (size_t i = 0, count = genes.size(); i < count; ++i)
+   {
+      _appendIntervals(genes[i].*condition, i, intervals);
+   }
+
+   // Every interval starts a segment and starts another one past its end;
+   std::vector<std::pair<int32_t, int32_t> > starts;
+   std::vector<std::pair<int32_t, int32_t> > ends;
+   bounds.clear();
+   bounds.push_back(std::numeric_limits<typename T::WeakType>::min());
+   for (const _Interval & interval : intervals)
+   {
+      bounds.push_back(interval.first);
+      bounds.push_back(interval.last + 1);
+   }
+   std::sort(bounds.begin(), bounds.end());
+   bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+   // Sweep the segments, toggling the genes whose intervals end or start
+   // there. Intervals of a gene are disjoint, so ends are applied first;
+   std::vector<std::vector<size_t> > started(bounds.size());
+   std::vector<std::vector<size_t> > ended(bounds.size());
+   for (const _Interval & interval : intervals)
+   {
+      const size_t first = std::lower_bound(
+         bounds.begin(), bounds.end(), interval.first
+      ) - bounds.begin();
+      const size_t end = std::lower_bound(
+         bounds.begin(), bounds.end(), interval.last + 1
+      ) - bounds.begin();
+      started[first].push_back(interval.gene);
+      if (end < bounds.size())
+      {
+         ended[end].push_back(interval.gene);
+      }
+   }
+
+   masks.assign(bounds.size() * wordCount, 0);
+   std::vector<uint64_t> current(wordCount, 0);
+   for (size_t s = 0, count = bounds.size(); s < count; ++s)
+   {
+      for (size_t gene : ended[s])
+      {
+         current[gene / 64] &= ~(uint64_t(1) << (gene % 64));
+      }
+      for (size_t gene : started[s])
+      {
+         current[gene / 64] |= (uint64_t(1) << (gene % 64));
+      }
+      std::copy(current.begin(), current.end(), masks.begin() + s * wordCount);
+   }
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   GeneIndex class implementation                                        *
+ ***************************************************************************/
+
+
+GeneIndex::GeneIndex()
+   : m_geneCount(0), m_wordCount(0)
+{
+}
+
+
+GeneIndex::GeneIndex(const std::vector<Gene> & genes)
+   : m_geneCount(genes.size()), m_wordCount((genes.size() + 63) / 64)
+{
+   _build(
+      genes,
+      &Gene::generationCondition,
+      m_wordCount,
+      m_generation.bounds,
+      m_generation.masks
+   );
+   _build(genes, &Gene::xCondition, m_wordCount, m_x.bounds, m_x.masks);
+   _build(genes, &Gene::yCondition, m_wordCount, m_y.bounds, m_y.masks);
+}
+
+
+std::vector<size_t> GeneIndex::find(
+   const dt::UInt16 & generation,
+   const dt::Int16 & x,
+   const dt::Int16 & y
+) const
+{
+   std::vector<size_t> result;
+   if (!m_geneCount)
+   {
+      return result;
+   }
+
+   const uint64_t * g = masks(m_generation, generation.get());
+   const uint64_t * mx = masks(m_x, x.get());
+   const uint64_t * my = masks(m_y, y.get());
+   for (size_t w = 0; w < m_wordCount; ++w)
+   {
+      uint64_t word = g[w] & mx[w] & my[w];
+      while (word)
+      {
+         const size_t bit = __builtin_ctzll(word);
+         result.push_back(w * 64 + bit);
+         word &= (word - 1);
+      }
+   }
+   return result;
+}
+
+
+const uint64_t * GeneIndex::masks(const Axis & axis, int32_t value) const
+{
+   const auto it = std::upper_bound(
+      axis.bounds.begin(),
+      axis.bounds.end(),
+      value
+   );
+   assert(it != axis.bounds.begin());
+   return &axis.masks[((it - axis.bounds.begin()) - 1) * m_wordCount];
+}
+
+
+}
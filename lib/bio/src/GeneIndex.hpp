@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef BIO_GENEINDEX_H
+#define BIO_GENEINDEX_H
+
+
+#include <cstdint>
+#include <vector>
+
+
+#include "datatypes/numeric.hpp"
+
+
+namespace bio {
+
+
+struct Gene;
+
+
+/***************************************************************************
+ *   GeneIndex class declaration                                           *
+ ***************************************************************************/
+
+
+// Finds the genes whose generation, x and y conditions accept a cell state.
+// Each axis is split into segments at the bounds of the conditions, every
+// segment keeps a bit mask of the genes accepting its values. Wrapped
+// ranges, where greaterOrEqual > lessOrEqual, are split into two intervals;
+class GeneIndex
+{
+   public:
+      explicit GeneIndex();
+      explicit GeneIndex(const std::vector<Gene> & genes);
+
+      // Indices of the matching genes, in ascending order;
+      std::vector<size_t> find(
+         const dt::UInt16 & generation,
+         const dt::Int16 & x,
+         const dt::Int16 & y
+      ) const;
+
+      inline size_t geneCount() const {return m_geneCount;}
+
+   private:
+      struct Axis
+      {
+         // First value of each segment, the first one is the domain minimum;
+         std::vector<int32_t> bounds;
+         std::vector<uint64_t> masks;
+      };
+
+      const uint64_t * masks(const Axis & axis, int32_t value) const;
+
+      size_t m_geneCount;
+      size_t m_wordCount;
+      Axis m_generation;
+      Axis m_x;
+      Axis m_y;
+};
+
+
+}
+
+
+#endif
@@ -19,11 +19,13 @@
 
 
 #include <cstring>
+#include <unordered_map>
 
 
 #include "algo/Alignment.hpp"
 #include "algo/distance.hpp"
 #include "algo/pairing.hpp"
+#include "algo/random_generators.hpp"
 
 
 #include "Config.hpp"
@@ -32,6 +34,7 @@
 #include "Genome.hpp"
 #include "InstructionSet.hpp"
 #include "MutationParams.hpp"
+#include "SimilarityCache.hpp"
 
 
 namespace bio {
@@ -42,14 +45,26 @@ namespace {
 float _symmetricCompare(
    const Chromosome & lhs,
    const Chromosome & rhs,
+   float threshold,
    const InstructionEquals & equals
 )
 {
-   return algo::getLevenshteinDistanceSimilarity(
-      lhs.code(),
-      rhs.code(),
-      equals
+   SimilarityCache & cache = SimilarityCache::instance();
+   const uint64_t lhsHash = lhs.keysHash(equals);
+   const uint64_t rhsHash = rhs.keysHash(equals);
+   if (const boost::optional<float> similarity =
+      cache.find(lhsHash, rhsHash, threshold))
+   {
+      return *similarity;
+   }
+
+   const float similarity = algo::getBoundedLevenshteinDistanceSimilarity(
+      lhs.keys(equals),
+      rhs.keys(equals),
+      threshold
    );
+   cache.insert(lhsHash, rhsHash, threshold, similarity);
+   return similarity;
 }
 
 } // anonymous namespace;
@@ -62,33 +77,24 @@ float _symmetricCompare(
 
 Genome::Genome(
    boost::shared_ptr<const Config> config,
-   const MutationParams & mutationParams
+   const MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random
 ) : m_config(config)
 {
-   const size_t codeSize = 1 + (rand() % mutationParams.maxCodeSize);
+   const size_t codeSize = 1 + random.generate(mutationParams.maxCodeSize);
    std::vector<Instruction> code;
    code.reserve(codeSize);
    for (size_t i = 0; i < codeSize; ++i)
    {
-      code.push_back(Instruction(rand() % 256, rand() % 256, rand() % 65536));
+      code.push_back(Instruction(
+         random.generate(256),
+         random.generate(256),
+         random.generate(65536)
+      ));
    }
    m_chromosomes.push_back(Chromosome(code));
 
-   // Build homologous pairs;
-   const InstructionEquals instrEquals(m_config);
-   auto compare = std::bind(
-      _symmetricCompare,
-      std::placeholders::_1,
-      std::placeholders::_2,
-      instrEquals
-   );
-   m_pairs = std::move(algo::pairing::resolve<float>(
-      m_chromosomes,
-      compare,
-      algo::pairing::MS_MORE_METRIC_MORE_ALIKE,
-      0.51
-   ));
-
+   initializePairs();
    initializeGenes();
 }
 
@@ -98,21 +104,7 @@ Genome::Genome(
    const std::vector<Chromosome> & diploid
 ) : m_config(config), m_chromosomes(diploid)
 {
-   // Build homologous pairs;
-   const InstructionEquals instrEquals(m_config);
-   auto compare = std::bind(
-      _symmetricCompare,
-      std::placeholders::_1,
-      std::placeholders::_2,
-      instrEquals
-   );
-   m_pairs = std::move(algo::pairing::resolve<float>(
-      m_chromosomes,
-      compare,
-      algo::pairing::MS_MORE_METRIC_MORE_ALIKE,
-      0.51
-   ));
-
+   initializePairs();
    initializeGenes();
 }
 
@@ -120,7 +112,8 @@ Genome::Genome(
 Genome::Genome(
    boost::shared_ptr<const Config> config,
    const std::vector<Chromosome> & haploidLeft,
-   const std::vector<Chromosome> & haploidRight
+   const std::vector<Chromosome> & haploidRight,
+   size_t threadCount
 ) : m_config(config)
 {
    // Copy chromosomes;
@@ -136,21 +129,7 @@ Genome::Genome(
       haploidRight.end()
    );
 
-   // Build homologous pairs;
-   const InstructionEquals instrEquals(m_config);
-   auto compare = std::bind(
-      _symmetricCompare,
-      std::placeholders::_1,
-      std::placeholders::_2,
-      instrEquals
-   );
-   m_pairs = std::move(algo::pairing::resolve<float>(
-      m_chromosomes,
-      compare,
-      algo::pairing::MS_MORE_METRIC_MORE_ALIKE,
-      0.51
-   ));
-
+   initializePairs(threadCount);
    initializeGenes();
 }
 
@@ -159,7 +138,11 @@ Genome::Genome(const Genome & other)
    : m_config(other.m_config),
    m_chromosomes(other.m_chromosomes),
    m_pairs(other.m_pairs),
-   m_genes(other.m_genes)
+   m_genes(other.m_genes),
+   m_geneWeights(other.m_geneWeights),
+   m_geneContributions(other.m_geneContributions),
+   m_geneIndex(other.m_geneIndex),
+   m_expressionTable(other.m_expressionTable)
 {
 }
 
@@ -168,7 +151,11 @@ Genome::Genome(Genome && other)
    : m_config(other.m_config),
    m_chromosomes(std::move(other.m_chromosomes)),
    m_pairs(std::move(other.m_pairs)),
-   m_genes(std::move(other.m_genes))
+   m_genes(std::move(other.m_genes)),
+   m_geneWeights(std::move(other.m_geneWeights)),
+   m_geneContributions(std::move(other.m_geneContributions)),
+   m_geneIndex(std::move(other.m_geneIndex)),
+   m_expressionTable(other.m_expressionTable)
 {
 }
 
@@ -186,6 +173,10 @@ Genome & Genome::operator=(const Genome & other)
       m_chromosomes = other.m_chromosomes;
       m_pairs = other.m_pairs;
       m_genes = other.m_genes;
+      m_geneWeights = other.m_geneWeights;
+      m_geneContributions = other.m_geneContributions;
+      m_geneIndex = other.m_geneIndex;
+      m_expressionTable = other.m_expressionTable;
    }
    return *this;
 }
@@ -199,6 +190,10 @@ Genome & Genome::operator=(Genome && other)
       m_chromosomes = std::move(other.m_chromosomes);
       m_pairs = std::move(other.m_pairs);
       m_genes = std::move(other.m_genes);
+      m_geneWeights = std::move(other.m_geneWeights);
+      m_geneContributions = std::move(other.m_geneContributions);
+      m_geneIndex = std::move(other.m_geneIndex);
+      m_expressionTable = other.m_expressionTable;
    }
    return *this;
 }
@@ -210,10 +205,22 @@ boost::shared_ptr<const Config> Genome::config() const
 }
 
 
+const GeneExpression & Genome::expression(const Cell & cell) const
+{
+   return m_expressionTable->expression(
+      cell,
+      m_geneContributions,
+      m_geneIndex
+   );
+}
+
+
 std::vector<Chromosome> Genome::makeHaploid(
-   const MutationParams & mutationParams
+   const MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random
 ) const
 {
+   const InstructionEquals instrEquals(m_config);
    std::vector<Chromosome> haploid;
    haploid.reserve(m_pairs.size());
    for(const auto & pair : m_pairs)
@@ -228,36 +235,72 @@ std::vector<Chromosome> Genome::makeHaploid(
             m_chromosomes[*pair.right].code();
          auto codePair = crossOver(
             codeLeft, codeRight,
-            algo::Alignment(codeLeft, codeRight, InstructionEquals(m_config)),
+            algo::Alignment(
+               m_chromosomes[pair.left].keys(instrEquals),
+               m_chromosomes[*pair.right].keys(instrEquals)
+            ),
             algo::UniformUInt16RandomGenerator(
-               mutationParams.maxDistanceBetweenCrossingPoints
+               mutationParams.maxDistanceBetweenCrossingPoints,
+               random
             )
          );
          Chromosome chromosome(codePair.first);
-         chromosome.applyMutations(mutationParams);
+         chromosome.applyMutations(mutationParams, random);
          haploid.push_back(std::move(chromosome));
       }
       else
       {
          Chromosome chromosome(codeLeft);
-         chromosome.applyMutations(mutationParams);
+         chromosome.applyMutations(mutationParams, random);
          haploid.push_back(std::move(chromosome));
       }
    }
 
    const size_t count = haploid.size();
-   if ((count > 1) && mutationParams.chromosomeDeletion.random())
+   if ((count > 1) && mutationParams.chromosomeDeletion.random(random))
    {
-      haploid.erase(haploid.begin() + (rand() % count));
+      haploid.erase(haploid.begin() + random.generate(count));
    }
    return haploid;
 }
 
 
+void Genome::initializePairs(size_t threadCount)
+{
+   // Keys are cached by the chromosomes, they are all made here so that the
+   // genome can be shared between threads afterwards;
+   const InstructionEquals instrEquals(m_config);
+   for (const Chromosome & chromosome : m_chromosomes)
+   {
+      chromosome.keys(instrEquals);
+   }
+
+   // Build homologous pairs, large genomes compare chromosomes in parallel;
+   auto compare = std::bind(
+      _symmetricCompare,
+      std::placeholders::_1,
+      std::placeholders::_2,
+      std::placeholders::_3,
+      instrEquals
+   );
+   m_pairs = std::move(algo::pairing::resolveBounded<float>(
+      m_chromosomes,
+      compare,
+      algo::pairing::MS_MORE_METRIC_MORE_ALIKE,
+      0.51,
+      threadCount
+   ));
+}
+
+
 void Genome::initializeGenes()
 {
-   // TODO: Eliminate gene copies from homologous cromosomes;
+   // Homologous chromosomes mostly carry the same genes. Every gene is kept
+   // once along with the number of its copies, so a cell evaluates it once,
+   // while averages still count all of the copies;
    m_genes.clear();
+   m_geneWeights.clear();
+   std::unordered_multimap<uint64_t, size_t> genesByHash;
    const Config & config = *m_config;
    for (size_t i = 0, icount = m_chromosomes.size(); i < icount; ++i)
    {
@@ -272,13 +315,44 @@ void Genome::initializeGenes()
             Gene gene(*m_config, init);
             if (gene.hasResponse())
             {
-               m_genes.push_back(std::move(gene));
+               const uint64_t hash = gene.hash();
+               auto range = genesByHash.equal_range(hash);
+               while (range.first != range.second &&
+                  !(m_genes[range.first->second] == gene))
+               {
+                  ++range.first;
+               }
+               if (range.first != range.second)
+               {
+                  ++m_geneWeights[range.first->second];
+               }
+               else
+               {
+                  genesByHash.insert(std::make_pair(hash, m_genes.size()));
+                  m_genes.push_back(std::move(gene));
+                  m_geneWeights.push_back(1);
+               }
             }
             init = GeneInitializer();
          }
       }
    }
    m_genes.shrink_to_fit();
+   m_geneWeights.shrink_to_fit();
+
+   m_geneContributions.clear();
+   m_geneContributions.reserve(m_genes.size());
+   for (size_t i = 0, count = m_genes.size(); i < count; ++i)
+   {
+      const GeneContribution contribution(m_genes[i].responses, config);
+      m_geneContributions.push_back(contribution);
+      for (uint32_t copy = 1; copy < m_geneWeights[i]; ++copy)
+      {
+         m_geneContributions.back() += contribution;
+      }
+   }
+   m_geneIndex = GeneIndex(m_genes);
+   m_expressionTable.reset(new GeneExpressionTable());
 }
 
 
@@ -31,9 +31,13 @@
 
 #include "Chromosome.hpp"
 #include "Gene.hpp"
+#include "GeneContribution.hpp"
+#include "GeneExpressionTable.hpp"
+#include "GeneIndex.hpp"
 
 
 namespace algo {
+class CounterRandomGenerator;
 namespace pairing {
 template<typename Metric> struct Pair;
 }
@@ -43,6 +47,7 @@ template<typename Metric> struct Pair;
 namespace bio {
 
 
+class Cell;
 struct Config;
 struct MutationParams;
 
@@ -57,16 +62,20 @@ class Genome
    public:
       explicit Genome(
          boost::shared_ptr<const Config> config,
-         const MutationParams & mutationParams
+         const MutationParams & mutationParams,
+         algo::CounterRandomGenerator & random
       );
       explicit Genome(
          boost::shared_ptr<const Config> config,
          const std::vector<Chromosome> & diploid
       );
+      // Homologous pairs are resolved on the given number of threads, zero
+      // means as many as large genomes benefit from;
       explicit Genome(
          boost::shared_ptr<const Config> config,
          const std::vector<Chromosome> & haploidLeft,
-         const std::vector<Chromosome> & haploidRight
+         const std::vector<Chromosome> & haploidRight,
+         size_t threadCount = 0
       );
 
       Genome(const Genome & other);
@@ -79,19 +88,35 @@ class Genome
       boost::shared_ptr<const Config> config() const;
       inline const std::vector<Chromosome> & chromosomes() const;
       inline const std::vector<algo::pairing::Pair<float> > & pairs() const;
+      // Genes are unique, each one is weighted by the number of its copies
+      // in the chromosomes. Contributions are those of all the copies;
       inline const std::vector<Gene> & genes() const;
+      inline const std::vector<uint32_t> & geneWeights() const;
+      inline const std::vector<GeneContribution> & geneContributions() const;
+      inline const GeneIndex & geneIndex() const;
+
+      const GeneExpression & expression(const Cell & cell) const;
+      inline const GeneExpressionTable & expressionTable() const;
 
       std::vector<Chromosome> makeHaploid(
-         const MutationParams & mutationParams
+         const MutationParams & mutationParams,
+         algo::CounterRandomGenerator & random
       ) const;
 
    private:
+      void initializePairs(size_t threadCount = 0);
       void initializeGenes();
 
       boost::shared_ptr<const Config> m_config;
       std::vector<Chromosome> m_chromosomes;
       std::vector<algo::pairing::Pair<float> > m_pairs;
       std::vector<Gene> m_genes;
+      std::vector<uint32_t> m_geneWeights;
+      std::vector<GeneContribution> m_geneContributions;
+      GeneIndex m_geneIndex;
+
+      // Shared by copies, as they have the same genes;
+      boost::shared_ptr<GeneExpressionTable> m_expressionTable;
 };
 
 
@@ -113,6 +138,31 @@ inline const std::vector<Gene> & Genome::genes() const
 }
 
 
+inline const std::vector<uint32_t> & Genome::geneWeights() const
+{
+   return m_geneWeights;
+}
+
+
+inline const std::vector<GeneContribution> &
+Genome::geneContributions() const
+{
+   return m_geneContributions;
+}
+
+
+inline const GeneIndex & Genome::geneIndex() const
+{
+   return m_geneIndex;
+}
+
+
+inline const GeneExpressionTable & Genome::expressionTable() const
+{
+   return *m_expressionTable;
+}
+
+
 std::ostream & operator<<(std::ostream & os, const Genome & genome);
 
 
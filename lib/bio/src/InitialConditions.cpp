@@ -18,10 +18,12 @@
  ***************************************************************************/
 
 
-#include <cstdlib>
 #include <limits>
 
 
+#include "algo/random_generators.hpp"
+
+
 #include "InitialConditions.hpp"
 #include "MutationParams.hpp"
 
@@ -53,33 +55,38 @@ InitialConditions::InitialConditions()
 InitialConditions::InitialConditions(
    const InitialConditions & left,
    const InitialConditions & right,
-   const MutationParams & mutationParams
+   const MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random
 ) : cellLimit(0),
    x(_mean(left.x, right.x)),
    y(_mean(left.y, right.y))
 {
-   const uint32_t m = (left.cellLimit + right.cellLimit) / 2;
-   cellLimit = static_cast<uint16_t>(m);
+   const uint64_t m =
+      (static_cast<uint64_t>(left.cellLimit) + right.cellLimit) / 2;
+   cellLimit = static_cast<uint32_t>(m);
 
-   applyMutations(mutationParams);
+   applyMutations(mutationParams, random);
 }
 
 
-void InitialConditions::applyMutations(const MutationParams & params)
+void InitialConditions::applyMutations(
+   const MutationParams & params,
+   algo::CounterRandomGenerator & random
+)
 {
    // Modify cellLimit;
-   if (params.cellLimitMutation.random())
+   if (params.cellLimitMutation.random(random))
    {
-      uint16_t delta = 1 + (rand() % params.maxCellLimitDelta);
-      if (rand() % 2)
+      uint32_t delta = 1 + random.generate(params.maxCellLimitDelta);
+      if (random.generate(2))
       {
-         if ((std::numeric_limits<uint16_t>::max() - cellLimit) > delta)
+         if ((std::numeric_limits<uint32_t>::max() - cellLimit) > delta)
          {
             cellLimit += delta;
          }
          else
          {
-            cellLimit = std::numeric_limits<uint16_t>::max();
+            cellLimit = std::numeric_limits<uint32_t>::max();
          }
       }
       else
@@ -96,10 +103,10 @@ void InitialConditions::applyMutations(const MutationParams & params)
    }
 
    // Modify x and y;
-   if (params.initialCoordMutation.random())
+   if (params.initialCoordMutation.random(random))
    {
-      x += (1 - (rand() % 3));
-      y += (1 - (rand() % 3));
+      x += (1 - static_cast<int>(random.generate(3)));
+      y += (1 - static_cast<int>(random.generate(3)));
    }
 }
 
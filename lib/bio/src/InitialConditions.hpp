@@ -26,6 +26,11 @@
 #include <ostream>
 
 
+namespace algo {
+class CounterRandomGenerator;
+}
+
+
 namespace bio {
 
 
@@ -38,12 +43,16 @@ struct InitialConditions
    explicit InitialConditions(
       const InitialConditions & left,
       const InitialConditions & right,
-      const MutationParams & mutationParams
+      const MutationParams & mutationParams,
+      algo::CounterRandomGenerator & random
    );
 
-   void applyMutations(const MutationParams & params);
+   void applyMutations(
+      const MutationParams & params,
+      algo::CounterRandomGenerator & random
+   );
 
-   uint16_t cellLimit;
+   uint32_t cellLimit;
    int16_t x;
    int16_t y;
 };
@@ -18,11 +18,13 @@
  ***************************************************************************/
 
 
-#include <cstdlib>
 #include <iomanip>
 #include <sstream>
 
 
+#include "algo/random_generators.hpp"
+
+
 #include "Config.hpp"
 #include "InstructionSet.hpp"
 #include "MutationParams.hpp"
@@ -97,14 +99,17 @@ size_t Instruction::instructionCount()
 }
 
 
-Instruction Instruction::mutated(const MutationParams & params) const
+Instruction Instruction::mutated(
+   const MutationParams & params,
+   algo::CounterRandomGenerator & random
+) const
 {
    uint32_t raw = (m_u16 << 16) | (m_u8 << 8) | m_cmd;
    uint32_t mask = 0;
-   const size_t count = 1 + (rand() % params.maxInstructionBitFlips);
+   const size_t count = 1 + random.generate(params.maxInstructionBitFlips);
    for (size_t i = 0; i < count; ++i)
    {
-      mask |= (0x00000001 << (rand() % 32));
+      mask |= (0x00000001 << random.generate(32));
    }
    raw = raw ^ mask; // Invert bit;
    return Instruction(raw, raw << 8, raw << 16);
@@ -121,15 +126,24 @@ bool InstructionEquals::operator()(
    const Instruction & rhs
 ) const
 {
-   const Opcode lhsOpcode = m_config->opcode(lhs.cmd());
-   const Opcode rhsOpcode = m_config->opcode(rhs.cmd());
-   if (lhsOpcode == rhsOpcode)
+   return key(lhs) == key(rhs);
+}
+
+
+uint32_t InstructionEquals::key(const Instruction & instr) const
+{
+   const Opcode opcode = m_config->opcode(instr.cmd());
+   const uint8_t f = _instructionSet[opcode].params;
+   uint32_t result = static_cast<uint32_t>(opcode) << 24;
+   if (f & Instruction::P_INT8)
+   {
+      result |= static_cast<uint32_t>(instr.u8().get()) << 16;
+   }
+   if (f & Instruction::P_INT16)
    {
-      uint8_t f = _instructionSet[lhsOpcode].params;
-      return (!(f & Instruction::P_INT8) || lhs.u8() == rhs.u8()) &&
-         (!(f & Instruction::P_INT16) || lhs.u16() == rhs.u16());
+      result |= instr.u16().get();
    }
-   return false;
+   return result;
 }
 
 
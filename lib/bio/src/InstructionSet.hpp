@@ -35,6 +35,11 @@
 #include "datatypes/numeric.hpp"
 
 
+namespace algo {
+class CounterRandomGenerator;
+}
+
+
 namespace bio {
 
 
@@ -124,7 +129,10 @@ class Instruction
       static const Desc & descriptor(Opcode opcode);
       static size_t instructionCount();
 
-      Instruction mutated(const MutationParams & params) const;
+      Instruction mutated(
+         const MutationParams & params,
+         algo::CounterRandomGenerator & random
+      ) const;
 
       inline uint8_t cmd() const {return m_cmd;}
       inline dt::Int8 i8() const {return dt::Int8(m_u8);}
@@ -132,6 +140,16 @@ class Instruction
       inline dt::Int16 i16() const {return dt::Int16(m_u16);}
       inline dt::UInt16 u16() const {return dt::UInt16(m_u16);}
 
+      inline bool operator==(const Instruction & other) const
+      {
+         return (m_cmd == other.m_cmd) && (m_u8 == other.m_u8) &&
+            (m_u16 == other.m_u16);
+      }
+      inline bool operator!=(const Instruction & other) const
+      {
+         return !(*this == other);
+      }
+
    private:
       uint8_t m_cmd;
       uint8_t m_u8;
@@ -144,8 +162,14 @@ class InstructionEquals
    public:
       explicit InstructionEquals(boost::shared_ptr<const Config> config);
 
+      inline boost::shared_ptr<const Config> config() const {return m_config;}
+
       bool operator()(const Instruction & lhs, const Instruction & rhs) const;
 
+      // Instructions are equal exactly when their keys are: the opcode in the
+      // high byte followed by the parameters the opcode uses;
+      uint32_t key(const Instruction & instr) const;
+
       std::string toString(const Instruction & instr) const;
 
    private:
@@ -19,6 +19,7 @@
 
 
 #include <cassert>
+#include <vector>
 
 
 #include "mesh/BuddingParams.hpp"
@@ -27,12 +28,27 @@
 
 #include "Cell.hpp"
 #include "Config.hpp"
-#include "GeneInitializer.hpp"
+#include "GeneExpressionTable.hpp"
 #include "Genome.hpp"
 #include "Organism.hpp"
 #include "OrganismDesc.hpp"
 
 
+namespace {
+
+
+// Faces in the order of GeneExpression::buds;
+const dt::TetrahedronFace _budFaces[4] = {
+   dt::TF_ABC,
+   dt::TF_ACD,
+   dt::TF_ADB,
+   dt::TF_BCD
+};
+
+
+} // anonymous namespace;
+
+
 namespace bio {
 
 
@@ -46,23 +62,24 @@ Organism::Organism(
    boost::shared_ptr<const OrganismDesc> desc
 ) : m_mesh(mesh),
    m_desc(desc),
+   m_activeCells(new ActiveCells),
    m_atLeastOneBuddingHasOccured(false),
    m_geneExpressionCount(0),
    m_isFinished(false),
-   m_progress(0)
+   m_progress(0),
+   m_relaxationBudInterval(0),
+   m_budsSinceRelaxation(0)
 {
    assert(m_mesh);
    assert(m_mesh->vertexCount() == 4);
    assert(m_desc);
    assert(m_desc->genome);
 
-   const mesh::Tetrahedron ttr(0, 1, 2, 3);
-   Cell * cell = new Cell(
-      ttr,
+   insertCell(new Cell(
+      mesh::Tetrahedron(0, 1, 2, 3),
       m_desc->initialConditions.x,
       m_desc->initialConditions.y
-   );
-   m_tetrahedronsMap.insert(ttr, cell);
+   ));
 }
 
 
@@ -72,6 +89,12 @@ Organism::~Organism()
 }
 
 
+Organism * Organism::fork() const
+{
+   return new Organism(*this);
+}
+
+
 void Organism::stepOver()
 {
    if (m_isFinished)
@@ -79,64 +102,78 @@ void Organism::stepOver()
       return;
    }
 
+   // Visiting the active cells in the order of the tetrahedrons map gives
+   // the same growth as visiting every cell, as the rest can not bud. Closed
+   // faces would fail anyway, skipping them keeps a step from rescanning the
+   // whole organism;
    bool buddingOccurred = false;
-   const std::vector<Gene> & genes = m_desc->genome->genes();
-   for (const auto & ttrCellPair : m_tetrahedronsMap)
+   const Config & config = *m_desc->genome->config();
+   detach();
+   auto it = m_activeCells->begin();
+   while (it != m_activeCells->end())
    {
-      Cell * activeCell = ttrCellPair.second;
-
-      // Apply genes to the active cell;
-      GeneInitializer init;
-      const Config & config = *m_desc->genome->config();
-      for (const Gene & gene : genes)
+      ActiveCell & activeCell = it->second;
+      uint8_t openFaces = 0;
+      for (size_t i = 0; i < 4; ++i)
       {
-         if (activeCell->doesMeetConditions(gene))
+         const auto & bud = activeCell.expression->buds[i];
+         if (!bud || (activeCell.closedFaces & (1 << i)))
          {
-            for (const Instruction & instr : gene.responses)
-            {
-               init.append(instr, config);
-            }
+            continue;
          }
-      }
 
-      std::pair<dt::TetrahedronFace, const AverageGeneI8x3Param *> avp[4] = {
-         {dt::TF_ABC, &init.abcBud},
-         {dt::TF_ACD, &init.acdBud},
-         {dt::TF_ADB, &init.adbBud},
-         {dt::TF_BCD, &init.bcdBud}
-      };
-      for (size_t i = 0; i < 4; ++i)
-      {
-         if (const auto bud = avp[i].second->value())
+         if (m_tetrahedronsMap.size() >= m_desc->initialConditions.cellLimit)
+         {
+            finish();
+            return;
+         }
+
+         const mesh::BuddingParams bp(
+            _budFaces[i],
+            config.budTopRadius.convert(bud->a),
+            config.budTopPolarAngle.convert(bud->b),
+            config.budTopAzimuthalAngle.convert(bud->c)
+         );
+         if (Cell * budCell = makeCellBud(*activeCell.cell, bp))
+         {
+            insertCell(budCell);
+            buddingOccurred = true;
+            ++m_budsSinceRelaxation;
+         }
+         else if (!m_mesh->isSurfaceFace(
+            activeCell.cell->tetrahedron(),
+            _budFaces[i]
+         ))
          {
-            if (m_tetrahedronsMap.size() >= m_desc->initialConditions.cellLimit)
-            {
-               finish();
-               return;
-            }
-
-            const mesh::BuddingParams bp(
-               avp[i].first,
-               config.budTopRadius.convert(bud->a),
-               config.budTopPolarAngle.convert(bud->b),
-               config.budTopAzimuthalAngle.convert(bud->c)
-            );
-            if (Cell * budCell = makeCellBud(*activeCell, bp))
-            {
-               m_tetrahedronsMap.insert(budCell->tetrahedron(), budCell);
-               buddingOccurred = true;
-            }
+            activeCell.closedFaces |= (1 << i);
+            continue;
          }
+         openFaces |= (1 << i);
       }
 
       if (buddingOccurred)
       {
+         if (m_relaxationParams && m_relaxationBudInterval &&
+            m_budsSinceRelaxation >= m_relaxationBudInterval)
+         {
+            relax();
+         }
+
          const float progress =
             (static_cast<float>(m_tetrahedronsMap.size()) * 100.0f) /
             static_cast<float>(m_desc->initialConditions.cellLimit);
          m_progress = static_cast<uint8_t>(progress);
          break;
       }
+
+      if (openFaces)
+      {
+         ++it;
+      }
+      else
+      {
+         it = m_activeCells->erase(it);
+      }
    }
 
    if (!buddingOccurred)
@@ -151,6 +188,7 @@ bool Organism::makeCellBud(
    dt::TetrahedronFace face
 )
 {
+   detach();
    if (Cell * cell = m_tetrahedronsMap.findAny(t))
    {
       if (const auto cellFace = cell->tetrahedron().relativeFace(t, face))
@@ -158,7 +196,7 @@ bool Organism::makeCellBud(
          Cell * budCell = makeCellBud(*cell, mesh::BuddingParams(*cellFace));
          if (budCell)
          {
-            m_tetrahedronsMap.insert(budCell->tetrahedron(), budCell);
+            insertCell(budCell);
             return true;
          }
       }
@@ -234,13 +272,125 @@ void Organism::resizeEdge(size_t edge, float equilibriumLength)
 }
 
 
+Organism::Organism(const Organism & other)
+   : m_mesh(other.m_mesh->fork()),
+   m_desc(other.m_desc),
+   m_tetrahedronsMap(other.m_tetrahedronsMap),
+   m_activeCells(other.m_activeCells),
+   m_atLeastOneBuddingHasOccured(other.m_atLeastOneBuddingHasOccured),
+   m_geneExpressionCount(other.m_geneExpressionCount),
+   m_isFinished(other.m_isFinished),
+   m_progress(other.m_progress),
+   m_relaxationParams(other.m_relaxationParams),
+   m_relaxationBudInterval(other.m_relaxationBudInterval),
+   m_budsSinceRelaxation(other.m_budsSinceRelaxation),
+   m_relaxationStats(other.m_relaxationStats)
+{
+   assert(m_mesh->structureMods().empty());
+}
+
+
+Organism::ActiveCell::ActiveCell(
+   Cell * cell,
+   const GeneExpression & expression
+) : cell(cell), expression(&expression), closedFaces(0)
+{
+}
+
+
+void Organism::setRelaxation(
+   const boost::optional<mesh::RelaxationParams> & params,
+   size_t budInterval
+)
+{
+   m_relaxationParams = params;
+   m_relaxationBudInterval = budInterval;
+}
+
+
+void Organism::detach()
+{
+   // Active cells point to the cells, so they follow the map;
+   if (m_tetrahedronsMap.detach())
+   {
+      const TetrahedronsMap & map = m_tetrahedronsMap;
+      boost::shared_ptr<ActiveCells> activeCells(
+         new ActiveCells(*m_activeCells)
+      );
+      for (auto & ttrActiveCellPair : *activeCells)
+      {
+         const auto it = map.find(ttrActiveCellPair.first);
+         assert(it != map.end());
+         ttrActiveCellPair.second.cell = it->second;
+      }
+      m_activeCells.swap(activeCells);
+   }
+   else if (!m_activeCells.unique())
+   {
+      m_activeCells.reset(new ActiveCells(*m_activeCells));
+   }
+}
+
+
 void Organism::finish()
 {
+   if (m_relaxationParams)
+   {
+      relax();
+   }
    m_isFinished = true;
    m_progress = 100;
 }
 
 
+void Organism::relax()
+{
+   assert(m_relaxationParams);
+   m_relaxationStats += m_mesh->relax(*m_relaxationParams);
+   m_budsSinceRelaxation = 0;
+}
+
+
+void Organism::insertCell(Cell * cell)
+{
+   m_tetrahedronsMap.insert(cell->tetrahedron(), cell);
+
+   const GeneExpression & expression = m_desc->genome->expression(*cell);
+   if (expression.hasBud())
+   {
+      m_activeCells->insert(
+         std::make_pair(cell->tetrahedron(), ActiveCell(cell, expression))
+      );
+   }
+}
+
+
+void Organism::rekeyActiveCells(size_t vertexIndex)
+{
+   std::vector<ActiveCell> rekeyed;
+   auto it = m_activeCells->begin();
+   while (it != m_activeCells->end())
+   {
+      if (it->first.contains(vertexIndex))
+      {
+         rekeyed.push_back(it->second);
+         it = m_activeCells->erase(it);
+      }
+      else
+      {
+         ++it;
+      }
+   }
+
+   for (const ActiveCell & activeCell : rekeyed)
+   {
+      m_activeCells->insert(
+         std::make_pair(activeCell.cell->tetrahedron(), activeCell)
+      );
+   }
+}
+
+
 Cell * Organism::makeCellBud(Cell & cell, const mesh::BuddingParams & params)
 {
    const mesh::Tetrahedron t = cell.tetrahedron();
@@ -289,6 +439,7 @@ std::vector<AdjacentCell> Organism::adjacentCells(
 
 void Organism::applyStructureModifications()
 {
+   detach();
    const mesh::StructureModification & structureMods = m_mesh->structureMods();
    mesh::StructureModification::const_iterator it = structureMods.begin();
    mesh::StructureModification::const_iterator ite = structureMods.end();
@@ -298,6 +449,7 @@ void Organism::applyStructureModifications()
       {
          case mesh::StructureModification::T_VERTEX_MOVE:
             m_tetrahedronsMap.replaceVertexIndex(it->oldIndex, it->newIndex);
+            rekeyActiveCells(it->oldIndex);
             break;
       }
    }
@@ -23,6 +23,7 @@
 
 
 #include <cstdint>
+#include <map>
 
 
 #include <boost/optional.hpp>
@@ -30,6 +31,7 @@
 
 
 #include "datatypes/mesh.hpp"
+#include "mesh/Relaxation.hpp"
 #include "mesh/Tetrahedron.hpp"
 
 
@@ -47,6 +49,7 @@ namespace bio {
 
 class Cell;
 struct AdjacentCell;
+struct GeneExpression;
 struct OrganismDesc;
 
 
@@ -64,6 +67,12 @@ class Organism
       );
       virtual ~Organism();
 
+      // The fork continues from the current state on its own, the mesh
+      // and the cells are shared until either organism changes them;
+      Organism * fork() const;
+
+      // Stored figures are keyed by DEVELOPMENT_VERSION, a change to what
+      // the steps grow has to bump it;
       void stepOver();
 
       bool makeCellBud(const mesh::Tetrahedron & t, dt::TetrahedronFace face);
@@ -79,14 +88,47 @@ class Organism
       boost::optional<mesh::Tetrahedron> selectedCell() const;
       void resizeEdge(size_t edge, float equilibriumLength);
 
+      // The mesh is relaxed once the development is over and, given a bud
+      // interval, after every that many buds;
+      void setRelaxation(
+         const boost::optional<mesh::RelaxationParams> & params,
+         size_t budInterval = 0
+      );
+      inline const mesh::RelaxationStats & relaxationStats() const;
+
       inline bool isFinished() const {return m_isFinished;}
       inline uint8_t progress() const {return m_progress;}
+      // Cells that may still bud, see ActiveCell;
+      inline size_t activeCellCount() const;
 
       inline const mesh::Mesh & mesh() const;
       inline const TetrahedronsMap & tetrahedronsMap() const;
 
    private:
+      // Gene expression depends only on the generation and coordinates of a
+      // cell, which never change, so it is looked up once per cell. Cells
+      // without any bud response can never bud and are kept out of the
+      // active cells. A bud face that has left the surface is closed for
+      // good, a cell is dropped once all of its bud faces are closed;
+      struct ActiveCell
+      {
+         explicit ActiveCell(Cell * cell, const GeneExpression & expression);
+
+         Cell * cell;
+         const GeneExpression * expression;
+         uint8_t closedFaces;
+      };
+      typedef std::map<mesh::Tetrahedron, ActiveCell> ActiveCells;
+
+      Organism(const Organism & other);
+      Organism & operator=(const Organism & other);
+
+      // Called before the cells are changed, see TetrahedronsMap::detach();
+      void detach();
       void finish();
+      void relax();
+      void insertCell(Cell * cell);
+      void rekeyActiveCells(size_t vertexIndex);
       Cell * makeCellBud(Cell & cell, const mesh::BuddingParams & params);
       std::vector<AdjacentCell> adjacentCells(
          const mesh::Tetrahedron & t
@@ -96,13 +138,30 @@ class Organism
       mesh::Mesh * m_mesh;
       boost::shared_ptr<const OrganismDesc> m_desc;
       TetrahedronsMap m_tetrahedronsMap;
+      boost::shared_ptr<ActiveCells> m_activeCells;
       bool m_atLeastOneBuddingHasOccured;
       int32_t m_geneExpressionCount;
       bool m_isFinished;
       uint8_t m_progress;
+      boost::optional<mesh::RelaxationParams> m_relaxationParams;
+      size_t m_relaxationBudInterval;
+      size_t m_budsSinceRelaxation;
+      mesh::RelaxationStats m_relaxationStats;
 };
 
 
+inline size_t Organism::activeCellCount() const
+{
+   return m_activeCells->size();
+}
+
+
+inline const mesh::RelaxationStats & Organism::relaxationStats() const
+{
+   return m_relaxationStats;
+}
+
+
 inline const mesh::Mesh & Organism::mesh() const
 {
    return *m_mesh;
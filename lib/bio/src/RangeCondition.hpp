@@ -50,6 +50,7 @@ class RangeCondition
       bool isAcceptable(const T & value) const;
       bool isAlwaysAcceptable() const;
       std::string toString() const;
+      bool operator==(const RangeCondition & other) const;
       inline boost::optional<T> greaterOrEqual() const {return m_greaterOrEqual;}
       inline boost::optional<T> lessOrEqual() const {return m_lessOrEqual;}
 
@@ -113,6 +114,14 @@ bool RangeCondition<T>::isAlwaysAcceptable() const
 }
 
 
+template <typename T>
+bool RangeCondition<T>::operator==(const RangeCondition & other) const
+{
+   return (m_greaterOrEqual == other.m_greaterOrEqual) &&
+      (m_lessOrEqual == other.m_lessOrEqual);
+}
+
+
 template <typename T>
 std::string RangeCondition<T>::toString() const
 {
@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <algorithm>
+#include <functional>
+
+
+#include "SimilarityCache.hpp"
+
+
+namespace bio {
+
+
+/***************************************************************************
+ *   SimilarityCache class implementation                                  *
+ ***************************************************************************/
+
+
+SimilarityCache::SimilarityCache(size_t capacity)
+   : m_entries(capacity), m_hitCount(0), m_missCount(0)
+{
+}
+
+
+SimilarityCache::~SimilarityCache()
+{
+}
+
+
+SimilarityCache & SimilarityCache::instance()
+{
+   static SimilarityCache cache;
+   return cache;
+}
+
+
+boost::optional<float> SimilarityCache::find(
+   uint64_t lhsHash,
+   uint64_t rhsHash,
+   float threshold
+)
+{
+   const Key key(lhsHash, rhsHash, threshold);
+   std::lock_guard<std::mutex> lock(m_mutex);
+   const boost::optional<float> similarity = m_entries.find(key);
+   if (similarity)
+   {
+      ++m_hitCount;
+   }
+   else
+   {
+      ++m_missCount;
+   }
+   return similarity;
+}
+
+
+void SimilarityCache::insert(
+   uint64_t lhsHash,
+   uint64_t rhsHash,
+   float threshold,
+   float similarity
+)
+{
+   // Another thread could have got ahead, its result is the same;
+   const Key key(lhsHash, rhsHash, threshold);
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_entries.insert(key, similarity, 1);
+}
+
+
+void SimilarityCache::clear()
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_entries.clear();
+   m_hitCount = 0;
+   m_missCount = 0;
+}
+
+
+size_t SimilarityCache::capacity() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_entries.budget();
+}
+
+
+void SimilarityCache::setCapacity(size_t capacity)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_entries.setBudget(capacity);
+}
+
+
+size_t SimilarityCache::size() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_entries.size();
+}
+
+
+uint64_t SimilarityCache::hitCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_hitCount;
+}
+
+
+uint64_t SimilarityCache::missCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_missCount;
+}
+
+
+SimilarityCache::Key::Key(
+   uint64_t lhsHash,
+   uint64_t rhsHash,
+   float threshold
+) : lhsHash(std::min(lhsHash, rhsHash)),
+   rhsHash(std::max(lhsHash, rhsHash)),
+   threshold(threshold)
+{
+}
+
+
+bool SimilarityCache::Key::operator==(const Key & other) const
+{
+   return lhsHash == other.lhsHash && rhsHash == other.rhsHash &&
+      threshold == other.threshold;
+}
+
+
+size_t SimilarityCache::KeyHash::operator()(const Key & key) const
+{
+   // Hashes of the keys are well mixed already;
+   return static_cast<size_t>(
+      key.lhsHash ^ (key.rhsHash * 0x9e3779b97f4a7c15ull) ^
+      std::hash<float>()(key.threshold)
+   );
+}
+
+
+}
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#ifndef BIO_SIMILARITYCACHE_HPP
+#define BIO_SIMILARITYCACHE_HPP
+
+
+#include <cstdint>
+#include <mutex>
+
+
+#include <boost/optional.hpp>
+
+
+#include "algo/LruCache.hpp"
+
+
+namespace bio {
+
+
+/***************************************************************************
+ *   SimilarityCache class declaration                                     *
+ ***************************************************************************/
+
+
+// Memoises similarities of chromosome pairs across genomes. Most chromosomes
+// are passed to offspring unchanged, so they are compared with the same
+// homologs generation after generation. Pairs are keyed by the hashes of the
+// chromosome keys, which already depend on the config, and by the threshold
+// of the comparison; the order of the chromosomes does not matter. The cache
+// is thread-safe and holds up to its capacity of pairs, the least recently
+// used ones are dropped first;
+class SimilarityCache
+{
+   public:
+      explicit SimilarityCache(size_t capacity = 1 << 18);
+      virtual ~SimilarityCache();
+
+      // The cache shared by all genomes;
+      static SimilarityCache & instance();
+
+      boost::optional<float> find(
+         uint64_t lhsHash,
+         uint64_t rhsHash,
+         float threshold
+      );
+      void insert(
+         uint64_t lhsHash,
+         uint64_t rhsHash,
+         float threshold,
+         float similarity
+      );
+
+      // Drops all pairs and resets the counts;
+      void clear();
+
+      size_t capacity() const;
+      void setCapacity(size_t capacity);
+
+      size_t size() const;
+      uint64_t hitCount() const;
+      uint64_t missCount() const;
+
+   private:
+      struct Key
+      {
+         explicit Key(uint64_t lhsHash, uint64_t rhsHash, float threshold);
+         bool operator==(const Key & other) const;
+
+         uint64_t lhsHash;
+         uint64_t rhsHash;
+         float threshold;
+      };
+
+      struct KeyHash
+      {
+         size_t operator()(const Key & key) const;
+      };
+
+      mutable std::mutex m_mutex;
+      algo::LruCache<Key, float, KeyHash> m_entries; // Each pair costs one;
+      uint64_t m_hitCount;
+      uint64_t m_missCount;
+};
+
+
+}
+
+
+#endif
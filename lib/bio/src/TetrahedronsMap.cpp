@@ -30,12 +30,19 @@ namespace bio {
  ***************************************************************************/
 
 
+TetrahedronsMap::TetrahedronsMap() : m_storage(new Storage)
+{
+}
+
+
+TetrahedronsMap::TetrahedronsMap(const TetrahedronsMap & other)
+   : m_storage(other.m_storage)
+{
+}
+
+
 TetrahedronsMap::~TetrahedronsMap()
 {
-   for (iterator it = m_map.begin(), ite = m_map.end(); it != ite; ++it)
-   {
-      delete it->second;
-   }
 }
 
 
@@ -43,10 +50,10 @@ Cell * TetrahedronsMap::findAny(const mesh::Tetrahedron & t) const
 {
    for (int i = mesh::Tetrahedron::C_FIRST; i <= mesh::Tetrahedron::C_LAST; ++i)
    {
-      const_iterator it = m_map.find(t.combination(
+      const_iterator it = m_storage->map.find(t.combination(
          static_cast<mesh::Tetrahedron::COMBINATION>(i)
       ));
-      if (it != m_map.end())
+      if (it != m_storage->map.end())
       {
          return it->second;
       }
@@ -58,21 +65,25 @@ Cell * TetrahedronsMap::findAny(const mesh::Tetrahedron & t) const
 
 void TetrahedronsMap::remove(const mesh::Tetrahedron & t)
 {
-   iterator it = m_map.find(t);
-   if (it != m_map.end())
+   detach();
+   std::map<mesh::Tetrahedron, Cell *> & map = m_storage->map;
+   iterator it = map.find(t);
+   if (it != map.end())
    {
       delete it->second;
-      m_map.erase(it);
+      map.erase(it);
    }
 }
 
 
 void TetrahedronsMap::replaceVertexIndex(size_t oldIndex, size_t newIndex)
 {
+   detach();
+   std::map<mesh::Tetrahedron, Cell *> & map = m_storage->map;
    std::map<mesh::Tetrahedron, Cell *> tmp;
 
-   iterator it = m_map.begin();
-   while (it != m_map.end())
+   iterator it = map.begin();
+   while (it != map.end())
    {
       assert(!it->first.contains(newIndex));
       if (it->first.contains(oldIndex))
@@ -80,7 +91,7 @@ void TetrahedronsMap::replaceVertexIndex(size_t oldIndex, size_t newIndex)
          const mesh::Tetrahedron ttr = it->first.replaced(oldIndex, newIndex);
          tmp.insert(std::pair<mesh::Tetrahedron, Cell *>(ttr, it->second));
          it->second->setTetrahedron(ttr);
-         it = m_map.erase(it);
+         it = map.erase(it);
       }
       else
       {
@@ -91,7 +102,38 @@ void TetrahedronsMap::replaceVertexIndex(size_t oldIndex, size_t newIndex)
    it = tmp.begin();
    for (iterator ite = tmp.end(); it != ite; ++it)
    {
-      m_map.insert(*it);
+      map.insert(*it);
+   }
+}
+
+
+bool TetrahedronsMap::detach()
+{
+   if (m_storage.unique())
+   {
+      return false;
+   }
+
+   boost::shared_ptr<Storage> storage(new Storage);
+   const_iterator it = m_storage->map.begin();
+   const_iterator ite = m_storage->map.end();
+   for (; it != ite; ++it)
+   {
+      storage->map.insert(
+         storage->map.end(),
+         std::make_pair(it->first, new Cell(*it->second))
+      );
+   }
+   m_storage.swap(storage);
+   return true;
+}
+
+
+TetrahedronsMap::Storage::~Storage()
+{
+   for (iterator it = map.begin(), ite = map.end(); it != ite; ++it)
+   {
+      delete it->second;
    }
 }
 
@@ -28,6 +28,7 @@
 
 
 #include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
 
 
 #include "mesh/Tetrahedron.hpp"
@@ -50,56 +51,76 @@ class TetrahedronsMap
       typedef std::map<mesh::Tetrahedron, Cell *>::const_iterator const_iterator;
       typedef std::map<mesh::Tetrahedron, Cell *>::iterator iterator;
 
+      explicit TetrahedronsMap();
+      // The copy shares the cells until either of the maps is changed;
+      TetrahedronsMap(const TetrahedronsMap & other);
       virtual ~TetrahedronsMap();
 
       inline const_iterator begin() const
       {
-         return m_map.begin();
+         return m_storage->map.begin();
       }
 
       inline iterator begin()
       {
-         return m_map.begin();
+         detach();
+         return m_storage->map.begin();
       }
 
       inline const_iterator end() const
       {
-         return m_map.end();
+         return m_storage->map.end();
       }
 
       inline iterator end()
       {
-         return m_map.end();
+         detach();
+         return m_storage->map.end();
       }
 
       inline bool empty() const
       {
-         return m_map.empty();
+         return m_storage->map.empty();
       }
 
       inline size_t size() const
       {
-         return m_map.size();
+         return m_storage->map.size();
       }
 
       inline const_iterator find(const mesh::Tetrahedron & t) const
       {
-         return m_map.find(t);
+         return m_storage->map.find(t);
       }
 
       Cell * findAny(const mesh::Tetrahedron & t) const;
 
       inline void insert(const mesh::Tetrahedron & t, Cell * cell)
       {
-         m_map.insert(std::pair<mesh::Tetrahedron, Cell *>(t, cell));
+         detach();
+         m_storage->map.insert(std::pair<mesh::Tetrahedron, Cell *>(t, cell));
       }
 
       void remove(const mesh::Tetrahedron & t);
 
       void replaceVertexIndex(size_t oldIndex, size_t newIndex);
 
-    private:
-        std::map<mesh::Tetrahedron, Cell *> m_map;
+      // Gives the map copies of the cells it shares, which every change
+      // does first. Returns whether the cells have been copied, pointers
+      // to them taken earlier are stale then;
+      bool detach();
+
+   private:
+      struct Storage
+      {
+         ~Storage();
+
+         std::map<mesh::Tetrahedron, Cell *> map;
+      };
+
+      TetrahedronsMap & operator=(const TetrahedronsMap & other);
+
+      boost::shared_ptr<Storage> m_storage;
 };
 
 
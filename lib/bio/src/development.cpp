@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <cstring>
+#include <vector>
+
+
+#include "algo/Hasher.hpp"
+
+
+#include "Config.hpp"
+#include "development.hpp"
+#include "Genome.hpp"
+#include "OrganismDesc.hpp"
+
+
+namespace {
+
+
+void _hash(algo::Hasher & hasher, float value)
+{
+   uint32_t bits = 0;
+   memcpy(&bits, &value, sizeof(bits));
+   hasher.add(bits);
+}
+
+
+void _hash(algo::Hasher & hasher, const bio::Configurable & configurable)
+{
+   // Conversions are linear, both ends of the range pin them down;
+   _hash(hasher, configurable.convert(dt::UInt16(0)));
+   _hash(hasher, configurable.convert(dt::UInt16(0xffff)));
+}
+
+
+} // anonymous namespace;
+
+
+namespace bio {
+
+
+uint64_t developmentKey(
+   const OrganismDesc & desc,
+   int backend,
+   const boost::optional<mesh::RelaxationParams> & relaxation,
+   size_t relaxationBudInterval
+)
+{
+   algo::Hasher hasher(DEVELOPMENT_VERSION);
+   hasher.add(backend);
+
+   if (relaxation)
+   {
+      hasher.add(relaxation->maxIterations);
+      hasher.add(relaxation->batchSize);
+      _hash(hasher, relaxation->maxKineticEnergy);
+      _hash(hasher, relaxation->maxDisplacement);
+      hasher.add(relaxationBudInterval);
+   }
+   else
+   {
+      hasher.add(0);
+   }
+
+   const InitialConditions & ic = desc.initialConditions;
+   hasher.add(ic.cellLimit);
+   hasher.add(static_cast<uint16_t>(ic.x));
+   hasher.add(static_cast<uint16_t>(ic.y));
+
+   const Config & config = *desc.genome->config();
+   _hash(hasher, config.budTopRadius);
+   _hash(hasher, config.budTopPolarAngle);
+   _hash(hasher, config.budTopAzimuthalAngle);
+   for (Opcode opcode : config.opcodeArray)
+   {
+      hasher.add(opcode);
+   }
+
+   const std::vector<Gene> & genes = desc.genome->genes();
+   const std::vector<uint32_t> & weights = desc.genome->geneWeights();
+   hasher.add(genes.size());
+   for (size_t i = 0; i < genes.size(); ++i)
+   {
+      hasher.add(genes[i].hash());
+      hasher.add(weights[i]);
+   }
+
+   return hasher.value();
+}
+
+
+}
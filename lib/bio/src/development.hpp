@@ -0,0 +1,64 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#ifndef BIO_DEVELOPMENT_HPP
+#define BIO_DEVELOPMENT_HPP
+
+
+#include <cstdint>
+#include <cstdlib>
+
+
+#include <boost/optional.hpp>
+
+
+#include "mesh/Relaxation.hpp"
+
+
+namespace bio {
+
+
+struct OrganismDesc;
+
+
+// Version of the development, a part of every development key. Figures are
+// stored under the keys across sessions, so any change that grows another
+// figure from the same desc has to bump it: growth and gene expression of
+// Organism, budding and relaxation of the mesh, the initial mesh. The growth
+// of a fixed desc is pinned for the current version by test_growthOrder;
+#define DEVELOPMENT_VERSION 1
+
+
+// Hash of everything the figure of an organism depends on: the desc with
+// the genes of its genome and their weights, the config, the relaxation and
+// the development backend, as meshes of the backends differ slightly. Genes
+// are taken in order, as the genome evaluates them;
+uint64_t developmentKey(
+   const OrganismDesc & desc,
+   int backend,
+   const boost::optional<mesh::RelaxationParams> & relaxation,
+   size_t relaxationBudInterval
+);
+
+
+}
+
+
+#endif
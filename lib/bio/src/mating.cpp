@@ -18,7 +18,9 @@
  ***************************************************************************/
 
 
+#include <atomic>
 #include <cassert>
+#include <thread>
 
 
 #include "Genome.hpp"
@@ -53,6 +55,8 @@ void _init(
    bio::OrganismDesc & desc,
    boost::shared_ptr<const bio::Config> config,
    const bio::MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random,
+   size_t threadCount,
    const bio::OrganismDesc & left,
    const bio::OrganismDesc & right
 )
@@ -60,13 +64,18 @@ void _init(
    desc.initialConditions = bio::InitialConditions(
       left.initialConditions,
       right.initialConditions,
-      mutationParams
+      mutationParams,
+      random
+   );
+   // Arguments are evaluated in any order, haploids are made in sequence to
+   // draw the same values on every compiler;
+   std::vector<bio::Chromosome> leftHaploid =
+      left.genome->makeHaploid(mutationParams, random);
+   std::vector<bio::Chromosome> rightHaploid =
+      right.genome->makeHaploid(mutationParams, random);
+   desc.genome.reset(
+      new bio::Genome(config, leftHaploid, rightHaploid, threadCount)
    );
-   desc.genome.reset(new bio::Genome(
-      config,
-      left.genome->makeHaploid(mutationParams),
-      right.genome->makeHaploid(mutationParams)
-   ));
 }
 
 
@@ -74,16 +83,55 @@ void _init(
    bio::OrganismDesc & desc,
    boost::shared_ptr<const bio::Config> config,
    const bio::MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random,
+   size_t threadCount,
    const bio::OrganismDesc & left
 )
 {
    desc.initialConditions = left.initialConditions;
-   desc.initialConditions.applyMutations(mutationParams);
-   desc.genome.reset(new bio::Genome(
-      config,
-      left.genome->makeHaploid(mutationParams),
-      left.genome->makeHaploid(mutationParams) // FIXME:;
-   ));
+   desc.initialConditions.applyMutations(mutationParams, random);
+   std::vector<bio::Chromosome> leftHaploid =
+      left.genome->makeHaploid(mutationParams, random);
+   std::vector<bio::Chromosome> rightHaploid =
+      left.genome->makeHaploid(mutationParams, random); // FIXME:;
+   desc.genome.reset(
+      new bio::Genome(config, leftHaploid, rightHaploid, threadCount)
+   );
+}
+
+
+// Calls process for every index on the given number of threads. Workers
+// take the next index as they become free, since offspring of large genomes
+// take much longer to make than others;
+template <typename Process>
+void _forEachIndex(size_t count, size_t threadCount, Process process)
+{
+   if (threadCount == 1)
+   {
+      for (size_t i = 0; i < count; ++i)
+      {
+         process(i);
+      }
+   }
+   else
+   {
+      std::atomic<size_t> next(0);
+      std::vector<std::thread> threads;
+      threads.reserve(threadCount);
+      for (size_t t = 0; t < threadCount; ++t)
+      {
+         threads.push_back(std::thread([&]() {
+            for (size_t i = next++; i < count; i = next++)
+            {
+               process(i);
+            }
+         }));
+      }
+      for (std::thread & thread : threads)
+      {
+         thread.join();
+      }
+   }
 }
 
 
@@ -141,53 +189,82 @@ std::vector<boost::shared_ptr<OrganismDesc> > mate(
    OrganismDesc *(* createDesc)(),
    size_t nextGenerationSize,
    boost::shared_ptr<const Config> config,
-   const MutationParams & mutationParams
+   const MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random,
+   size_t threadCount
 )
 {
    assert(createDesc);
    const size_t prevGenerationSize = prevGeneration.size();
    std::vector<boost::shared_ptr<OrganismDesc> > nextGeneration;
-   if (nextGenerationSize)
+   if (nextGenerationSize && prevGenerationSize)
    {
-      nextGeneration.reserve(nextGenerationSize);
+      std::vector<std::pair<size_t, size_t> > pairs;
       if (prevGenerationSize > 1)
       {
-         const std::vector<std::pair<size_t, size_t> > pairs = std::move(
+         pairs = std::move(
             mate(
                prevGenerationSize,
                nextGenerationSize,
-               algo::UniformNormalizedFloatRandomGenerator()
+               algo::UniformNormalizedFloatRandomGenerator(random)
             )
          );
          assert(pairs.size() == nextGenerationSize);
+      }
+      const algo::CounterRandomGenerator streams(random.generate64());
+
+      // Descs are created up front, createDesc is not required to be safe
+      // to call concurrently;
+      nextGeneration.reserve(nextGenerationSize);
+      for (size_t i = 0; i < nextGenerationSize; ++i)
+      {
+         OrganismDesc * desc = createDesc();
+         assert(desc);
+         nextGeneration.push_back(boost::shared_ptr<OrganismDesc>(desc));
+      }
 
-         for (const std::pair<size_t, size_t> & pair : pairs)
+      if (!threadCount)
+      {
+         threadCount = std::thread::hardware_concurrency();
+      }
+      threadCount = std::max<size_t>(
+         std::min(threadCount, nextGenerationSize),
+         1
+      );
+      // Offspring already keep every worker busy, genomes are paired on the
+      // worker that makes them;
+      const size_t pairingThreadCount = (threadCount > 1) ? 1 : 0;
+
+      _forEachIndex(nextGenerationSize, threadCount, [&](size_t i) {
+         algo::CounterRandomGenerator offspringRandom = streams.stream(i);
+         if (pairs.empty())
          {
+            _init(
+               *nextGeneration[i],
+               config,
+               mutationParams,
+               offspringRandom,
+               pairingThreadCount,
+               *prevGeneration.front()
+            );
+         }
+         else
+         {
+            const std::pair<size_t, size_t> & pair = pairs[i];
             assert(pair.first < prevGenerationSize);
             assert(pair.second < prevGenerationSize);
             assert(pair.first != pair.second);
-            OrganismDesc * desc = createDesc();
-            assert(desc);
             _init(
-               *desc,
+               *nextGeneration[i],
                config,
                mutationParams,
+               offspringRandom,
+               pairingThreadCount,
                *prevGeneration[pair.first],
                *prevGeneration[pair.second]
             );
-            nextGeneration.push_back(boost::shared_ptr<OrganismDesc>(desc));
          }
-      }
-      else if (prevGenerationSize == 1)
-      {
-         for (size_t i = 0; i < nextGenerationSize; ++i)
-         {
-            OrganismDesc * desc = createDesc();
-            assert(desc);
-            _init(*desc, config, mutationParams, *prevGeneration.front());
-            nextGeneration.push_back(boost::shared_ptr<OrganismDesc>(desc));
-         }
-      }
+      });
    }
    return nextGeneration;
 }
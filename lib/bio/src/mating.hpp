@@ -30,6 +30,7 @@
 
 
 namespace algo {
+class CounterRandomGenerator;
 class UniformNormalizedFloatRandomGenerator;
 }
 
@@ -54,12 +55,20 @@ std::vector<std::pair<size_t, size_t> > mate(
 );
 
 
+// Parents are chosen with the generator, then every offspring gets a stream
+// of its own, derived from the next value of the generator and the index of
+// the offspring. The same generator state gives the same generation, on any
+// number of threads. Offspring are made on the given number of threads, zero
+// means as many as the hardware runs, and are returned in order. Parents
+// and config must not be changed meanwhile;
 std::vector<boost::shared_ptr<OrganismDesc> > mate(
    const std::vector<boost::shared_ptr<const OrganismDesc> > & prevGeneration,
    OrganismDesc *(* createDesc)(),
    size_t nextGenerationSize,
    boost::shared_ptr<const Config> config,
-   const MutationParams & mutationParams
+   const MutationParams & mutationParams,
+   algo::CounterRandomGenerator & random,
+   size_t threadCount = 0
 );
 
 
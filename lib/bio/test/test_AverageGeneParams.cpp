@@ -83,4 +83,37 @@ BOOST_AUTO_TEST_CASE(test_add)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_merge)
+{
+   {
+      AverageGeneI16Param p;
+      p.add(dt::Int16(4000));
+      p.add_nop();
+      AverageGeneI16Param q;
+      q.add(dt::Int16(-8000));
+      q.add_nop();
+      q.add_nop();
+      p.merge(q);
+      BOOST_REQUIRE(!p.value());
+      p.add(dt::Int16(13000));
+      BOOST_REQUIRE(p.value() == dt::Int16(3000));
+   }
+
+   {
+      AverageGeneI8x3Param p;
+      p.add(I8x3GeneParam(dt::Int8(10), dt::Int8(-20), dt::Int8(30)));
+      AverageGeneI8x3Param q;
+      q.add(I8x3GeneParam(dt::Int8(-5), dt::Int8(-7), dt::Int8(1)));
+      q.add_nop();
+      p.merge(q);
+      BOOST_REQUIRE(p.nopCount() == 1);
+      const boost::optional<I8x3GeneParam> v = p.value();
+      BOOST_REQUIRE(v);
+      BOOST_REQUIRE(v->a == dt::Int8(2));
+      BOOST_REQUIRE(v->b == dt::Int8(-13));
+      BOOST_REQUIRE(v->c == dt::Int8(15));
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,264 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <cmath>
+#include <cstdlib>
+#include <map>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Chromosome.hpp"
+#include "Config.hpp"
+#include "MutationParams.hpp"
+
+
+#include "algo/random_generators.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+Chromosome _randomChromosome(size_t size)
+{
+   std::vector<Instruction> code;
+   for (size_t i = 0; i < size; ++i)
+   {
+      code.push_back(Instruction(rand() % 256, rand() % 256, rand() % 65536));
+   }
+   return Chromosome(code);
+}
+
+
+void _requireKeys(const Chromosome & chromosome, const InstructionEquals & eq)
+{
+   const std::vector<uint32_t> & keys = chromosome.keys(eq);
+   const std::vector<Instruction> & code = chromosome.code();
+   BOOST_REQUIRE(keys.size() == code.size());
+   for (size_t i = 0; i < code.size(); ++i)
+   {
+      BOOST_REQUIRE(keys[i] == eq.key(code[i]));
+   }
+}
+
+
+bool _same(const Instruction & lhs, const Instruction & rhs)
+{
+   return (lhs.cmd() == rhs.cmd()) && (lhs.u8() == rhs.u8()) &&
+      (lhs.u16() == rhs.u16());
+}
+
+
+// Every count comes from the given number of independent trials, passing
+// with the probability. Counts are required to be within five standard
+// deviations, and their sum within four;
+void _requireBinomial(
+   const std::vector<size_t> & counts,
+   size_t trials,
+   double p
+)
+{
+   const double mean = trials * p;
+   const double deviation = std::sqrt(trials * p * (1.0 - p));
+   double sum = 0.0;
+   for (size_t count : counts)
+   {
+      BOOST_REQUIRE(std::abs(count - mean) < 5.0 * deviation);
+      sum += count;
+   }
+   BOOST_REQUIRE(
+      std::abs(sum - counts.size() * mean) <
+      4.0 * deviation * std::sqrt(double(counts.size()))
+   );
+}
+
+}
+
+
+/***************************************************************************
+ *   Chromosome class test                                                 *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_Chromosome)
+
+
+BOOST_AUTO_TEST_CASE(test_keys)
+{
+   srand(1);
+   const boost::shared_ptr<const Config> config(new Config());
+   const InstructionEquals equals(config);
+   Chromosome chromosome = _randomChromosome(100);
+   _requireKeys(chromosome, equals);
+   BOOST_REQUIRE(&chromosome.keys(equals) == &chromosome.keys(equals));
+
+   // Another config maps commands to other opcodes;
+   const Config & defaults = *config;
+   const boost::shared_ptr<const Config> nopConfig(new Config(
+      defaults.budTopRadius,
+      defaults.budTopPolarAngle,
+      defaults.budTopAzimuthalAngle,
+      std::map<Opcode, uint8_t>({{OP_NOP, 1}})
+   ));
+   const InstructionEquals nopEquals(nopConfig);
+   const std::vector<uint32_t> keys = chromosome.keys(equals);
+   const uint64_t hash = chromosome.keysHash(equals);
+   _requireKeys(chromosome, nopEquals);
+   BOOST_REQUIRE(chromosome.keys(nopEquals) != keys);
+   BOOST_REQUIRE(chromosome.keysHash(nopEquals) != hash);
+   _requireKeys(chromosome, equals);
+   BOOST_REQUIRE(chromosome.keysHash(equals) == hash);
+
+   // Copies keep the keys, mutations renew them;
+   const Chromosome copy(chromosome);
+   _requireKeys(copy, equals);
+   BOOST_REQUIRE(copy.keysHash(equals) == hash);
+   BOOST_REQUIRE(Chromosome(chromosome.code()).keysHash(equals) == hash);
+   algo::CounterRandomGenerator random(1);
+   chromosome.applyMutations(MutationParams::high(), random);
+   _requireKeys(chromosome, equals);
+   BOOST_REQUIRE(chromosome.keysHash(equals) != hash);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_mutationDistribution)
+{
+   // Instructions are told apart by all of their fields, the u8 of a mutated
+   // one is zero;
+   const size_t size = 64;
+   std::vector<Instruction> code;
+   for (size_t i = 0; i < size; ++i)
+   {
+      code.push_back(Instruction(i, 1 + i, 1000 + i));
+   }
+   const Chromosome original(code);
+   const size_t trials = 4000;
+   algo::CounterRandomGenerator random(7);
+
+   // Failed trials are skipped, whether they are rare or frequent;
+   for (float p : {0.05f, 0.6f})
+   {
+      // Every instruction is deleted with its own trial;
+      MutationParams deletion;
+      deletion.instructionDeletion = algo::Probability(p);
+      std::vector<size_t> deleted(size, 0);
+      for (size_t t = 0; t < trials; ++t)
+      {
+         Chromosome chromosome(original);
+         chromosome.applyMutations(deletion, random);
+         const std::vector<Instruction> & result = chromosome.code();
+         for (size_t i = 0, j = 0; i < size; ++i)
+         {
+            if (j < result.size() && _same(result[j], code[i]))
+            {
+               ++j;
+            }
+            else
+            {
+               ++deleted[i];
+            }
+         }
+      }
+      _requireBinomial(deleted, trials, p);
+
+      // Insertions are tried before every instruction and after the last
+      // one;
+      MutationParams insertion;
+      insertion.instructionInsertion = algo::Probability(p);
+      std::vector<size_t> inserted(size + 1, 0);
+      for (size_t t = 0; t < trials; ++t)
+      {
+         Chromosome chromosome(original);
+         chromosome.applyMutations(insertion, random);
+         size_t j = 0;
+         for (const Instruction & instr : chromosome.code())
+         {
+            if (j < size && _same(instr, code[j]))
+            {
+               ++j;
+            }
+            else
+            {
+               ++inserted[j];
+            }
+         }
+         BOOST_REQUIRE(j == size);
+      }
+      _requireBinomial(inserted, trials, p);
+
+      // Mutations keep the instructions where they are;
+      MutationParams mutation;
+      mutation.instructionMutation = algo::Probability(p);
+      mutation.maxInstructionBitFlips = 1;
+      std::vector<size_t> mutated(size, 0);
+      for (size_t t = 0; t < trials; ++t)
+      {
+         Chromosome chromosome(original);
+         chromosome.applyMutations(mutation, random);
+         const std::vector<Instruction> & result = chromosome.code();
+         BOOST_REQUIRE(result.size() == size);
+         for (size_t i = 0; i < size; ++i)
+         {
+            mutated[i] += !_same(result[i], code[i]);
+         }
+      }
+      _requireBinomial(mutated, trials, p);
+
+      // Together the kinds change the size by the difference of insertions
+      // and deletions on average, deleted instructions are not mutated;
+      MutationParams all = mutation;
+      all.instructionInsertion = algo::Probability(p / 2);
+      all.instructionDeletion = algo::Probability(p / 2);
+      double sizeSum = 0.0;
+      size_t originalCount = 0;
+      for (size_t t = 0; t < trials; ++t)
+      {
+         Chromosome chromosome(original);
+         chromosome.applyMutations(all, random);
+         sizeSum += chromosome.code().size();
+         for (const Instruction & instr : chromosome.code())
+         {
+            originalCount += (instr.u16().get() >= 1000) &&
+               (instr.u16().get() < 1000 + size) &&
+               (instr.u8().get() == instr.u16().get() - 999);
+         }
+      }
+      BOOST_REQUIRE(std::abs(sizeSum / trials - size - p / 2) < 0.25);
+      const double kept = (1.0 - p / 2) * (1.0 - p);
+      BOOST_REQUIRE(
+         std::abs(double(originalCount) / trials / size - kept) < 0.01
+      );
+   }
+
+   // Code left as it is keeps its keys;
+   const boost::shared_ptr<const Config> config(new Config());
+   const InstructionEquals equals(config);
+   Chromosome unchanged(original);
+   const std::vector<uint32_t> * keys = &unchanged.keys(equals);
+   unchanged.applyMutations(MutationParams(), random);
+   BOOST_REQUIRE(&unchanged.keys(equals) == keys);
+   _requireKeys(unchanged, equals);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
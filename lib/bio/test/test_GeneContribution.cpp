@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Cell.hpp"
+#include "Config.hpp"
+#include "GeneContribution.hpp"
+#include "GeneInitializer.hpp"
+#include "Genome.hpp"
+#include "InstructionSet.hpp"
+#include "MutationParams.hpp"
+
+
+#include "algo/random_generators.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+void _requireEqual(
+   const AverageGeneI8x3Param & lhs,
+   const AverageGeneI8x3Param & rhs
+)
+{
+   BOOST_REQUIRE(lhs.nopCount() == rhs.nopCount());
+   const boost::optional<I8x3GeneParam> l = lhs.value();
+   const boost::optional<I8x3GeneParam> r = rhs.value();
+   BOOST_REQUIRE(static_cast<bool>(l) == static_cast<bool>(r));
+   if (l)
+   {
+      BOOST_REQUIRE(l->a == r->a);
+      BOOST_REQUIRE(l->b == r->b);
+      BOOST_REQUIRE(l->c == r->c);
+   }
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   GeneContribution structure test                                       *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_GeneContribution)
+
+
+BOOST_AUTO_TEST_CASE(test_constructor)
+{
+   const Config config;
+   const std::vector<Instruction> responses = {
+      Instruction(config.cmd(OP_RBABC), 10, 0x0302),
+      Instruction(config.cmd(OP_RBABC), 20, 0x0504),
+      Instruction(config.cmd(OP_RNBACD), 0, 0),
+      Instruction(config.cmd(OP_RBBCD), -8, 0),
+      Instruction(config.cmd(OP_RCOMM), 0, 0)
+   };
+   const GeneContribution c(responses, config);
+   BOOST_REQUIRE(c.commit == 1);
+   BOOST_REQUIRE(c.rollback == 0);
+
+   const boost::optional<I8x3GeneParam> abc = c.abcBud.value();
+   BOOST_REQUIRE(abc);
+   BOOST_REQUIRE(abc->a == dt::Int8(15));
+   BOOST_REQUIRE(abc->b == dt::Int8(3));
+   BOOST_REQUIRE(abc->c == dt::Int8(4));
+   BOOST_REQUIRE(!c.acdBud.value());
+   BOOST_REQUIRE(c.acdBud.nopCount() == 1);
+   BOOST_REQUIRE(!c.adbBud.value());
+   BOOST_REQUIRE(c.bcdBud.value());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_sum)
+{
+   algo::CounterRandomGenerator random(1);
+   const boost::shared_ptr<const Config> config(new Config());
+   const mesh::Tetrahedron ttr(0, 1, 2, 3);
+   for (int g = 0; g < 50; ++g)
+   {
+      const Genome genome(config, MutationParams::high(), random);
+      const std::vector<Gene> & genes = genome.genes();
+      const std::vector<GeneContribution> & contributions =
+         genome.geneContributions();
+      BOOST_REQUIRE(contributions.size() == genes.size());
+
+      for (int16_t x = -4; x <= 4; ++x)
+      {
+         for (int16_t y = -4; y <= 4; ++y)
+         {
+            const Cell cell(ttr, x, y);
+            GeneInitializer init;
+            GeneContribution sum;
+            for (size_t i = 0, count = genes.size(); i < count; ++i)
+            {
+               if (cell.doesMeetConditions(genes[i]))
+               {
+                  // Contributions are those of all the copies of a gene;
+                  for (uint32_t c = 0; c < genome.geneWeights()[i]; ++c)
+                  {
+                     for (const Instruction & instr : genes[i].responses)
+                     {
+                        init.append(instr, *config);
+                     }
+                  }
+                  sum += contributions[i];
+               }
+            }
+
+            BOOST_REQUIRE(sum.commit == init.commit);
+            BOOST_REQUIRE(sum.rollback == init.rollback);
+            _requireEqual(sum.abcBud, init.abcBud);
+            _requireEqual(sum.acdBud, init.acdBud);
+            _requireEqual(sum.adbBud, init.adbBud);
+            _requireEqual(sum.bcdBud, init.bcdBud);
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,150 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Cell.hpp"
+#include "Config.hpp"
+#include "GeneExpressionTable.hpp"
+#include "GeneInitializer.hpp"
+#include "Genome.hpp"
+#include "InstructionSet.hpp"
+#include "MutationParams.hpp"
+
+
+#include "algo/random_generators.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+GeneExpression _express(const Genome & genome, const Cell & cell)
+{
+   GeneInitializer init;
+   const std::vector<Gene> & genes = genome.genes();
+   for (size_t i = 0, count = genes.size(); i < count; ++i)
+   {
+      if (cell.doesMeetConditions(genes[i]))
+      {
+         for (uint32_t copy = 0; copy < genome.geneWeights()[i]; ++copy)
+         {
+            for (const Instruction & instr : genes[i].responses)
+            {
+               init.append(instr, *genome.config());
+            }
+         }
+      }
+   }
+
+   GeneExpression expr;
+   expr.buds[0] = init.abcBud.value();
+   expr.buds[1] = init.acdBud.value();
+   expr.buds[2] = init.adbBud.value();
+   expr.buds[3] = init.bcdBud.value();
+   return expr;
+}
+
+
+bool _equal(const GeneExpression & lhs, const GeneExpression & rhs)
+{
+   for (size_t i = 0; i < 4; ++i)
+   {
+      if (static_cast<bool>(lhs.buds[i]) != static_cast<bool>(rhs.buds[i]))
+      {
+         return false;
+      }
+      if (lhs.buds[i] && (
+         lhs.buds[i]->a != rhs.buds[i]->a ||
+         lhs.buds[i]->b != rhs.buds[i]->b ||
+         lhs.buds[i]->c != rhs.buds[i]->c))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   GeneExpressionTable class test                                        *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_GeneExpressionTable)
+
+
+BOOST_AUTO_TEST_CASE(test_expression)
+{
+   algo::CounterRandomGenerator random(1);
+   const boost::shared_ptr<const Config> config(new Config());
+   for (int g = 0; g < 20; ++g)
+   {
+      const Genome genome(config, MutationParams::high(), random);
+      const mesh::Tetrahedron ttr(0, 1, 2, 3);
+
+      for (int pass = 0; pass < 2; ++pass)
+      {
+         for (int16_t x = -3; x <= 3; ++x)
+         {
+            for (int16_t y = -3; y <= 3; ++y)
+            {
+               const Cell cell(ttr, x, y);
+               BOOST_REQUIRE(_equal(
+                  genome.expression(cell),
+                  _express(genome, cell)
+               ));
+            }
+         }
+      }
+
+      const GeneExpressionTable & table = genome.expressionTable();
+      BOOST_REQUIRE(table.size() == 49);
+      BOOST_REQUIRE(table.missCount() == 49);
+      BOOST_REQUIRE(table.hitCount() == 49);
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_sharing)
+{
+   algo::CounterRandomGenerator random(2);
+   const boost::shared_ptr<const Config> config(new Config());
+   const Genome genome(config, MutationParams::high(), random);
+   const Genome copy(genome);
+   const Cell cell(mesh::Tetrahedron(0, 1, 2, 3), 1, -1);
+
+   const GeneExpression & expr = genome.expression(cell);
+   BOOST_REQUIRE(&copy.expression(cell) == &expr);
+   BOOST_REQUIRE(copy.expressionTable().missCount() == 1);
+   BOOST_REQUIRE(copy.expressionTable().hitCount() == 1);
+
+   const Genome other(config, genome.chromosomes());
+   other.expression(cell);
+   BOOST_REQUIRE(other.expressionTable().missCount() == 1);
+   BOOST_REQUIRE(other.expressionTable().hitCount() == 0);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
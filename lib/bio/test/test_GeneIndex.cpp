@@ -0,0 +1,271 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Cell.hpp"
+#include "Chromosome.hpp"
+#include "Config.hpp"
+#include "Gene.hpp"
+#include "GeneIndex.hpp"
+#include "Genome.hpp"
+#include "InstructionSet.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+Genome _makeGenome(size_t codeSize)
+{
+   std::vector<Instruction> code;
+   code.reserve(codeSize);
+   for (size_t i = 0; i < codeSize; ++i)
+   {
+      code.push_back(Instruction(rand() % 256, rand() % 256, rand() % 65536));
+   }
+   const boost::shared_ptr<const Config> config(new Config());
+   return Genome(config, std::vector<Chromosome>(1, Chromosome(code)));
+}
+
+
+std::vector<size_t> _linearFind(
+   const std::vector<Gene> & genes,
+   const Cell & cell
+)
+{
+   std::vector<size_t> result;
+   for (size_t i = 0, count = genes.size(); i < count; ++i)
+   {
+      if (cell.doesMeetConditions(genes[i]))
+      {
+         result.push_back(i);
+      }
+   }
+   return result;
+}
+
+
+std::vector<size_t> _linearFind(
+   const std::vector<Gene> & genes,
+   uint16_t generation,
+   int16_t x,
+   int16_t y
+)
+{
+   std::vector<size_t> result;
+   for (size_t i = 0, count = genes.size(); i < count; ++i)
+   {
+      if (genes[i].generationCondition.isAcceptable(dt::UInt16(generation)) &&
+         genes[i].xCondition.isAcceptable(dt::Int16(x)) &&
+         genes[i].yCondition.isAcceptable(dt::Int16(y))
+      )
+      {
+         result.push_back(i);
+      }
+   }
+   return result;
+}
+
+
+std::vector<size_t> _indexFind(const GeneIndex & index, const Cell & cell)
+{
+   return index.find(
+      dt::UInt16(cell.generation()),
+      dt::Int16(cell.x()),
+      dt::Int16(cell.y())
+   );
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   GeneIndex class test                                                  *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_GeneIndex)
+
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+   const GeneIndex index;
+   BOOST_REQUIRE(index.geneCount() == 0);
+   BOOST_REQUIRE(index.find(dt::UInt16(0), dt::Int16(0), dt::Int16(0)).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_find)
+{
+   srand(1);
+   const mesh::Tetrahedron ttr(0, 1, 2, 3);
+   for (int g = 0; g < 10; ++g)
+   {
+      const Genome genome = _makeGenome(2000);
+      const std::vector<Gene> & genes = genome.genes();
+      const GeneIndex & index = genome.geneIndex();
+      BOOST_REQUIRE(index.geneCount() == genes.size());
+
+      // Bounds of the conditions and their neighbours;
+      std::vector<int16_t> values = {-32768, -32767, -1, 0, 1, 32766, 32767};
+      for (const Gene & gene : genes)
+      {
+         for (const auto & c : {gene.xCondition, gene.yCondition})
+         {
+            if (c.greaterOrEqual())
+            {
+               values.push_back(c.greaterOrEqual()->get());
+               values.push_back(c.greaterOrEqual()->get() - 1);
+            }
+            if (c.lessOrEqual())
+            {
+               values.push_back(c.lessOrEqual()->get());
+               values.push_back(c.lessOrEqual()->get() + 1);
+            }
+         }
+      }
+
+      for (size_t i = 0; i < 2000; ++i)
+      {
+         const Cell cell(
+            ttr,
+            values[rand() % values.size()],
+            values[rand() % values.size()]
+         );
+         BOOST_REQUIRE(_indexFind(index, cell) == _linearFind(genes, cell));
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_findByGeneration)
+{
+   srand(2);
+   const Genome genome = _makeGenome(2000);
+   const std::vector<Gene> & genes = genome.genes();
+   const GeneIndex & index = genome.geneIndex();
+
+   // Bounds of the generation conditions and their neighbours;
+   std::vector<uint16_t> generations = {0, 1, 2, 65534, 65535};
+   for (const Gene & gene : genes)
+   {
+      const auto & c = gene.generationCondition;
+      if (c.greaterOrEqual())
+      {
+         generations.push_back(c.greaterOrEqual()->get());
+         generations.push_back(c.greaterOrEqual()->get() - 1);
+      }
+      if (c.lessOrEqual())
+      {
+         generations.push_back(c.lessOrEqual()->get());
+         generations.push_back(c.lessOrEqual()->get() + 1);
+      }
+   }
+
+   // The same coordinates are looked up in two generations, which must
+   // differ for some of them;
+   size_t differentCount = 0;
+   for (size_t i = 0; i < 2000; ++i)
+   {
+      const uint16_t lhs = generations[rand() % generations.size()];
+      const uint16_t rhs = generations[rand() % generations.size()];
+      const int16_t x = rand() % 64 - 32;
+      const int16_t y = rand() % 64 - 32;
+      const std::vector<size_t> lhsFound =
+         index.find(dt::UInt16(lhs), dt::Int16(x), dt::Int16(y));
+      const std::vector<size_t> rhsFound =
+         index.find(dt::UInt16(rhs), dt::Int16(x), dt::Int16(y));
+      BOOST_REQUIRE(lhsFound == _linearFind(genes, lhs, x, y));
+      BOOST_REQUIRE(rhsFound == _linearFind(genes, rhs, x, y));
+      if (lhsFound != rhsFound)
+      {
+         ++differentCount;
+      }
+   }
+   BOOST_REQUIRE(differentCount > 0);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   GeneIndex benchmark                                                   *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libbio_GeneIndex_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_find)
+{
+   srand(1);
+   const Genome genome = _makeGenome(20000);
+   const std::vector<Gene> & genes = genome.genes();
+   const GeneIndex & index = genome.geneIndex();
+
+   std::vector<Cell> cells;
+   const mesh::Tetrahedron ttr(0, 1, 2, 3);
+   for (int16_t x = -50; x < 50; ++x)
+   {
+      for (int16_t y = -50; y < 50; ++y)
+      {
+         cells.push_back(Cell(ttr, x, y));
+      }
+   }
+
+   size_t linearMatches = 0;
+   const auto linearStart = std::chrono::steady_clock::now();
+   for (const Cell & cell : cells)
+   {
+      linearMatches += _linearFind(genes, cell).size();
+   }
+   const std::chrono::duration<double> linear =
+      std::chrono::steady_clock::now() - linearStart;
+
+   size_t indexMatches = 0;
+   const auto indexStart = std::chrono::steady_clock::now();
+   for (const Cell & cell : cells)
+   {
+      indexMatches += _indexFind(index, cell).size();
+   }
+   const std::chrono::duration<double> indexed =
+      std::chrono::steady_clock::now() - indexStart;
+
+   BOOST_REQUIRE(linearMatches == indexMatches);
+   std::cout << genes.size() << " genes, " << cells.size() << " cells, " <<
+      (linearMatches / cells.size()) << " matches per cell: linear scan " <<
+      linear.count() << " s, index " << indexed.count() << " s" << std::endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Cell.hpp"
+#include "Config.hpp"
+#include "Genome.hpp"
+#include "MutationParams.hpp"
+
+
+#include "algo/random_generators.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+bool _equal(const GeneExpression & lhs, const GeneExpression & rhs)
+{
+   for (size_t i = 0; i < 4; ++i)
+   {
+      if (static_cast<bool>(lhs.buds[i]) != static_cast<bool>(rhs.buds[i]))
+      {
+         return false;
+      }
+      if (lhs.buds[i] && (
+         lhs.buds[i]->a != rhs.buds[i]->a ||
+         lhs.buds[i]->b != rhs.buds[i]->b ||
+         lhs.buds[i]->c != rhs.buds[i]->c))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   Genome class test                                                     *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_Genome)
+
+
+BOOST_AUTO_TEST_CASE(test_geneWeights)
+{
+   algo::CounterRandomGenerator random(1);
+   const boost::shared_ptr<const Config> config(new Config());
+   const mesh::Tetrahedron ttr(0, 1, 2, 3);
+   for (int g = 0; g < 20; ++g)
+   {
+      const Genome haploid(config, MutationParams::high(), random);
+      const std::vector<Gene> & genes = haploid.genes();
+      const std::vector<uint32_t> & weights = haploid.geneWeights();
+      BOOST_REQUIRE(weights.size() == genes.size());
+      BOOST_REQUIRE(haploid.geneContributions().size() == genes.size());
+      for (size_t i = 0; i < genes.size(); ++i)
+      {
+         BOOST_REQUIRE(weights[i] > 0);
+         BOOST_REQUIRE(Gene(genes[i]) == genes[i]);
+         BOOST_REQUIRE(Gene(genes[i]).hash() == genes[i].hash());
+         for (size_t j = i + 1; j < genes.size(); ++j)
+         {
+            BOOST_REQUIRE(!(genes[i] == genes[j]));
+         }
+      }
+
+      // Homologous copies of a chromosome double the weights of its genes,
+      // which leaves every average as it is;
+      const Genome diploid(
+         config,
+         haploid.chromosomes(),
+         haploid.chromosomes()
+      );
+      BOOST_REQUIRE(diploid.genes().size() == genes.size());
+      for (size_t i = 0; i < genes.size(); ++i)
+      {
+         BOOST_REQUIRE(diploid.genes()[i] == genes[i]);
+         BOOST_REQUIRE(diploid.geneWeights()[i] == 2 * weights[i]);
+      }
+      for (int16_t x = -4; x <= 4; ++x)
+      {
+         for (int16_t y = -4; y <= 4; ++y)
+         {
+            const Cell cell(ttr, x, y);
+            BOOST_REQUIRE(
+               _equal(diploid.expression(cell), haploid.expression(cell))
+            );
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
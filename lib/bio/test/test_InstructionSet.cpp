@@ -18,9 +18,14 @@
  ***************************************************************************/
 
 
+#include <cstdlib>
+#include <vector>
+
+
 #include <boost/test/unit_test.hpp>
 
 
+#include "Config.hpp"
 #include "InstructionSet.hpp"
 
 
@@ -45,4 +50,27 @@ BOOST_AUTO_TEST_CASE(test_getInstructionDescriptor)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_InstructionEquals_key)
+{
+   const boost::shared_ptr<const Config> config(new Config());
+   const InstructionEquals equals(config);
+
+   // Narrow parameter ranges so that equal instructions are common;
+   srand(1);
+   std::vector<Instruction> code;
+   for (int i = 0; i < 2000; ++i)
+   {
+      code.push_back(Instruction(rand() % 256, rand() % 2, rand() % 2));
+   }
+   for (size_t i = 0; i < code.size(); ++i)
+   {
+      for (size_t j = i; j < code.size(); j += 7)
+      {
+         BOOST_REQUIRE(equals(code[i], code[j]) ==
+            (equals.key(code[i]) == equals.key(code[j])));
+      }
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,509 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <chrono>
+#include <iostream>
+
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/test/unit_test.hpp>
+
+
+#include "Cell.hpp"
+#include "Chromosome.hpp"
+#include "Config.hpp"
+#include "development.hpp"
+#include "GeneExpressionTable.hpp"
+#include "Genome.hpp"
+#include "InstructionSet.hpp"
+#include "MutationParams.hpp"
+#include "Organism.hpp"
+#include "OrganismDesc.hpp"
+
+
+#include "algo/Hasher.hpp"
+#include "algo/random_generators.hpp"
+#include "mesh/BuddingParams.hpp"
+#include "mesh/CpuMesh.hpp"
+#include "mesh/Triangle.hpp"
+#include "mesh/Vertex.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+// Faces in the order of GeneExpression::buds;
+const dt::TetrahedronFace _budFaces[4] = {
+   dt::TF_ABC,
+   dt::TF_ACD,
+   dt::TF_ADB,
+   dt::TF_BCD
+};
+
+
+boost::shared_ptr<OrganismDesc> _makeDesc(unsigned int seed, uint32_t limit)
+{
+   algo::CounterRandomGenerator random(seed);
+   const boost::shared_ptr<const Config> config(new Config());
+   boost::shared_ptr<OrganismDesc> desc(new OrganismDesc());
+   desc->genome.reset(new Genome(config, MutationParams::high(), random));
+   desc->initialConditions.cellLimit = limit;
+   return desc;
+}
+
+
+// Both chromosomes of the pair carry the given code;
+boost::shared_ptr<OrganismDesc> _makeDesc(
+   const std::vector<Instruction> & code,
+   uint32_t limit
+)
+{
+   const boost::shared_ptr<const Config> config(new Config());
+   const std::vector<Chromosome> chromosomes(2, Chromosome(code));
+   boost::shared_ptr<OrganismDesc> desc(new OrganismDesc());
+   desc->genome.reset(new Genome(config, chromosomes));
+   desc->initialConditions.cellLimit = limit;
+   return desc;
+}
+
+
+// Bud responses with the smallest top radius, the polar and azimuthal
+// angles keep chains of buds from the BCD faces clear of themselves;
+Instruction _makeBud(Opcode opcode)
+{
+   const Config config;
+   return Instruction(config.cmd(opcode), 0x80, 0x3cf0);
+}
+
+
+// A gene without conditions, every cell buds from the faces in the mask,
+// bits follow the order of GeneExpression::buds;
+std::vector<Instruction> _makeBuddingCode(uint8_t faces)
+{
+   const Config config;
+   const Opcode opcodes[4] = {OP_RBABC, OP_RBACD, OP_RBADB, OP_RBBCD};
+   std::vector<Instruction> code;
+   code.push_back(Instruction(config.cmd(OP_PROM), 0, 0));
+   for (size_t i = 0; i < 4; ++i)
+   {
+      if (faces & (1 << i))
+      {
+         code.push_back(_makeBud(opcodes[i]));
+      }
+   }
+   code.push_back(Instruction(config.cmd(OP_RCOMM), 0, 0));
+   return code;
+}
+
+
+// The first cell buds from all of its faces, the rest from the BCD faces
+// only, which grows four chains that never stop before the coordinates run
+// out of precision, past 200000 cells;
+std::vector<Instruction> _makeChainsCode()
+{
+   const Config config;
+   std::vector<Instruction> code = {
+      Instruction(config.cmd(OP_PROM), 0, 0),
+      Instruction(config.cmd(OP_CLEGEN), 0, 0),
+      _makeBud(OP_RBABC),
+      _makeBud(OP_RBACD),
+      _makeBud(OP_RBADB),
+      _makeBud(OP_RBBCD),
+      Instruction(config.cmd(OP_RCOMM), 0, 0),
+      Instruction(config.cmd(OP_PROM), 0, 0),
+      Instruction(config.cmd(OP_CGEGEN), 0, 1),
+      _makeBud(OP_RBBCD),
+      Instruction(config.cmd(OP_RCOMM), 0, 0)
+   };
+   return code;
+}
+
+
+mesh::Mesh * _makeMesh()
+{
+   return new mesh::CpuMesh(
+      dt::Pointf3(0.0f, 0.5f, 0.0f),
+      dt::Pointf3(-0.5f, -0.5f, -0.5f),
+      dt::Pointf3(0.0f, -0.5f, 0.5f),
+      dt::Pointf3(0.5f, -0.5f, -0.5f)
+   );
+}
+
+
+template <typename T>
+void _develop(T & organism)
+{
+   while (!organism.isFinished())
+   {
+      organism.stepOver();
+   }
+}
+
+
+// Grows the way Organism did before it kept the active cells, every step
+// scans all of the cells in the order of the tetrahedrons map and tries
+// each bud they express;
+class _ReferenceOrganism
+{
+   public:
+      explicit _ReferenceOrganism(boost::shared_ptr<const OrganismDesc> desc)
+         : m_mesh(_makeMesh()), m_desc(desc), m_isFinished(false)
+      {
+         const mesh::Tetrahedron ttr(0, 1, 2, 3);
+         m_tetrahedronsMap.insert(ttr, new Cell(
+            ttr,
+            m_desc->initialConditions.x,
+            m_desc->initialConditions.y
+         ));
+      }
+
+      void stepOver()
+      {
+         const Config & config = *m_desc->genome->config();
+         for (auto it = m_tetrahedronsMap.begin();
+            it != m_tetrahedronsMap.end(); ++it)
+         {
+            Cell & cell = *it->second;
+            const GeneExpression & expression =
+               m_desc->genome->expression(cell);
+            bool buddingOccurred = false;
+            for (size_t i = 0; i < 4; ++i)
+            {
+               const auto & bud = expression.buds[i];
+               if (!bud)
+               {
+                  continue;
+               }
+
+               if (m_tetrahedronsMap.size() >=
+                  m_desc->initialConditions.cellLimit)
+               {
+                  m_isFinished = true;
+                  return;
+               }
+
+               const mesh::BuddingParams bp(
+                  _budFaces[i],
+                  config.budTopRadius.convert(bud->a),
+                  config.budTopPolarAngle.convert(bud->b),
+                  config.budTopAzimuthalAngle.convert(bud->c)
+               );
+               if (Cell * budCell = makeCellBud(cell, bp))
+               {
+                  m_tetrahedronsMap.insert(budCell->tetrahedron(), budCell);
+                  buddingOccurred = true;
+               }
+            }
+
+            if (buddingOccurred)
+            {
+               return;
+            }
+         }
+         m_isFinished = true;
+      }
+
+      inline bool isFinished() const {return m_isFinished;}
+      inline const mesh::Mesh & mesh() const {return *m_mesh;}
+      inline const TetrahedronsMap & tetrahedronsMap() const
+      {
+         return m_tetrahedronsMap;
+      }
+
+   private:
+      Cell * makeCellBud(Cell & cell, const mesh::BuddingParams & params)
+      {
+         const mesh::Tetrahedron t = cell.tetrahedron();
+         if (!(m_mesh->tetrahedronVolume(t) > 0.0f))
+         {
+            return 0;
+         }
+
+         const boost::optional<mesh::Tetrahedron> bud =
+            m_mesh->makeTetrahedronBud(t, params);
+         if (!bud)
+         {
+            return 0;
+         }
+
+         std::vector<AdjacentCell> adj;
+         for (const mesh::Tetrahedron & adjTtr :
+            m_mesh->adjacentTetrahedrons(*bud))
+         {
+            if (const Cell * adjCell = m_tetrahedronsMap.findAny(adjTtr))
+            {
+               const auto borderFace = adjCell->tetrahedron().borderFace(*bud);
+               BOOST_REQUIRE(borderFace);
+               adj.push_back(AdjacentCell(adjCell, *borderFace));
+            }
+         }
+         return cell.makeBud(*bud, params.face, adj);
+      }
+
+      boost::scoped_ptr<mesh::Mesh> m_mesh;
+      boost::shared_ptr<const OrganismDesc> m_desc;
+      TetrahedronsMap m_tetrahedronsMap;
+      bool m_isFinished;
+};
+
+
+template <typename Lhs, typename Rhs>
+void _requireSameGrowth(const Lhs & lhs, const Rhs & rhs)
+{
+   const mesh::Mesh & lm = lhs.mesh();
+   const mesh::Mesh & rm = rhs.mesh();
+   BOOST_REQUIRE(lm.vertexCount() == rm.vertexCount());
+   BOOST_REQUIRE(lm.triangleCount() == rm.triangleCount());
+   for (size_t i = 0; i < lm.vertexCount(); ++i)
+   {
+      BOOST_REQUIRE(
+         lm.dynamicVertices()[i].point() == rm.dynamicVertices()[i].point()
+      );
+   }
+   for (size_t i = 0; i < lm.triangleCount(); ++i)
+   {
+      BOOST_REQUIRE(lm.triangles()[i] == rm.triangles()[i]);
+   }
+
+   const TetrahedronsMap & lt = lhs.tetrahedronsMap();
+   const TetrahedronsMap & rt = rhs.tetrahedronsMap();
+   BOOST_REQUIRE(lt.size() == rt.size());
+   for (auto l = lt.begin(), r = rt.begin(); l != lt.end(); ++l, ++r)
+   {
+      BOOST_REQUIRE(l->first == r->first);
+      BOOST_REQUIRE(*l->second == *r->second);
+   }
+}
+
+
+uint64_t _growthHash(const Organism & organism)
+{
+   // The tetrahedrons of the cells with their generations and coordinates.
+   // Vertex indices follow the order of budding;
+   algo::Hasher hasher;
+   const TetrahedronsMap & map = organism.tetrahedronsMap();
+   for (auto it = map.begin(); it != map.end(); ++it)
+   {
+      hasher.add(it->first.a);
+      hasher.add(it->first.b);
+      hasher.add(it->first.c);
+      hasher.add(it->first.d);
+      hasher.add(it->second->generation());
+      hasher.add(static_cast<uint16_t>(it->second->x()));
+      hasher.add(static_cast<uint16_t>(it->second->y()));
+   }
+   return hasher.value();
+}
+
+}
+
+
+/***************************************************************************
+ *   Organism test                                                         *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_Organism)
+
+
+BOOST_AUTO_TEST_CASE(test_cellLimit)
+{
+   // Most random genomes stop budding on their own within a few cells,
+   // these ones keep going up to the limit but the last, which stops at 7;
+   const unsigned int seeds[] = {3, 12, 19, 28, 31};
+   for (unsigned int seed : seeds)
+   {
+      Organism organism(_makeMesh(), _makeDesc(seed, 500));
+      _develop(organism);
+      BOOST_REQUIRE(organism.progress() == 100);
+      if (seed != 31)
+      {
+         BOOST_REQUIRE(organism.tetrahedronsMap().size() == 500);
+      }
+      else
+      {
+         BOOST_REQUIRE(organism.tetrahedronsMap().size() == 7);
+      }
+      const mesh::Mesh & mesh = organism.mesh();
+      BOOST_REQUIRE(mesh.vertexCount() <= mesh.vertexCapacity());
+      BOOST_REQUIRE(mesh.triangleCount() <= mesh.triangleCapacity());
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_fork)
+{
+   const boost::shared_ptr<OrganismDesc> desc = _makeDesc(3, 400);
+   Organism whole(_makeMesh(), desc);
+   _develop(whole);
+
+   Organism organism(_makeMesh(), desc);
+   for (size_t i = 0; i < 200 && !organism.isFinished(); ++i)
+   {
+      organism.stepOver();
+   }
+   const size_t cellCount = organism.tetrahedronsMap().size();
+   const size_t vertexCount = organism.mesh().vertexCount();
+
+   // Either one grows on as if it had never been forked;
+   boost::scoped_ptr<Organism> fork(organism.fork());
+   _develop(*fork);
+   _requireSameGrowth(*fork, whole);
+   BOOST_REQUIRE(organism.tetrahedronsMap().size() == cellCount);
+   BOOST_REQUIRE(organism.mesh().vertexCount() == vertexCount);
+
+   _develop(organism);
+   _requireSameGrowth(organism, whole);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_growthOrder)
+{
+   // Keeping the active cells buds the same cells in the same order as
+   // scanning all of them every step;
+   std::vector<boost::shared_ptr<OrganismDesc> > descs;
+   const uint32_t limits[] = {1, 2, 9, 60, 300};
+   for (uint32_t limit : limits)
+   {
+      for (unsigned int seed = 0; seed < 40; ++seed)
+      {
+         descs.push_back(_makeDesc(seed, limit));
+      }
+      for (uint8_t faces = 1; faces < 16; ++faces)
+      {
+         descs.push_back(_makeDesc(_makeBuddingCode(faces), limit));
+      }
+      descs.push_back(_makeDesc(_makeChainsCode(), limit));
+   }
+
+   for (const boost::shared_ptr<OrganismDesc> & desc : descs)
+   {
+      Organism organism(_makeMesh(), desc);
+      _ReferenceOrganism reference(desc);
+      while (!organism.isFinished())
+      {
+         BOOST_REQUIRE(!reference.isFinished());
+         organism.stepOver();
+         reference.stepOver();
+         BOOST_REQUIRE(
+            organism.tetrahedronsMap().size() ==
+               reference.tetrahedronsMap().size()
+         );
+      }
+      BOOST_REQUIRE(reference.isFinished());
+      _requireSameGrowth(organism, reference);
+   }
+
+   // The cells, their tetrahedrons and the order they are budded in are
+   // pinned by the hash recorded for the development version, any change
+   // to growth shows up here. A new hash goes with a new version, or stored
+   // figures of the old growth are found again;
+   Organism organism(_makeMesh(), _makeDesc(12, 500));
+   _develop(organism);
+   BOOST_REQUIRE(organism.tetrahedronsMap().size() == 500);
+   BOOST_REQUIRE(DEVELOPMENT_VERSION == 1);
+   BOOST_REQUIRE(_growthHash(organism) == 0xcf1b20b36cf0e2b0ull);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_activeCells)
+{
+   // A cell stays active while it expresses a bud from a surface face, even
+   // if the bud fails. Cells whose bud faces are all covered are dropped;
+   for (uint8_t faces = 1; faces < 16; ++faces)
+   {
+      const boost::shared_ptr<OrganismDesc> desc =
+         _makeDesc(_makeBuddingCode(faces), 200);
+      Organism organism(_makeMesh(), desc);
+      while (!organism.isFinished())
+      {
+         organism.stepOver();
+
+         size_t openCellCount = 0;
+         const TetrahedronsMap & map = organism.tetrahedronsMap();
+         for (auto it = map.begin(); it != map.end(); ++it)
+         {
+            const GeneExpression & expression =
+               desc->genome->expression(*it->second);
+            for (size_t i = 0; i < 4; ++i)
+            {
+               if (expression.buds[i] &&
+                  organism.mesh().isSurfaceFace(it->first, _budFaces[i]))
+               {
+                  ++openCellCount;
+                  break;
+               }
+            }
+         }
+         BOOST_REQUIRE(openCellCount <= organism.activeCellCount());
+         BOOST_REQUIRE(organism.activeCellCount() <= map.size());
+      }
+   }
+
+   // Each cell of a chain covers the face its parent budded from, a step
+   // drops the parent once it comes across it;
+   Organism chain(_makeMesh(), _makeDesc(_makeBuddingCode(1 << 3), 300));
+   _develop(chain);
+   BOOST_REQUIRE(chain.tetrahedronsMap().size() == 300);
+   BOOST_REQUIRE(chain.activeCellCount() <= 2);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   Organism benchmark                                                    *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libbio_Organism_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_growth)
+{
+   // Random genomes mostly stop on their own well before the limit, the
+   // chains keep budding up to it;
+   Organism organism(_makeMesh(), _makeDesc(_makeChainsCode(), 200000));
+   size_t steps = 0;
+   const auto start = std::chrono::steady_clock::now();
+   while (!organism.isFinished())
+   {
+      organism.stepOver();
+      ++steps;
+   }
+   const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+   const size_t cells = organism.tetrahedronsMap().size();
+   BOOST_REQUIRE(organism.progress() == 100);
+   BOOST_REQUIRE(cells == 200000);
+   std::cout << cells << " cells, " << organism.mesh().vertexCount() <<
+      " vertices in " << steps << " steps: " << elapsed.count() << " s, " <<
+      (cells / elapsed.count()) << " cells/s" << std::endl;
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <thread>
+#include <vector>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "SimilarityCache.hpp"
+
+
+using namespace bio;
+
+
+/***************************************************************************
+ *   SimilarityCache class test                                            *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_SimilarityCache)
+
+
+BOOST_AUTO_TEST_CASE(test_find)
+{
+   SimilarityCache cache(4);
+   BOOST_REQUIRE(!cache.find(1, 2, 0.5f));
+   cache.insert(1, 2, 0.5f, 0.75f);
+   BOOST_REQUIRE(cache.size() == 1);
+
+   // Pairs are unordered, thresholds are not interchangeable;
+   BOOST_REQUIRE(cache.find(1, 2, 0.5f) && *cache.find(1, 2, 0.5f) == 0.75f);
+   BOOST_REQUIRE(cache.find(2, 1, 0.5f) && *cache.find(2, 1, 0.5f) == 0.75f);
+   BOOST_REQUIRE(!cache.find(1, 2, 0.6f));
+   BOOST_REQUIRE(!cache.find(1, 3, 0.5f));
+   BOOST_REQUIRE(cache.hitCount() == 4);
+   BOOST_REQUIRE(cache.missCount() == 3);
+
+   // The first result stays;
+   cache.insert(2, 1, 0.5f, 0.25f);
+   BOOST_REQUIRE(cache.size() == 1);
+   BOOST_REQUIRE(*cache.find(1, 2, 0.5f) == 0.75f);
+
+   cache.clear();
+   BOOST_REQUIRE(!cache.size() && !cache.hitCount() && !cache.missCount());
+   BOOST_REQUIRE(!cache.find(1, 2, 0.5f));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_capacity)
+{
+   SimilarityCache cache(3);
+   cache.insert(1, 2, 0.5f, 0.1f);
+   cache.insert(1, 3, 0.5f, 0.2f);
+   cache.insert(1, 4, 0.5f, 0.3f);
+   BOOST_REQUIRE(cache.find(1, 2, 0.5f));
+
+   // The least recently used pair goes first;
+   cache.insert(1, 5, 0.5f, 0.4f);
+   BOOST_REQUIRE(cache.size() == 3);
+   BOOST_REQUIRE(cache.find(1, 2, 0.5f));
+   BOOST_REQUIRE(!cache.find(1, 3, 0.5f));
+   BOOST_REQUIRE(cache.find(1, 4, 0.5f));
+   BOOST_REQUIRE(cache.find(1, 5, 0.5f));
+
+   cache.setCapacity(1);
+   BOOST_REQUIRE(cache.size() == 1);
+   BOOST_REQUIRE(cache.find(1, 5, 0.5f));
+
+   cache.setCapacity(0);
+   cache.insert(1, 6, 0.5f, 0.6f);
+   BOOST_REQUIRE(!cache.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_threads)
+{
+   SimilarityCache cache(1000);
+   std::vector<std::thread> threads;
+   for (uint64_t t = 0; t < 4; ++t)
+   {
+      threads.push_back(std::thread([&cache]() {
+         for (uint64_t i = 0; i < 2000; ++i)
+         {
+            const float similarity = static_cast<float>(i % 100) / 100.0f;
+            if (!cache.find(i % 100, 1000 + i % 7, 0.5f))
+            {
+               cache.insert(i % 100, 1000 + i % 7, 0.5f, similarity);
+            }
+         }
+      }));
+   }
+   for (std::thread & thread : threads)
+   {
+      thread.join();
+   }
+
+   BOOST_REQUIRE(cache.size() == 700);
+   BOOST_REQUIRE(cache.hitCount() + cache.missCount() == 8000);
+   for (uint64_t i = 0; i < 700; ++i)
+   {
+      const boost::optional<float> similarity =
+         cache.find(i % 100, 1000 + i % 7, 0.5f);
+      BOOST_REQUIRE(similarity);
+      BOOST_REQUIRE(*similarity == static_cast<float>(i % 100) / 100.0f);
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
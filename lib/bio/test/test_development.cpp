@@ -0,0 +1,168 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "Config.hpp"
+#include "development.hpp"
+#include "Genome.hpp"
+#include "MutationParams.hpp"
+#include "OrganismDesc.hpp"
+
+
+#include "algo/random_generators.hpp"
+
+
+using namespace bio;
+
+
+namespace {
+
+boost::shared_ptr<OrganismDesc> _makeDesc(
+   boost::shared_ptr<const Config> config,
+   const std::vector<Chromosome> & chromosomes
+)
+{
+   boost::shared_ptr<OrganismDesc> desc(new OrganismDesc());
+   desc->genome.reset(new Genome(config, chromosomes));
+   desc->initialConditions.cellLimit = 500;
+   return desc;
+}
+
+
+std::vector<Chromosome> _makeChromosomes(unsigned int seed)
+{
+   algo::CounterRandomGenerator random(seed);
+   const Genome genome(
+      boost::shared_ptr<const Config>(new Config()),
+      MutationParams::high(),
+      random
+   );
+   return genome.chromosomes();
+}
+
+}
+
+
+/***************************************************************************
+ *   development test                                                      *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libbio_development)
+
+
+BOOST_AUTO_TEST_CASE(test_developmentKey)
+{
+   const boost::shared_ptr<const Config> config(new Config());
+   const std::vector<Chromosome> chromosomes = _makeChromosomes(12);
+   const boost::shared_ptr<OrganismDesc> desc =
+      _makeDesc(config, chromosomes);
+   const uint64_t key = developmentKey(*desc, 0, boost::none, 0);
+
+   // Equal descs have equal keys, whatever genome instances they hold;
+   BOOST_REQUIRE(developmentKey(*desc, 0, boost::none, 0) == key);
+   BOOST_REQUIRE(
+      developmentKey(*_makeDesc(config, chromosomes), 0, boost::none, 0) ==
+      key
+   );
+
+   // The bud interval means nothing without relaxation;
+   BOOST_REQUIRE(developmentKey(*desc, 0, boost::none, 8) == key);
+
+   // Everything else changes the key;
+   const mesh::RelaxationParams relaxation;
+   BOOST_REQUIRE(developmentKey(*desc, 1, boost::none, 0) != key);
+   BOOST_REQUIRE(developmentKey(*desc, 0, relaxation, 0) != key);
+   BOOST_REQUIRE(
+      developmentKey(*desc, 0, relaxation, 8) !=
+      developmentKey(*desc, 0, relaxation, 0)
+   );
+   mesh::RelaxationParams longer;
+   longer.maxIterations += 1;
+   BOOST_REQUIRE(
+      developmentKey(*desc, 0, longer, 0) !=
+      developmentKey(*desc, 0, relaxation, 0)
+   );
+
+   OrganismDesc other;
+   other.genome = desc->genome;
+   other.initialConditions = desc->initialConditions;
+   other.initialConditions.cellLimit += 1;
+   BOOST_REQUIRE(developmentKey(other, 0, boost::none, 0) != key);
+   other.initialConditions = desc->initialConditions;
+   other.initialConditions.x += 1;
+   BOOST_REQUIRE(developmentKey(other, 0, boost::none, 0) != key);
+   other.initialConditions = desc->initialConditions;
+   other.initialConditions.y -= 1;
+   BOOST_REQUIRE(developmentKey(other, 0, boost::none, 0) != key);
+
+   Config wider;
+   wider.budTopRadius = Configurable(0.1f, 2.0f);
+   const boost::shared_ptr<const Config> widerConfig(new Config(wider));
+   const boost::shared_ptr<OrganismDesc> widerDesc =
+      _makeDesc(widerConfig, chromosomes);
+   BOOST_REQUIRE(developmentKey(*widerDesc, 0, boost::none, 0) != key);
+
+   const boost::shared_ptr<OrganismDesc> otherDesc =
+      _makeDesc(config, _makeChromosomes(13));
+   BOOST_REQUIRE(developmentKey(*otherDesc, 0, boost::none, 0) != key);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_developmentKey_weights)
+{
+   // Another copy of every chromosome leaves the genes as they are, only
+   // their weights change;
+   const boost::shared_ptr<const Config> config(new Config());
+   const std::vector<Chromosome> chromosomes = _makeChromosomes(12);
+   std::vector<Chromosome> doubled = chromosomes;
+   doubled.insert(doubled.end(), chromosomes.begin(), chromosomes.end());
+
+   const boost::shared_ptr<OrganismDesc> desc =
+      _makeDesc(config, chromosomes);
+   const boost::shared_ptr<OrganismDesc> other = _makeDesc(config, doubled);
+   BOOST_REQUIRE(other->genome->genes() == desc->genome->genes());
+   BOOST_REQUIRE(other->genome->geneWeights() != desc->genome->geneWeights());
+   BOOST_REQUIRE(
+      developmentKey(*other, 0, boost::none, 0) !=
+      developmentKey(*desc, 0, boost::none, 0)
+   );
+}
+
+
+BOOST_AUTO_TEST_CASE(test_developmentKey_stability)
+{
+   // Figures stored by earlier sessions are found only while the keys of
+   // their descs stay the same. The key of a fixed desc is recorded for the
+   // development version;
+   const boost::shared_ptr<OrganismDesc> desc = _makeDesc(
+      boost::shared_ptr<const Config>(new Config()),
+      _makeChromosomes(12)
+   );
+   BOOST_REQUIRE(DEVELOPMENT_VERSION == 1);
+   BOOST_REQUIRE(
+      developmentKey(*desc, 0, boost::none, 0) == 0xac0957e08f50af4full
+   );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
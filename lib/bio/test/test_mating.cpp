@@ -18,18 +18,120 @@
  ***************************************************************************/
 
 
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+
 #include <boost/test/unit_test.hpp>
 
 
+#include "Config.hpp"
+#include "Genome.hpp"
 #include "mating.hpp"
+#include "MutationParams.hpp"
+#include "OrganismDesc.hpp"
+#include "SimilarityCache.hpp"
 
 
+#include "algo/pairing_pair.hpp"
 #include "algo/random_generators.hpp"
 
 
 using namespace bio;
 
 
+namespace {
+
+OrganismDesc * _createDesc()
+{
+   return new OrganismDesc();
+}
+
+
+std::vector<boost::shared_ptr<OrganismDesc> > _mate(
+   const std::vector<boost::shared_ptr<const OrganismDesc> > & parents,
+   size_t count,
+   uint64_t seed,
+   size_t threadCount = 0
+)
+{
+   algo::CounterRandomGenerator random(seed);
+   return mate(
+      parents,
+      _createDesc,
+      count,
+      boost::shared_ptr<const Config>(new Config()),
+      MutationParams::medium(),
+      random,
+      threadCount
+   );
+}
+
+
+std::vector<boost::shared_ptr<const OrganismDesc> > _makeParents(
+   size_t count,
+   const MutationParams & mutationParams
+)
+{
+   const boost::shared_ptr<const Config> config(new Config());
+   std::vector<boost::shared_ptr<const OrganismDesc> > parents;
+   parents.reserve(count);
+   for (uint64_t seed = 1; seed <= count; ++seed)
+   {
+      algo::CounterRandomGenerator random(seed);
+      boost::shared_ptr<OrganismDesc> desc(new OrganismDesc());
+      desc->initialConditions.cellLimit = 100;
+      desc->genome.reset(new Genome(config, mutationParams, random));
+      parents.push_back(desc);
+   }
+   return parents;
+}
+
+
+template <typename T>
+void _append(std::string & bytes, const T & value)
+{
+   bytes.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+
+// Everything mating makes of an offspring, byte by byte: the initial
+// conditions, the code of the chromosomes, their homologous pairs and the
+// weights of the genes;
+std::string _bytes(const OrganismDesc & desc)
+{
+   std::string bytes;
+   _append(bytes, desc.initialConditions.cellLimit);
+   _append(bytes, desc.initialConditions.x);
+   _append(bytes, desc.initialConditions.y);
+
+   const Genome & genome = *desc.genome;
+   for (const Chromosome & chromosome : genome.chromosomes())
+   {
+      _append(bytes, chromosome.code().size());
+      for (const Instruction & instr : chromosome.code())
+      {
+         _append(bytes, instr);
+      }
+   }
+   for (const algo::pairing::Pair<float> & pair : genome.pairs())
+   {
+      _append(bytes, pair.left);
+      _append(bytes, pair.right ? *pair.right : size_t(-1));
+      _append(bytes, pair.metric ? *pair.metric : -1.0f);
+   }
+   for (uint32_t weight : genome.geneWeights())
+   {
+      _append(bytes, weight);
+   }
+   return bytes;
+}
+
+}
+
+
 /***************************************************************************
  *   mating test                                                     *
  ***************************************************************************/
@@ -109,4 +211,96 @@ BOOST_AUTO_TEST_CASE(test_mating)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_reproducibility)
+{
+   const std::vector<boost::shared_ptr<const OrganismDesc> > parents =
+      _makeParents(3, MutationParams::high());
+
+   // The same seed gives the same offspring, another one gives others;
+   for (size_t parentCount = 1; parentCount <= 3; parentCount += 2)
+   {
+      const std::vector<boost::shared_ptr<const OrganismDesc> > p(
+         parents.begin(),
+         parents.begin() + parentCount
+      );
+      const auto first = _mate(p, 16, 11);
+      const auto second = _mate(p, 16, 11);
+      const auto other = _mate(p, 16, 12);
+      BOOST_REQUIRE(first.size() == 16 && second.size() == 16);
+      size_t differences = 0;
+      for (size_t i = 0; i < first.size(); ++i)
+      {
+         BOOST_REQUIRE(_bytes(*first[i]) == _bytes(*second[i]));
+         differences += (_bytes(*first[i]) != _bytes(*other[i]));
+      }
+      BOOST_REQUIRE(differences);
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_threadsBytes)
+{
+   const std::vector<boost::shared_ptr<const OrganismDesc> > parents =
+      _makeParents(16, MutationParams::high());
+
+   // A round made on one thread and one made on many are the same to the
+   // byte, pairs and gene weights included. A single parent mates with
+   // itself;
+   for (size_t parentCount : {1, 16})
+   {
+      const std::vector<boost::shared_ptr<const OrganismDesc> > p(
+         parents.begin(),
+         parents.begin() + parentCount
+      );
+      const auto serial = _mate(p, 48, 17, 1);
+      BOOST_REQUIRE(serial.size() == 48);
+      for (size_t threadCount : {0, 3, 48})
+      {
+         const auto parallel = _mate(p, 48, 17, threadCount);
+         BOOST_REQUIRE(parallel.size() == serial.size());
+         for (size_t i = 0; i < serial.size(); ++i)
+         {
+            BOOST_REQUIRE(_bytes(*parallel[i]) == _bytes(*serial[i]));
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   mating benchmark                                                      *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libbio_mating_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_mating)
+{
+   const std::vector<boost::shared_ptr<const OrganismDesc> > parents =
+      _makeParents(1024, MutationParams::high());
+   std::cout << std::thread::hardware_concurrency() <<
+      " hardware threads" << std::endl;
+
+   for (size_t threadCount : {1, 2, 4, 8})
+   {
+      // Every run pays for its own chromosome comparisons;
+      SimilarityCache::instance().clear();
+      const auto start = std::chrono::steady_clock::now();
+      const auto offspring = _mate(parents, 1024, 1, threadCount);
+      const std::chrono::duration<double> elapsed =
+         std::chrono::steady_clock::now() - start;
+      std::cout << offspring.size() << " offspring of " << parents.size() <<
+         " parents on " << threadCount << " threads: " << elapsed.count() <<
+         " s" << std::endl;
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
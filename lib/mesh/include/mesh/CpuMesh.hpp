@@ -0,0 +1 @@
+#include "../../src/CpuMesh.hpp"
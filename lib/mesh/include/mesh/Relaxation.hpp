@@ -0,0 +1 @@
+#include "../../src/Relaxation.hpp"
@@ -0,0 +1 @@
+#include "../../src/SpringSolver.hpp"
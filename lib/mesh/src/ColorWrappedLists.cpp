@@ -18,6 +18,8 @@
  ***************************************************************************/
 
 
+#include <algorithm>
+#include <cassert>
 #include <new>
 
 
@@ -182,34 +184,33 @@ ColorWrappedLists::const_iterator::const_iterator(
 
 ColorWrappedLists::ColorWrappedLists(
    GLint colorCount,
-   COLOR_COMPONENTS colorComponents
+   COLOR_COMPONENTS colorComponents,
+   GLint maxColorCount
    ) : m_colorCount(0),
    m_colorComponents(colorComponents),
+   m_maxColorCount(maxColorCount),
    m_data(0),
-   m_firstFreeColor(0),
+   m_firstFreeColor(-1),
    m_memModLogging(false)
 {
+   assert(colorCount <= maxColorCount);
    m_memMod.reset(new MemoryModification);
+   grow(colorCount);
+}
 
-   GLint size = colorCount * colorComponents;
-   m_data = new (std::nothrow) GLint[size];
-   if (m_data)
-   {
-      m_colorCount = colorCount;
 
-      // Mark all the colors as free;
-      GLint index = size - 1;
-      for (GLint color = 0, nextColor = -1; color < colorCount; color ++)
-      {
-         m_data[index --] = nextColor;
-         nextColor = colorCount - color - 1;
-
-         for (int item = 0; item < colorComponents - 1; item ++)
-         {
-            m_data[index --] = -1;
-         }
-      }
-   }
+ColorWrappedLists::ColorWrappedLists(const ColorWrappedLists & other)
+   : m_colorCount(other.m_colorCount),
+   m_colorComponents(other.m_colorComponents),
+   m_maxColorCount(other.m_maxColorCount),
+   m_data(0),
+   m_firstFreeColor(other.m_firstFreeColor),
+   m_memModLogging(false)
+{
+   const size_t size = m_colorCount * m_colorComponents;
+   m_data = new GLint[size];
+   std::copy(other.m_data, other.m_data + size, m_data);
+   m_memMod.reset(new MemoryModification(*other.m_memMod));
 }
 
 
@@ -243,6 +244,21 @@ ColorWrappedLists::const_iterator ColorWrappedLists::begin(
 }
 
 
+bool ColorWrappedLists::reserve(GLint colorCount)
+{
+   if (colorCount <= m_colorCount)
+   {
+      return true;
+   }
+   if (colorCount > m_maxColorCount)
+   {
+      return false;
+   }
+   return grow(std::min(std::max(2 * m_colorCount, colorCount),
+      m_maxColorCount));
+}
+
+
 ColorWrappedLists::iterator ColorWrappedLists::createFirstColor()
 {
    GLint color = takeFreeColor();
@@ -341,6 +357,11 @@ void ColorWrappedLists::logModifiedColor(GLint color)
 
 GLint ColorWrappedLists::takeFreeColor()
 {
+   if (m_firstFreeColor < 0)
+   {
+      grow(std::min(std::max<GLint>(2 * m_colorCount, 1), m_maxColorCount));
+   }
+
    GLint freeColor = m_firstFreeColor;
    if (freeColor >= 0)
    {
@@ -354,6 +375,40 @@ GLint ColorWrappedLists::takeFreeColor()
 }
 
 
+bool ColorWrappedLists::grow(GLint colorCount)
+{
+   if (colorCount <= m_colorCount || colorCount > m_maxColorCount)
+   {
+      return false;
+   }
+
+   GLint * data = new (std::nothrow) GLint[colorCount * m_colorComponents];
+   if (!data)
+   {
+      return false;
+   }
+   std::copy(m_data, m_data + m_colorCount * m_colorComponents, data);
+   delete[] m_data;
+   m_data = data;
+
+   // Mark the added colors as free, they are handed out in ascending order
+   // before the colors freed earlier;
+   GLint index = m_colorCount * m_colorComponents;
+   for (GLint color = m_colorCount; color < colorCount; color ++)
+   {
+      for (int item = 0; item < m_colorComponents - 1; item ++)
+      {
+         m_data[index ++] = -1;
+      }
+      m_data[index ++] = (color + 1 < colorCount) ?
+         color + 1 : m_firstFreeColor;
+   }
+   m_firstFreeColor = m_colorCount;
+   m_colorCount = colorCount;
+   return true;
+}
+
+
 void ColorWrappedLists::freeColor(GLint color)
 {
    if (color >= 0)
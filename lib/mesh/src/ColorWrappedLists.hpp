@@ -121,7 +121,15 @@ class ColorWrappedLists
             GLint m_indexOfFirstComponent;
       };
 
-      ColorWrappedLists(GLint colorCount, COLOR_COMPONENTS colorComponents);
+      // The lists never grow beyond maxColorCount colors;
+      ColorWrappedLists(
+         GLint colorCount,
+         COLOR_COMPONENTS colorComponents,
+         GLint maxColorCount
+      );
+      // Copies the lists and the modification log, the copy does not log
+      // until it is told to;
+      ColorWrappedLists(const ColorWrappedLists & other);
       virtual ~ColorWrappedLists();
 
       inline GLint colorCount() const
@@ -132,6 +140,10 @@ class ColorWrappedLists
       {
          return m_colorComponents;
       }
+      inline GLint maxColorCount() const
+      {
+         return m_maxColorCount;
+      }
 
       inline const GLint * data() const
       {
@@ -146,6 +158,11 @@ class ColorWrappedLists
       iterator begin(GLint firstColor);
       const_iterator begin(GLint firstColor) const;
 
+      // Grows the lists to hold at least colorCount colors, doubling the
+      // color count as takeFreeColor does. Fails without changes beyond
+      // maxColorCount;
+      bool reserve(GLint colorCount);
+
       iterator createFirstColor();
       iterator insertAfter(iterator it);
 
@@ -169,6 +186,8 @@ class ColorWrappedLists
       }
 
    private:
+      ColorWrappedLists & operator=(const ColorWrappedLists & other);
+
       void logModifiedColor(GLint color);
 
       inline GLint indexOfLastComponent(GLint color)
@@ -176,11 +195,16 @@ class ColorWrappedLists
          return ((color + 1) * m_colorComponents - 1);
       }
 
+      // The lists grow by doubling the color count once no free color is
+      // left, up to maxColorCount. Iterators stay valid as they hold indices
+      // only;
       GLint takeFreeColor();
+      bool grow(GLint colorCount);
       void freeColor(GLint color);
 
       GLint m_colorCount;
       COLOR_COMPONENTS m_colorComponents;
+      GLint m_maxColorCount;
       GLint * m_data;
       GLint m_firstFreeColor;
       bool m_memModLogging;
@@ -46,8 +46,12 @@ Connections::Entry::Entry(
  ***************************************************************************/
 
 
-Connections::Connections(GLint connectionCount)
-   : ColorWrappedLists(connectionCount, ColorWrappedLists::CC_RGBA)
+Connections::Connections(GLint connectionCount, GLint maxConnectionCount)
+   : ColorWrappedLists(
+      connectionCount,
+      ColorWrappedLists::CC_RGBA,
+      maxConnectionCount
+   )
 {
 }
 
@@ -65,7 +65,7 @@ class Connections : public ColorWrappedLists
          GLint internal;
       };
 
-      explicit Connections(GLint connectionCount);
+      Connections(GLint connectionCount, GLint maxConnectionCount);
       virtual ~Connections();
 
       GLint create(const Entry *entries, size_t count);
@@ -0,0 +1,151 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include "CpuMesh.hpp"
+
+
+namespace mesh {
+
+
+
+
+CpuMesh::CpuMesh(
+   const dt::Pointf3 & a,
+   const dt::Pointf3 & b,
+   const dt::Pointf3 & c,
+   const dt::Pointf3 & d
+) : Mesh(a, b, c, d)
+{
+   updateNormals();
+}
+
+
+CpuMesh::CpuMesh(const CpuMesh & other) : Mesh(other)
+{
+   m_springSolver.setThreadCount(other.m_springSolver.threadCount());
+}
+
+
+CpuMesh::~CpuMesh()
+{
+}
+
+
+Mesh * CpuMesh::fork() const
+{
+   return new CpuMesh(*this);
+}
+
+
+boost::optional<Tetrahedron> CpuMesh::makeTetrahedronBud(
+   const Tetrahedron & t,
+   const BuddingParams & params
+)
+{
+   boost::optional<Tetrahedron> result = Mesh::makeTetrahedronBud(t, params);
+   if (result)
+   {
+      // Budding moves no vertices, so only the bud needs new normals;
+      calculateNormals(*result);
+      clearMemoryModifications();
+   }
+   return result;
+}
+
+
+void CpuMesh::resizeEdge(GLint edge, dt::Float equilibriumLength)
+{
+   Mesh::resizeEdge(edge, equilibriumLength);
+   updateNormals();
+}
+
+
+void CpuMesh::setVertexPos(
+   const dt::VertexId & v,
+   dt::Float x,
+   dt::Float y,
+   dt::Float z
+)
+{
+   Mesh::setVertexPos(v, x, y, z);
+   updateNormals();
+}
+
+
+void CpuMesh::setVertexPosX(const dt::VertexId & v, dt::Float x)
+{
+   Mesh::setVertexPosX(v, x);
+   updateNormals();
+}
+
+
+void CpuMesh::setVertexPosY(const dt::VertexId & v, dt::Float y)
+{
+   Mesh::setVertexPosY(v, y);
+   updateNormals();
+}
+
+
+void CpuMesh::setVertexPosZ(const dt::VertexId & v, dt::Float z)
+{
+   Mesh::setVertexPosZ(v, z);
+   updateNormals();
+}
+
+
+void CpuMesh::setVertexMass(const dt::VertexId & v, dt::Float mass)
+{
+   Mesh::setVertexMass(v, mass);
+   updateNormals();
+}
+
+
+void CpuMesh::selectVertex(
+   const boost::optional<dt::VertexId> & vertex,
+   dt::SelectionMode selectionMode
+)
+{
+   Mesh::selectVertex(vertex, selectionMode);
+   clearMemoryModifications();
+}
+
+
+void CpuMesh::applyForces(size_t iterations)
+{
+   m_springSolver.load(*this);
+   m_springSolver.step(true, iterations);
+   storeDynamicVertices(m_springSolver);
+
+   // Solver normals follow the shader, CpuMesh keeps unit ones;
+   updateNormals();
+}
+
+
+void CpuMesh::updateNormals()
+{
+   calculateNormals();
+
+   // There is no video memory to be synchronized with;
+   clearMemoryModifications();
+}
+
+
+}
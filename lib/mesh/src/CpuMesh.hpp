@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_CPUMESH_H
+#define MESH_CPUMESH_H
+
+
+#include <boost/optional.hpp>
+
+
+#include "Mesh.hpp"
+#include "SpringSolver.hpp"
+
+
+namespace mesh {
+
+
+
+
+// Mesh that keeps all the data in the main memory and calculates normals on
+// the CPU. Unlike GLMesh, it does not require an OpenGL context;
+class CpuMesh : public Mesh
+{
+   public:
+      explicit CpuMesh(
+         const dt::Pointf3 & a,
+         const dt::Pointf3 & b,
+         const dt::Pointf3 & c,
+         const dt::Pointf3 & d
+      );
+      virtual ~CpuMesh();
+
+      virtual Mesh * fork() const;
+
+      virtual boost::optional<Tetrahedron> makeTetrahedronBud(
+         const Tetrahedron & t,
+         const BuddingParams & params
+      );
+
+      virtual void resizeEdge(GLint edge, dt::Float equilibriumLength);
+      virtual void setVertexPos(
+         const dt::VertexId & v,
+         dt::Float x,
+         dt::Float y,
+         dt::Float z
+      );
+      virtual void setVertexPosX(const dt::VertexId & v, dt::Float x);
+      virtual void setVertexPosY(const dt::VertexId & v, dt::Float y);
+      virtual void setVertexPosZ(const dt::VertexId & v, dt::Float z);
+      virtual void setVertexMass(const dt::VertexId & v, dt::Float mass);
+      virtual void selectVertex(
+         const boost::optional<dt::VertexId> & vertex,
+         dt::SelectionMode selectionMode = dt::SM_Vertex
+      );
+
+      virtual void applyForces(size_t iterations = 1);
+
+      inline SpringSolver & springSolver() {return m_springSolver;}
+
+   private:
+      // The solver is loaded from the mesh on every use, so a fork only
+      // takes over its settings;
+      CpuMesh(const CpuMesh & other);
+
+      void updateNormals();
+
+      SpringSolver m_springSolver;
+};
+
+
+}
+
+
+#endif
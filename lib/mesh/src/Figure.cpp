@@ -18,8 +18,10 @@
  ***************************************************************************/
 
 
+#include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <vector>
 
 
 #include "Figure.hpp"
@@ -28,6 +30,44 @@
 #include "Vertex.hpp"
 
 
+namespace {
+
+
+#pragma pack(push)
+#pragma pack(1)
+
+
+struct _FigureHeader
+{
+   explicit _FigureHeader()
+      : vertexCount(0),
+      triangleCount(0),
+      center{0.0f, 0.0f, 0.0f},
+      dimensions{0.0f, 0.0f, 0.0f}
+   {}
+   explicit _FigureHeader(const mesh::Figure & figure)
+      : vertexCount(figure.vertexCount()),
+      triangleCount(figure.triangleCount()),
+      center{figure.center().x, figure.center().y, figure.center().z},
+      dimensions{
+         figure.dimensions().x,
+         figure.dimensions().y,
+         figure.dimensions().z
+      }
+   {}
+   uint32_t vertexCount;
+   uint32_t triangleCount;
+   float center[3];
+   float dimensions[3];
+};
+
+
+#pragma pack(pop)
+
+
+} // anonymous namespace;
+
+
 namespace mesh {
 
 
@@ -57,6 +97,28 @@ Figure::Figure(const Mesh & mesh)
 }
 
 
+Figure::Figure(
+   const Vertex * vertices,
+   size_t vertexCount,
+   const Triangle * triangles,
+   size_t triangleCount,
+   const dt::Pointf3 & center,
+   const dt::Vectorf3 & dimensions
+) : m_vertices(0),
+   m_triangles(0),
+   m_vertexCount(vertexCount),
+   m_triangleCount(triangleCount),
+   m_center(center),
+   m_dimensions(dimensions)
+{
+   m_vertices = new Vertex[m_vertexCount];
+   memcpy(m_vertices, vertices, sizeof(Vertex) * m_vertexCount);
+
+   m_triangles = new Triangle[m_triangleCount];
+   memcpy(m_triangles, triangles, sizeof(Triangle) * m_triangleCount);
+}
+
+
 Figure::~Figure()
 {
    delete[] m_vertices;
@@ -64,6 +126,62 @@ Figure::~Figure()
 }
 
 
+bool Figure::write(std::ostream & os) const
+{
+   const _FigureHeader header(*this);
+   os.write(reinterpret_cast<const char *>(&header), sizeof(header));
+   os.write(
+      reinterpret_cast<const char *>(m_vertices),
+      sizeof(Vertex) * m_vertexCount
+   );
+   os.write(
+      reinterpret_cast<const char *>(m_triangles),
+      sizeof(Triangle) * m_triangleCount
+   );
+   return os.good();
+}
+
+
+Figure * Figure::read(std::istream & is)
+{
+   // Read header;
+   _FigureHeader hdr;
+   if (!is.read(reinterpret_cast<char *>(&hdr), sizeof(hdr)))
+   {
+      return 0;
+   }
+
+   // Read vertices and triangles;
+   std::vector<Vertex> vertices(hdr.vertexCount, Vertex());
+   if (!is.read(
+         reinterpret_cast<char *>(vertices.data()),
+         sizeof(Vertex) * vertices.size()
+      )
+   )
+   {
+      return 0;
+   }
+   std::vector<Triangle> triangles(hdr.triangleCount, Triangle());
+   if (!is.read(
+         reinterpret_cast<char *>(triangles.data()),
+         sizeof(Triangle) * triangles.size()
+      )
+   )
+   {
+      return 0;
+   }
+
+   return new Figure(
+      vertices.data(),
+      vertices.size(),
+      triangles.data(),
+      triangles.size(),
+      dt::Pointf3(hdr.center[0], hdr.center[1], hdr.center[2]),
+      dt::Vectorf3(hdr.dimensions[0], hdr.dimensions[1], hdr.dimensions[2])
+   );
+}
+
+
 std::ostream & operator<<(std::ostream & os, const Figure & figure)
 {
    bool isFirst = true;
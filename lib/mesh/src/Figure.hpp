@@ -23,6 +23,7 @@
 
 
 #include <cstdlib>
+#include <istream>
 #include <ostream>
 
 
@@ -46,8 +47,23 @@ class Figure
 {
    public:
       explicit Figure(const Mesh & mesh);
+      // Copies the arrays, used to restore stored figures;
+      explicit Figure(
+         const Vertex * vertices,
+         size_t vertexCount,
+         const Triangle * triangles,
+         size_t triangleCount,
+         const dt::Pointf3 & center,
+         const dt::Vectorf3 & dimensions
+      );
       virtual ~Figure();
 
+      // Figures are stored as a header of the counts, the center and the
+      // dimensions followed by the arrays as they are in memory. Reading
+      // gives null on a short stream;
+      bool write(std::ostream & os) const;
+      static Figure * read(std::istream & is);
+
       inline const Vertex * vertices() const {return m_vertices;}
       inline const Triangle * triangles() const {return m_triangles;}
 
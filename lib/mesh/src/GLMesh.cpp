@@ -79,75 +79,25 @@ GLMesh::GLMesh(
    m_dynamicVerticesSynced(true)
 {
    memset(m_buffers, 0, sizeof(m_buffers));
+   memset(m_bufferSizes, 0, sizeof(m_bufferSizes));
    memset(m_textures, 0, sizeof(m_textures));
+   createBuffers();
+   updateNormals();
+}
 
-   glGenBuffers(sizeof(m_buffers) / sizeof(GLuint), m_buffers);
-
-   glBindBuffer(GL_ARRAY_BUFFER, m_buffers[BT_DYNAMIC_VERTEX_1]);
-   glBufferData(
-      GL_ARRAY_BUFFER,
-      sizeof(DynamicVertex) * Mesh::MBS_MAX_VERTEX_COUNT,
-      Mesh::dynamicVertices(),
-      GL_STREAM_DRAW
-   );
-   glBindBuffer(GL_ARRAY_BUFFER, m_buffers[BT_DYNAMIC_VERTEX_2]);
-   glBufferData(
-      GL_ARRAY_BUFFER,
-      sizeof(DynamicVertex) * Mesh::MBS_MAX_VERTEX_COUNT,
-      0,
-      GL_STREAM_DRAW
-   );
-   glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffers[BT_TRIANGLE]);
-   glBufferData(
-      GL_ELEMENT_ARRAY_BUFFER,
-      sizeof(Triangle) * Mesh::MBS_MAX_TRIANGLE_COUNT,
-      triangles(),
-      GL_STATIC_DRAW
-   );
-   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-   glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[BT_STATIC_VERTEX]);
-   glBufferData(
-      GL_TEXTURE_BUFFER,
-      sizeof(StaticVertex) * Mesh::MBS_MAX_VERTEX_COUNT,
-      staticVertices(),
-      GL_STATIC_DRAW
-   );
-   glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[BT_EDGE]);
-   glBufferData(
-      GL_TEXTURE_BUFFER,
-      sizeof(Edge) * Mesh::MBS_MAX_EDGE_COUNT,
-      edges(),
-      GL_STATIC_DRAW
-   );
-   glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[BT_CONNECTION]);
-   glBufferData(
-      GL_TEXTURE_BUFFER,
-      sizeof(GLint) * Mesh::MBS_MAX_CONNECTION_COUNT * 4,
-      connections().data(),
-      GL_STATIC_DRAW
-   );
-   glBindBuffer(GL_TEXTURE_BUFFER, 0);
-
-   glGenTextures(sizeof(m_textures) / sizeof(GLuint), m_textures);
-
-   glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_STATIC_VERTEX]);
-   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-   glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, m_buffers[BT_STATIC_VERTEX]);
-
-   glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_EDGE]);
-   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-   glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, m_buffers[BT_EDGE]);
-
-   glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_CONNECTION]);
-   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-   glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, m_buffers[BT_CONNECTION]);
-
-   glBindTexture(GL_TEXTURE_BUFFER, 0);
 
-   updateNormals();
+GLMesh::GLMesh(const GLMesh & other)
+   : Mesh(other),
+   m_feedbackShader(other.m_feedbackShader),
+   m_activeVertexBuffer(BT_DYNAMIC_VERTEX_1),
+   m_backVertexBuffer(BT_DYNAMIC_VERTEX_2),
+   m_dynamicVerticesSynced(true)
+{
+   assert(other.m_dynamicVerticesSynced);
+   memset(m_buffers, 0, sizeof(m_buffers));
+   memset(m_bufferSizes, 0, sizeof(m_bufferSizes));
+   memset(m_textures, 0, sizeof(m_textures));
+   createBuffers();
 }
 
 
@@ -158,6 +108,14 @@ GLMesh::~GLMesh()
 }
 
 
+Mesh * GLMesh::fork() const
+{
+   // Brings the host copy of the vertices up to date;
+   dynamicVertices();
+   return new GLMesh(*this);
+}
+
+
 boost::optional<Tetrahedron> GLMesh::makeTetrahedronBud(
    const Tetrahedron & t,
    const BuddingParams & params
@@ -255,13 +213,77 @@ const DynamicVertex * GLMesh::dynamicVertices() const
 }
 
 
+void GLMesh::applyForces(size_t iterations)
+{
+   doTransformFeedback(true, iterations);
+}
+
+
+void GLMesh::createBuffers()
+{
+   reserveBuffers();
+
+   glBindBuffer(GL_ARRAY_BUFFER, m_buffers[BT_DYNAMIC_VERTEX_1]);
+   glBufferSubData(
+      GL_ARRAY_BUFFER, 0,
+      sizeof(DynamicVertex) * vertexCount(),
+      Mesh::dynamicVertices()
+   );
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_buffers[BT_TRIANGLE]);
+   glBufferSubData(
+      GL_ELEMENT_ARRAY_BUFFER, 0,
+      sizeof(Triangle) * triangleCount(),
+      triangles()
+   );
+   glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+   glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[BT_STATIC_VERTEX]);
+   glBufferSubData(
+      GL_TEXTURE_BUFFER, 0,
+      sizeof(StaticVertex) * vertexCount(),
+      staticVertices()
+   );
+   glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[BT_EDGE]);
+   glBufferSubData(
+      GL_TEXTURE_BUFFER, 0,
+      sizeof(Edge) * edgeCount(),
+      edges()
+   );
+   glBindBuffer(GL_TEXTURE_BUFFER, m_buffers[BT_CONNECTION]);
+   glBufferSubData(
+      GL_TEXTURE_BUFFER, 0,
+      m_bufferSizes[BT_CONNECTION],
+      connections().data()
+   );
+   glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+   glGenTextures(sizeof(m_textures) / sizeof(GLuint), m_textures);
+
+   glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_STATIC_VERTEX]);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   glTexBuffer(GL_TEXTURE_BUFFER, GL_R32I, m_buffers[BT_STATIC_VERTEX]);
+
+   glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_EDGE]);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, m_buffers[BT_EDGE]);
+
+   glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_CONNECTION]);
+   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+   glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, m_buffers[BT_CONNECTION]);
+
+   glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+
 void GLMesh::updateNormals()
 {
    doTransformFeedback(false);
 }
 
 
-void GLMesh::doTransformFeedback(bool applyForces)
+void GLMesh::doTransformFeedback(bool applyForces, size_t iterations)
 {
    GLuint currentProgram = 0;
    glGetIntegerv(
@@ -272,34 +294,6 @@ void GLMesh::doTransformFeedback(bool applyForces)
    glUseProgram(m_feedbackShader.program);
    glEnable(GL_RASTERIZER_DISCARD);
 
-   glBindBuffer(GL_ARRAY_BUFFER, m_buffers[m_activeVertexBuffer]);
-   glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_buffers[m_backVertexBuffer]);
-
-   glVertexAttribPointer(
-      AT_POSITION,
-      4,
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(DynamicVertex),
-      (const GLvoid *) offsetof(DynamicVertex, x)
-   );
-   glVertexAttribPointer(
-      AT_NORMAL,
-      4,
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(DynamicVertex),
-      (const GLvoid *) offsetof(DynamicVertex, nx)
-   );
-   glVertexAttribPointer(
-      AT_VELOCITY,
-      4,
-      GL_FLOAT,
-      GL_FALSE,
-      sizeof(DynamicVertex),
-      (const GLvoid *) offsetof(DynamicVertex, vx)
-   );
-
    glUniform1i(m_feedbackShader.applyForces, applyForces);
 
    glActiveTexture(GL_TEXTURE0);
@@ -317,16 +311,61 @@ void GLMesh::doTransformFeedback(bool applyForces)
    glActiveTexture(GL_TEXTURE3);
    glBindTexture(GL_TEXTURE_BUFFER, m_textures[TT_DYNAMIC_VERTEX]);
    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-   glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32I, m_buffers[m_activeVertexBuffer]);
    glUniform1i(m_feedbackShader.dynamicVertexSampler, 3 /* active texture */);
 
    glEnableVertexAttribArray(AT_POSITION);
    glEnableVertexAttribArray(AT_NORMAL);
    glEnableVertexAttribArray(AT_VELOCITY);
 
-   glBeginTransformFeedback(GL_POINTS);
-   glDrawArrays(GL_POINTS, 0, vertexCount());
-   glEndTransformFeedback();
+   // Passes are queued back to back, the buffers just swap their roles, so
+   // nothing waits for the GPU until the vertices are read back;
+   for (size_t i = 0; i < iterations; ++i)
+   {
+      glBindBuffer(GL_ARRAY_BUFFER, m_buffers[m_activeVertexBuffer]);
+      glBindBufferBase(
+         GL_TRANSFORM_FEEDBACK_BUFFER,
+         0,
+         m_buffers[m_backVertexBuffer]
+      );
+
+      glVertexAttribPointer(
+         AT_POSITION,
+         4,
+         GL_FLOAT,
+         GL_FALSE,
+         sizeof(DynamicVertex),
+         (const GLvoid *) offsetof(DynamicVertex, x)
+      );
+      glVertexAttribPointer(
+         AT_NORMAL,
+         4,
+         GL_FLOAT,
+         GL_FALSE,
+         sizeof(DynamicVertex),
+         (const GLvoid *) offsetof(DynamicVertex, nx)
+      );
+      glVertexAttribPointer(
+         AT_VELOCITY,
+         4,
+         GL_FLOAT,
+         GL_FALSE,
+         sizeof(DynamicVertex),
+         (const GLvoid *) offsetof(DynamicVertex, vx)
+      );
+
+      glTexBuffer(
+         GL_TEXTURE_BUFFER,
+         GL_RGBA32I,
+         m_buffers[m_activeVertexBuffer]
+      );
+
+      glBeginTransformFeedback(GL_POINTS);
+      glDrawArrays(GL_POINTS, 0, vertexCount());
+      glEndTransformFeedback();
+
+      glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+      std::swap(m_activeVertexBuffer, m_backVertexBuffer);
+   }
 
    glDisableVertexAttribArray(AT_VELOCITY);
    glDisableVertexAttribArray(AT_NORMAL);
@@ -344,20 +383,94 @@ void GLMesh::doTransformFeedback(bool applyForces)
    glActiveTexture(GL_TEXTURE0);
    glBindTexture(GL_TEXTURE_BUFFER, 0);
 
-   glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
    glDisable(GL_RASTERIZER_DISCARD);
    glUseProgram(currentProgram);
 
-   std::swap(m_activeVertexBuffer, m_backVertexBuffer);
-
+   // The vertices are read back into the host copy, which a fork must not
+   // see;
+   detach(SS_DYNAMIC_VERTICES);
    m_dynamicVerticesSynced = false;
+   if (applyForces)
+   {
+      // Vertices have been moved;
+      invalidateDimensions();
+      invalidateTriangleGrid();
+   }
+}
+
+
+void GLMesh::reserveBuffers()
+{
+   const size_t sizes[BufferCount] = {
+      sizeof(DynamicVertex) * vertexCapacity(),
+      sizeof(DynamicVertex) * vertexCapacity(),
+      sizeof(Triangle) * triangleCapacity(),
+      sizeof(StaticVertex) * vertexCapacity(),
+      sizeof(Edge) * edgeCapacity(),
+      sizeof(GLint) * connections().colorCount() *
+         connections().colorComponents()
+   };
+   const GLenum usages[BufferCount] = {
+      GL_STREAM_DRAW,
+      GL_STREAM_DRAW,
+      GL_STATIC_DRAW,
+      GL_STATIC_DRAW,
+      GL_STATIC_DRAW,
+      GL_STATIC_DRAW
+   };
+
+   for (int i = 0; i < BufferCount; ++i)
+   {
+      if (sizes[i] <= m_bufferSizes[i])
+      {
+         continue;
+      }
+
+      // The back vertex buffer is overwritten by every pass, the others are
+      // copied on the GPU: the active vertex buffer may be ahead of the host
+      // copy and pending modifications are pushed after this anyway;
+      GLuint buffer = 0;
+      glGenBuffers(1, &buffer);
+      glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+      glBufferData(GL_COPY_WRITE_BUFFER, sizes[i], 0, usages[i]);
+      if (m_bufferSizes[i] && i != m_backVertexBuffer)
+      {
+         glBindBuffer(GL_COPY_READ_BUFFER, m_buffers[i]);
+         glCopyBufferSubData(
+            GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            0, 0, m_bufferSizes[i]
+         );
+         glBindBuffer(GL_COPY_READ_BUFFER, 0);
+      }
+      glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+      glDeleteBuffers(1, &m_buffers[i]);
+      m_buffers[i] = buffer;
+      m_bufferSizes[i] = sizes[i];
+
+      const int texture =
+         i == BT_STATIC_VERTEX ? TT_STATIC_VERTEX :
+         i == BT_EDGE ? TT_EDGE :
+         i == BT_CONNECTION ? TT_CONNECTION : -1;
+      if (texture >= 0 && m_textures[texture])
+      {
+         const GLenum format =
+            i == BT_STATIC_VERTEX ? GL_R32I :
+            i == BT_EDGE ? GL_R32F : GL_RGBA32I;
+         glBindTexture(GL_TEXTURE_BUFFER, m_textures[texture]);
+         glTexBuffer(GL_TEXTURE_BUFFER, format, m_buffers[i]);
+         glBindTexture(GL_TEXTURE_BUFFER, 0);
+      }
+   }
 }
 
 
 void GLMesh::pushModifications()
 {
+   reserveBuffers();
+
    _updateBuffer(
       GL_ARRAY_BUFFER,
       m_buffers[m_activeVertexBuffer],
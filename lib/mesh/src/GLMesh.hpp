@@ -62,6 +62,9 @@ class GLMesh : public Mesh
       );
       virtual ~GLMesh();
 
+      // The fork gets buffers of its own, so the context has to be current;
+      virtual Mesh * fork() const;
+
       virtual boost::optional<Tetrahedron> makeTetrahedronBud(
          const Tetrahedron & t,
          const BuddingParams & params
@@ -83,6 +86,8 @@ class GLMesh : public Mesh
          dt::SelectionMode selectionMode = dt::SM_Vertex
       );
 
+      virtual void applyForces(size_t iterations = 1);
+
       virtual const DynamicVertex * dynamicVertices() const;
 
       inline GLuint dynamicVertexBuffer() const;
@@ -113,13 +118,22 @@ class GLMesh : public Mesh
          TextureCount
       };
 
+      // Buffers are filled from the host arrays, which have to be in sync
+      // with the video memory;
+      GLMesh(const GLMesh & other);
+
+      void createBuffers();
       void updateNormals();
-      void doTransformFeedback(bool applyForces);
+      void doTransformFeedback(bool applyForces, size_t iterations = 1);
 
+      // Buffers follow the capacities of the host arrays, the contents are
+      // preserved when a buffer is reallocated;
+      void reserveBuffers();
       void pushModifications();
 
       shader::FeedbackShaderDesc m_feedbackShader;
       GLuint m_buffers[BufferCount];
+      size_t m_bufferSizes[BufferCount];
       GLuint m_textures[TextureCount];
       int m_activeVertexBuffer;
       int m_backVertexBuffer;
@@ -20,11 +20,13 @@
 
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
 
 
+#include "utils3d/batch.hpp"
 #include "utils3d/geometry.hpp"
 
 
@@ -34,6 +36,7 @@
 #include "Edge.hpp"
 #include "Mesh.hpp"
 #include "SelectionHelper.hpp"
+#include "SpringSolver.hpp"
 #include "Vertex.hpp"
 
 
@@ -62,6 +65,60 @@ void _convertToInternal(
       static_cast<GLint>(edge));
 }
 
+
+// Reallocates the array to hold at least required elements, the capacity is
+// doubled to keep the number of reallocations logarithmic. Nothing is changed
+// if more than maxCapacity elements are required;
+template <typename T>
+bool _reserve(
+   boost::shared_array<T> & array,
+   size_t & capacity,
+   size_t count,
+   size_t required,
+   size_t maxCapacity
+)
+{
+   if (required > maxCapacity)
+   {
+      return false;
+   }
+   if (required > capacity)
+   {
+      const size_t newCapacity = std::min(
+         std::max(2 * capacity, required),
+         maxCapacity
+      );
+      boost::shared_array<T> newArray(new T[newCapacity]);
+      std::copy(array.get(), array.get() + count, newArray.get());
+      array.swap(newArray);
+      capacity = newCapacity;
+   }
+   return true;
+}
+
+
+// Gives the array a copy of its own if a fork still refers to it;
+template <typename T>
+void _detach(boost::shared_array<T> & array, size_t count, size_t capacity)
+{
+   if (!array.unique())
+   {
+      boost::shared_array<T> copy(new T[capacity]);
+      std::copy(array.get(), array.get() + count, copy.get());
+      array.swap(copy);
+   }
+}
+
+
+template <typename T>
+void _detach(boost::shared_ptr<T> & object)
+{
+   if (!object.unique())
+   {
+      object.reset(new T(*object));
+   }
+}
+
 } // anonymous namespace;
 
 
@@ -78,41 +135,42 @@ Mesh::Mesh(
    const dt::Pointf3 & b,
    const dt::Pointf3 & c,
    const dt::Pointf3 & d
-) : m_dynamicVertices(0),
-   m_staticVertices(0),
-   m_triangles(0),
-   m_edges(0),
-   m_connections(0),
-   m_vertexCount(0),
+) : m_vertexCount(0),
    m_triangleCount(0),
-   m_edgeCount(0)
+   m_edgeCount(0),
+   m_vertexCapacity(IBS_VERTEX_COUNT),
+   m_triangleCapacity(IBS_TRIANGLE_COUNT),
+   m_edgeCapacity(IBS_EDGE_COUNT),
+   m_triangleGridSize(0),
+   m_isTriangleGridValid(false)
 {
-   m_dynamicVertices = new DynamicVertex[MBS_MAX_VERTEX_COUNT];
+   m_dynamicVertices.reset(new DynamicVertex[m_vertexCapacity]);
    m_dynamicVertices[0] = DynamicVertex(a.x, a.y, a.z);
    m_dynamicVertices[1] = DynamicVertex(b.x, b.y, b.z);
    m_dynamicVertices[2] = DynamicVertex(c.x, c.y, c.z);
    m_dynamicVertices[3] = DynamicVertex(d.x, d.y, d.z);
 
-   m_staticVertices = new StaticVertex[MBS_MAX_VERTEX_COUNT];
+   m_staticVertices.reset(new StaticVertex[m_vertexCapacity]);
 
    m_vertexCount = 4;
 
-   m_triangles = new Triangle[MBS_MAX_TRIANGLE_COUNT];
+   m_triangles.reset(new Triangle[m_triangleCapacity]);
    m_triangles[0] = Triangle(0, 1, 2);
    m_triangles[1] = Triangle(0, 2, 3);
    m_triangles[2] = Triangle(0, 3, 1);
    m_triangles[3] = Triangle(1, 3, 2);
    m_triangleCount = 4;
 
-   m_trianglesMap.insert(m_triangles[0], dt::TriangleId(0));
-   m_trianglesMap.insert(m_triangles[1], dt::TriangleId(1));
-   m_trianglesMap.insert(m_triangles[2], dt::TriangleId(2));
-   m_trianglesMap.insert(m_triangles[3], dt::TriangleId(3));
+   m_trianglesMap.reset(new TrianglesMap);
+   m_trianglesMap->insert(m_triangles[0], dt::TriangleId(0));
+   m_trianglesMap->insert(m_triangles[1], dt::TriangleId(1));
+   m_trianglesMap->insert(m_triangles[2], dt::TriangleId(2));
+   m_trianglesMap->insert(m_triangles[3], dt::TriangleId(3));
 
-   m_edges = new Edge[MBS_MAX_EDGE_COUNT];
+   m_edges.reset(new Edge[m_edgeCapacity]);
    m_edgeCount = 6;
    {
-      const DynamicVertex * dv = m_dynamicVertices;
+      const DynamicVertex * dv = m_dynamicVertices.get();
       m_edges[0] = Edge(utils3d::distance(dv[0].point(), dv[1].point()));
       m_edges[1] = Edge(utils3d::distance(dv[0].point(), dv[2].point()));
       m_edges[2] = Edge(utils3d::distance(dv[0].point(), dv[3].point()));
@@ -121,7 +179,9 @@ Mesh::Mesh(
       m_edges[5] = Edge(utils3d::distance(dv[2].point(), dv[3].point()));
    }
 
-   m_connections = new Connections(MBS_MAX_CONNECTION_COUNT);
+   m_connections.reset(
+      new Connections(IBS_CONNECTION_COUNT, MBS_MAX_CONNECTION_COUNT)
+   );
 
    // Order is necessary for proper normal calculation and
    // is required by vertexCanBeRemoved();
@@ -165,13 +225,43 @@ Mesh::Mesh(
 }
 
 
+Mesh::Mesh(const Mesh & other)
+   : m_dynamicVertices(other.m_dynamicVertices),
+   m_staticVertices(other.m_staticVertices),
+   m_triangles(other.m_triangles),
+   m_edges(other.m_edges),
+   m_connections(other.m_connections),
+   m_vertexCount(other.m_vertexCount),
+   m_triangleCount(other.m_triangleCount),
+   m_edgeCount(other.m_edgeCount),
+   m_vertexCapacity(other.m_vertexCapacity),
+   m_triangleCapacity(other.m_triangleCapacity),
+   m_edgeCapacity(other.m_edgeCapacity),
+   m_trianglesMap(other.m_trianglesMap),
+   m_structureMods(other.m_structureMods),
+   m_selection(other.m_selection),
+   m_center(other.m_center),
+   m_dimensions(other.m_dimensions),
+   m_triangleGridSize(0),
+   m_isTriangleGridValid(false)
+{
+   // The connections log belongs to the original;
+   if (!m_connections->memoryModification()->empty())
+   {
+      m_connections.reset(new Connections(*m_connections));
+      m_connections->clearMemoryModificationLog();
+   }
+}
+
+
 Mesh::~Mesh()
 {
-   delete[] m_dynamicVertices;
-   delete[] m_staticVertices;
-   delete[] m_triangles;
-   delete[] m_edges;
-   delete m_connections;
+}
+
+
+Mesh * Mesh::fork() const
+{
+   return new Mesh(*this);
 }
 
 
@@ -243,6 +333,25 @@ boost::optional<Tetrahedron> Mesh::makeTetrahedronBud(
       return result;
    }
 
+   // Arrays are grown before the mesh is changed, elements are created
+   // within the reserved capacity;
+   if (!reserveVertices(m_vertexCount + helper->verticesToBeAdded()) ||
+      !reserveEdges(m_edgeCount + helper->edgesToBeAdded()) ||
+      !reserveTriangles(m_triangleCount + helper->trianglesToBeAdded())
+   )
+   {
+      return result;
+   }
+
+   detach(SS_ALL);
+
+   // Every edge takes a connection at both of its vertices, the connections
+   // are grown once detached as they are shared with copies of the mesh;
+   if (!m_connections->reserve(2 * (m_edgeCount + helper->edgesToBeAdded())))
+   {
+      return result;
+   }
+
    clearSelection();
 
    // Set proper vertex order;
@@ -392,6 +501,7 @@ void Mesh::resizeEdge(GLint edge, dt::Float equilibriumLength)
    assert(static_cast<size_t>(edge) < m_edgeCount);
    if (equilibriumLength >= 0.0f)
    {
+      detach(SS_EDGES);
       m_edges[edge].equilibriumLength = equilibriumLength;
       m_edgeMods.insertArrayElement(edge, sizeof(Edge));
    }
@@ -406,6 +516,7 @@ void Mesh::setVertexPos(
 )
 {
    assert(v.get() < m_vertexCount);
+   detach(SS_DYNAMIC_VERTICES);
    DynamicVertex & dv = m_dynamicVertices[v.get()];
    dv.x = x;
    dv.y = y;
@@ -415,48 +526,56 @@ void Mesh::setVertexPos(
       sizeof(dt::Float) * 3
    );
    invalidateDimensions();
+   invalidateTriangleGrid();
 }
 
 
 void Mesh::setVertexPosX(const dt::VertexId & v, dt::Float x)
 {
    assert(v.get() < m_vertexCount);
+   detach(SS_DYNAMIC_VERTICES);
    m_dynamicVertices[v.get()].x = x;
    m_dynamicVertexMods.insertMemoryBlock(
       v.get() * sizeof(DynamicVertex) + offsetof(DynamicVertex, x),
       sizeof(dt::Float)
    );
    invalidateDimensions();
+   invalidateTriangleGrid();
 }
 
 
 void Mesh::setVertexPosY(const dt::VertexId & v, dt::Float y)
 {
    assert(v.get() < m_vertexCount);
+   detach(SS_DYNAMIC_VERTICES);
    m_dynamicVertices[v.get()].y = y;
    m_dynamicVertexMods.insertMemoryBlock(
       v.get() * sizeof(DynamicVertex) + offsetof(DynamicVertex, y),
       sizeof(dt::Float)
    );
    invalidateDimensions();
+   invalidateTriangleGrid();
 }
 
 
 void Mesh::setVertexPosZ(const dt::VertexId & v, dt::Float z)
 {
    assert(v.get() < m_vertexCount);
+   detach(SS_DYNAMIC_VERTICES);
    m_dynamicVertices[v.get()].z = z;
    m_dynamicVertexMods.insertMemoryBlock(
       v.get() * sizeof(DynamicVertex) + offsetof(DynamicVertex, z),
       sizeof(dt::Float)
    );
    invalidateDimensions();
+   invalidateTriangleGrid();
 }
 
 
 void Mesh::setVertexMass(const dt::VertexId & v, dt::Float mass)
 {
    assert(v.get() < m_vertexCount);
+   detach(SS_DYNAMIC_VERTICES);
    m_dynamicVertices[v.get()].mass = mass;
    m_dynamicVertexMods.insertMemoryBlock(
       v.get() * sizeof(DynamicVertex) + offsetof(DynamicVertex, mass),
@@ -470,6 +589,7 @@ void Mesh::selectVertex(
    dt::SelectionMode selectionMode
 )
 {
+   detach(SS_STATIC_VERTICES);
    if (vertex && vertex->get() < m_vertexCount)
    {
       const dt::VertexId & v = *vertex;
@@ -539,9 +659,48 @@ void Mesh::selectVertex(
 }
 
 
+void Mesh::applyForces(size_t iterations)
+{
+   SpringSolver solver;
+   solver.load(*this);
+   solver.step(true, iterations);
+   storeDynamicVertices(solver);
+}
+
+
+RelaxationStats Mesh::relax(const RelaxationParams & params)
+{
+   assert(params.batchSize > 0);
+   RelaxationStats stats;
+   const auto start = std::chrono::steady_clock::now();
+   while (stats.iterations < params.maxIterations)
+   {
+      const size_t iterations = std::min(
+         params.batchSize,
+         params.maxIterations - stats.iterations
+      );
+      applyForces(iterations);
+      stats.iterations += iterations;
+      ++stats.batches;
+
+      measureMotion(dynamicVertices(), m_vertexCount, stats);
+      if (stats.kineticEnergy <= params.maxKineticEnergy ||
+         stats.maxDisplacement <= params.maxDisplacement)
+      {
+         stats.isConverged = true;
+         break;
+      }
+   }
+   const std::chrono::duration<double> time =
+      std::chrono::steady_clock::now() - start;
+   stats.seconds = time.count();
+   return stats;
+}
+
+
 const DynamicVertex * Mesh::dynamicVertices() const
 {
-   return m_dynamicVertices;
+   return m_dynamicVertices.get();
 }
 
 
@@ -699,7 +858,7 @@ boost::optional<dt::TriangleId> Mesh::selectedTriangle() const
 {
    if (m_selection.size() == 3)
    {
-      return m_trianglesMap.findAny(Triangle(
+      return m_trianglesMap->findAny(Triangle(
          m_selection[0].get(),
          m_selection[1].get(),
          m_selection[2].get()
@@ -739,6 +898,24 @@ dt::Float Mesh::tetrahedronVolume(const Tetrahedron & t) const
 }
 
 
+bool Mesh::isSurfaceFace(
+   const Tetrahedron & t,
+   dt::TetrahedronFace face
+) const
+{
+   const size_t faceVertices[4][3] = {
+      {t.a, t.b, t.c}, // TF_ABC;
+      {t.a, t.c, t.d}, // TF_ACD;
+      {t.a, t.d, t.b}, // TF_ADB;
+      {t.b, t.c, t.d}  // TF_BCD;
+   };
+   const size_t * v = faceVertices[face];
+   return static_cast<bool>(
+      m_trianglesMap->findAny(Triangle(v[0], v[1], v[2]))
+   );
+}
+
+
 dt::Pointf3 Mesh::center() const
 {
    if (!m_center)
@@ -765,7 +942,12 @@ void Mesh::clearMemoryModifications()
    m_staticVertexMods.clear();
    m_triangleMods.clear();
    m_edgeMods.clear();
-   m_connections->memoryModification()->clear();
+
+   // A shared connections log is always empty, see detach();
+   if (!m_connections->memoryModification()->empty())
+   {
+      m_connections->memoryModification()->clear();
+   }
 }
 
 
@@ -776,6 +958,135 @@ void Mesh::invalidateDimensions()
 }
 
 
+void Mesh::invalidateTriangleGrid()
+{
+   m_isTriangleGridValid = false;
+}
+
+
+void Mesh::calculateNormals()
+{
+   detach(SS_DYNAMIC_VERTICES);
+   for (size_t v = 0; v < m_vertexCount; ++v)
+   {
+      calculateNormal(v);
+   }
+}
+
+
+void Mesh::calculateNormals(const Tetrahedron & bud)
+{
+   detach(SS_DYNAMIC_VERTICES);
+   calculateNormal(bud.a);
+   calculateNormal(bud.b);
+   calculateNormal(bud.c);
+   calculateNormal(bud.d);
+}
+
+
+void Mesh::calculateNormal(size_t v)
+{
+   // Same traversal as feedback.glslv: sum up the normals of the external
+   // triangles adjacent to the vertex;
+   DynamicVertex & dv = m_dynamicVertices[v];
+   const dt::Pointf3 p = dv.point();
+   dt::Float nx = 0.0f, ny = 0.0f, nz = 0.0f;
+
+   Connections::const_iterator it = m_connections->begin(
+      m_staticVertices[v].connection
+   );
+   if (it.isValid())
+   {
+      const GLint first = it.get(Connections::VT_VERTEX);
+      GLint prev = first;
+      for (++it; it.isValid(); ++it)
+      {
+         if (it.get(Connections::VT_INTERNAL) > 0)
+         {
+            break;
+         }
+         const GLint curr = it.get(Connections::VT_VERTEX);
+         const dt::Vectorf3 n = dt::crossProduct(
+            dt::Vectorf3(p, m_dynamicVertices[prev].point()),
+            dt::Vectorf3(p, m_dynamicVertices[curr].point())
+         ).normalized();
+         nx += n.x;
+         ny += n.y;
+         nz += n.z;
+         prev = curr;
+      }
+
+      if (prev != first)
+      {
+         const dt::Vectorf3 n = dt::crossProduct(
+            dt::Vectorf3(p, m_dynamicVertices[prev].point()),
+            dt::Vectorf3(p, m_dynamicVertices[first].point())
+         ).normalized();
+         nx += n.x;
+         ny += n.y;
+         nz += n.z;
+      }
+   }
+
+   const dt::Vectorf3 normal = dt::Vectorf3(nx, ny, nz).normalized();
+   if (normal.length() > 0.0f)
+   {
+      dv.nx = normal.x;
+      dv.ny = normal.y;
+      dv.nz = normal.z;
+   }
+   else
+   {
+      dv.nx = 1.0f;
+      dv.ny = 0.0f;
+      dv.nz = 0.0f;
+   }
+}
+
+
+void Mesh::storeDynamicVertices(const SpringSolver & solver)
+{
+   assert(solver.vertexCount() == m_vertexCount);
+   detach(SS_DYNAMIC_VERTICES);
+   solver.store(m_dynamicVertices.get());
+   m_dynamicVertexMods.insertMemoryBlock(
+      0,
+      m_vertexCount * sizeof(DynamicVertex)
+   );
+   invalidateDimensions();
+   invalidateTriangleGrid();
+}
+
+
+void Mesh::detach(int storage)
+{
+   if (storage & SS_DYNAMIC_VERTICES)
+   {
+      _detach(m_dynamicVertices, m_vertexCount, m_vertexCapacity);
+   }
+   if (storage & SS_STATIC_VERTICES)
+   {
+      _detach(m_staticVertices, m_vertexCount, m_vertexCapacity);
+   }
+   if (storage & SS_TRIANGLES)
+   {
+      _detach(m_triangles, m_triangleCount, m_triangleCapacity);
+   }
+   if (storage & SS_EDGES)
+   {
+      _detach(m_edges, m_edgeCount, m_edgeCapacity);
+   }
+   if (storage & SS_CONNECTIONS)
+   {
+      _detach(m_connections);
+   }
+   if (storage & SS_TRIANGLES_MAP)
+   {
+      _detach(m_trianglesMap);
+   }
+}
+
+
 void Mesh::clearSelection()
 {
    for (size_t i = 0, count = m_selection.size(); i < count; ++i)
@@ -815,8 +1126,8 @@ void Mesh::helpEdgeBudding(
    if (edge.convertToInternal)
    {
       _convertToInternal(
-         m_staticVertices,
-         m_connections,
+         m_staticVertices.get(),
+         m_connections.get(),
          m_staticVertexMods,
          va,
          vb,
@@ -824,8 +1135,8 @@ void Mesh::helpEdgeBudding(
       );
 
       _convertToInternal(
-         m_staticVertices,
-         m_connections,
+         m_staticVertices.get(),
+         m_connections.get(),
          m_staticVertexMods,
          vb,
          va,
@@ -889,7 +1200,33 @@ bool Mesh::ensureNoCollisionsForBud(
    const dt::Pointf3 budB = dv[budBaseTr.b].point();
    const dt::Pointf3 budC = dv[budBaseTr.c].point();
 
-   for (size_t i = 0; i < m_triangleCount; ++i)
+   // Cells are sized after the triangles at the time of building, budding
+   // keeps making them smaller, so the grid is rebuilt every time the number
+   // of triangles doubles;
+   if (!m_isTriangleGridValid || m_triangleCount > 2 * m_triangleGridSize)
+   {
+      rebuildTriangleGrid(dv);
+   }
+
+   // Only triangles whose boxes overlap the box of the bud can intersect it;
+   const std::vector<size_t> candidates = m_triangleGrid.find(
+      dt::Pointf3(
+         std::min(std::min(budA.x, budB.x), std::min(budC.x, budTop.x)),
+         std::min(std::min(budA.y, budB.y), std::min(budC.y, budTop.y)),
+         std::min(std::min(budA.z, budB.z), std::min(budC.z, budTop.z))
+      ),
+      dt::Pointf3(
+         std::max(std::max(budA.x, budB.x), std::max(budC.x, budTop.x)),
+         std::max(std::max(budA.y, budB.y), std::max(budC.y, budTop.y)),
+         std::max(std::max(budA.z, budB.z), std::max(budC.z, budTop.z))
+      )
+   );
+   // Each side of the bud is tested against the triangles it does not share
+   // an edge point with, all of them at once;
+   utils3d::TriangleBatch abBatch;
+   utils3d::TriangleBatch acBatch;
+   utils3d::TriangleBatch bcBatch;
+   for (size_t i : candidates)
    {
       if (i != budBaseIndex)
       {
@@ -903,26 +1240,28 @@ bool Mesh::ensureNoCollisionsForBud(
          const dt::Pointf3 b = dv[t.b].point();
          const dt::Pointf3 c = dv[t.c].point();
 
-         if (!t.contains(budBaseTr.a) && !t.contains(budBaseTr.b) &&
-            utils3d::doTrianglesIntersect(budA, budB, budTop, a, b, c))
+         const bool containsA = t.contains(budBaseTr.a);
+         const bool containsB = t.contains(budBaseTr.b);
+         const bool containsC = t.contains(budBaseTr.c);
+         if (!containsA && !containsB)
          {
-            return false;
+            abBatch.append(a, b, c);
          }
-
-         if (!t.contains(budBaseTr.a) && !t.contains(budBaseTr.c) &&
-            utils3d::doTrianglesIntersect(budA, budC, budTop, a, b, c))
+         if (!containsA && !containsC)
          {
-            return false;
+            acBatch.append(a, b, c);
          }
-
-         if (!t.contains(budBaseTr.b) && !t.contains(budBaseTr.c) &&
-            utils3d::doTrianglesIntersect(budB, budC, budTop, a, b, c))
+         if (!containsB && !containsC)
          {
-            return false;
+            bcBatch.append(a, b, c);
          }
       }
    }
-   return true;
+
+   return
+      !utils3d::findTriangleIntersection(budA, budB, budTop, abBatch) &&
+      !utils3d::findTriangleIntersection(budA, budC, budTop, acBatch) &&
+      !utils3d::findTriangleIntersection(budB, budC, budTop, bcBatch);
 }
 
 
@@ -933,7 +1272,8 @@ dt::VertexId Mesh::createBudTopVertex(
    const dt::Pointf3 & budTop
 )
 {
-   assert(m_vertexCount + 1 <= MBS_MAX_VERTEX_COUNT);
+   bool ok = reserveVertices(m_vertexCount + 1);
+   assert(ok);
    size_t vNew = m_vertexCount ++;
    m_dynamicVertices[vNew] = DynamicVertex(budTop.x, budTop.y, budTop.z);
    m_staticVertices[vNew] = StaticVertex();
@@ -946,7 +1286,8 @@ dt::VertexId Mesh::createBudTopVertex(
 
 dt::EdgeId Mesh::createEdge(const dt::VertexId & v0, const dt::VertexId & v1)
 {
-   assert(m_edgeCount + 1 <= MBS_MAX_EDGE_COUNT);
+   bool ok = reserveEdges(m_edgeCount + 1);
+   assert(ok);
    size_t newEdge = m_edgeCount ++;
    m_edges[newEdge] = Edge(newEdgeLength(v0, v1));
    m_edgeMods.insertArrayElement(newEdge, sizeof(Edge));
@@ -960,15 +1301,54 @@ size_t Mesh::createTriangle(
    const dt::VertexId & v2
 )
 {
-   assert(m_triangleCount + 1 <= MBS_MAX_TRIANGLE_COUNT);
+   bool ok = reserveTriangles(m_triangleCount + 1);
+   assert(ok);
    size_t tNew = m_triangleCount ++;
    m_triangles[tNew] = Triangle(v0.get(), v1.get(), v2.get());
    m_triangleMods.insertArrayElement(tNew, sizeof(Triangle));
-   m_trianglesMap.insert(m_triangles[tNew], dt::TriangleId(tNew));
+   m_trianglesMap->insert(m_triangles[tNew], dt::TriangleId(tNew));
+   if (m_isTriangleGridValid)
+   {
+      m_triangleGrid.insert(
+         tNew,
+         m_dynamicVertices[v0.get()].point(),
+         m_dynamicVertices[v1.get()].point(),
+         m_dynamicVertices[v2.get()].point()
+      );
+   }
    return tNew;
 }
 
 
+bool Mesh::reserveVertices(size_t count)
+{
+   size_t staticCapacity = m_vertexCapacity;
+   if (!_reserve(m_staticVertices, staticCapacity, m_vertexCount, count,
+      MBS_MAX_VERTEX_COUNT))
+   {
+      return false;
+   }
+   _reserve(m_dynamicVertices, m_vertexCapacity, m_vertexCount, count,
+      MBS_MAX_VERTEX_COUNT);
+   assert(staticCapacity == m_vertexCapacity);
+   return true;
+}
+
+
+bool Mesh::reserveTriangles(size_t count)
+{
+   return _reserve(m_triangles, m_triangleCapacity, m_triangleCount, count,
+      MBS_MAX_TRIANGLE_COUNT);
+}
+
+
+bool Mesh::reserveEdges(size_t count)
+{
+   return _reserve(m_edges, m_edgeCapacity, m_edgeCount, count,
+      MBS_MAX_EDGE_COUNT);
+}
+
+
 void Mesh::removeAllConnections(const dt::VertexId & v)
 {
    GLint firstColor = m_staticVertices[v.get()].connection;
@@ -1094,13 +1474,18 @@ void Mesh::removeTriangle(const dt::TriangleId & t)
    size_t tLast = m_triangleCount - 1;
    assert(t.get() <= tLast);
 
+   if (m_isTriangleGridValid)
+   {
+      m_triangleGrid.remove(t.get());
+   }
+
    if (t.get() != tLast)
    {
       // Move last triangle to t position;
       moveLastTriangle(t);
    } else {
       // Clear last triangle;
-      bool ok = m_trianglesMap.remove(m_triangles[tLast]);
+      bool ok = m_trianglesMap->remove(m_triangles[tLast]);
       assert(ok);
       m_triangles[tLast] = Triangle();
       m_triangleMods.insertArrayElement(tLast, sizeof(Triangle));
@@ -1117,7 +1502,7 @@ void Mesh::moveLastVertex(const dt::VertexId & newIndex)
 
    // Replace vLast by newIndex in triangles;
    TrianglesMap replacedTriangles =
-      std::move(m_trianglesMap.replaceVertexIndex(vLast, newIndex.get()));
+      std::move(m_trianglesMap->replaceVertexIndex(vLast, newIndex.get()));
    TrianglesMap::const_iterator mapIt = replacedTriangles.begin();
    TrianglesMap::const_iterator mapIte = replacedTriangles.end();
    for (; mapIt != mapIte; ++mapIt)
@@ -1182,10 +1567,14 @@ void Mesh::moveLastTriangle(const dt::TriangleId & newId)
    size_t tLast = m_triangleCount - 1;
    assert(tLast != newId.get());
 
-   bool ok = m_trianglesMap.remove(m_triangles[newId.get()]);
+   bool ok = m_trianglesMap->remove(m_triangles[newId.get()]);
    assert(ok);
-   assert(m_trianglesMap.findAny(m_triangles[tLast]));
-   m_trianglesMap.replace(m_triangles[tLast], newId);
+   assert(m_trianglesMap->findAny(m_triangles[tLast]));
+   m_trianglesMap->replace(m_triangles[tLast], newId);
+   if (m_isTriangleGridValid)
+   {
+      m_triangleGrid.move(tLast, newId.get());
+   }
 
    m_triangles[newId.get()] = m_triangles[tLast];
    m_triangles[tLast] = Triangle();
@@ -1212,6 +1601,40 @@ void Mesh::setVertexSelected(const dt::VertexId & v, bool s)
 }
 
 
+void Mesh::rebuildTriangleGrid(const DynamicVertex * dv) const
+{
+   // Cells about the size of an average triangle keep both the number of
+   // cells per triangle and the number of triangles per cell small;
+   dt::Float extent = 0.0f;
+   for (size_t i = 0; i < m_triangleCount; ++i)
+   {
+      const Triangle & t = m_triangles[i];
+      const dt::Float xs[] = {dv[t.a].x, dv[t.b].x, dv[t.c].x};
+      const dt::Float ys[] = {dv[t.a].y, dv[t.b].y, dv[t.c].y};
+      const dt::Float zs[] = {dv[t.a].z, dv[t.b].z, dv[t.c].z};
+      extent += std::max(
+         *std::max_element(xs, xs + 3) - *std::min_element(xs, xs + 3),
+         std::max(
+            *std::max_element(ys, ys + 3) - *std::min_element(ys, ys + 3),
+            *std::max_element(zs, zs + 3) - *std::min_element(zs, zs + 3)
+         )
+      );
+   }
+   extent /= std::max<size_t>(1, m_triangleCount);
+   m_triangleGrid.reset((std::isfinite(extent) && extent > 0.0f) ?
+      extent : 1.0f);
+
+   for (size_t i = 0; i < m_triangleCount; ++i)
+   {
+      const Triangle & t = m_triangles[i];
+      m_triangleGrid.insert(i, dv[t.a].point(), dv[t.b].point(),
+         dv[t.c].point());
+   }
+   m_triangleGridSize = m_triangleCount;
+   m_isTriangleGridValid = true;
+}
+
+
 void Mesh::recalculateDimensions() const
 {
    if (m_vertexCount)
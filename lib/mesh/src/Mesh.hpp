@@ -32,6 +32,8 @@
 
 
 #include <boost/optional.hpp>
+#include <boost/shared_array.hpp>
+#include <boost/shared_ptr.hpp>
 
 
 #include "datatypes/geometry.hpp"
@@ -40,9 +42,11 @@
 
 
 #include "MemoryModification.hpp"
+#include "Relaxation.hpp"
 #include "StructureModification.hpp"
 #include "Tetrahedron.hpp"
 #include "Triangle.hpp"
+#include "TriangleGrid.hpp"
 #include "TrianglesMap.hpp"
 
 
@@ -51,6 +55,7 @@ namespace mesh {
 
 class Connections;
 class EdgeModifier;
+class SpringSolver;
 class VertexModifier;
 struct BuddingEdgeHelper;
 struct BuddingParams;
@@ -67,14 +72,25 @@ struct StaticVertex;
 class Mesh
 {
    public:
+      // Ids are 32-bit on both sides, storage grows on demand and the
+      // limits only bound the memory a runaway organism may take;
       enum MAX_BUFFER_SIZE
       {
-         MBS_MAX_VERTEX_COUNT = 4 + 16380,
-         MBS_MAX_TRIANGLE_COUNT = 4 + 2 * 16380,
-         MBS_MAX_EDGE_COUNT = 32768,
+         MBS_MAX_VERTEX_COUNT = 1 << 20,
+         MBS_MAX_TRIANGLE_COUNT = 2 * MBS_MAX_VERTEX_COUNT,
+         MBS_MAX_EDGE_COUNT = 4 * MBS_MAX_VERTEX_COUNT,
          MBS_MAX_CONNECTION_COUNT = 2 * MBS_MAX_EDGE_COUNT
       };
 
+      // Buffers start at these sizes and double on demand up to the maximum;
+      enum INITIAL_BUFFER_SIZE
+      {
+         IBS_VERTEX_COUNT = 64,
+         IBS_TRIANGLE_COUNT = 2 * IBS_VERTEX_COUNT,
+         IBS_EDGE_COUNT = 3 * IBS_VERTEX_COUNT,
+         IBS_CONNECTION_COUNT = 2 * IBS_EDGE_COUNT
+      };
+
       explicit Mesh(
          const dt::Pointf3 & a,
          const dt::Pointf3 & b,
@@ -83,6 +99,13 @@ class Mesh
       );
       virtual ~Mesh();
 
+      // A fork shares all of its storage with the original, each array is
+      // copied the first time either of them writes to it;
+      virtual Mesh * fork() const;
+
+      // Budding and relaxation shape developed figures, which are stored
+      // across sessions: changes to their results need a bump of
+      // bio::DEVELOPMENT_VERSION;
       virtual boost::optional<Tetrahedron> makeTetrahedronBud(
          const Tetrahedron & t,
          const BuddingParams & params
@@ -104,6 +127,11 @@ class Mesh
          dt::SelectionMode selectionMode = dt::SM_Vertex
       );
 
+      // One pass of the spring-mass model per iteration, the base version
+      // runs SpringSolver;
+      virtual void applyForces(size_t iterations = 1);
+      RelaxationStats relax(const RelaxationParams & params);
+
       virtual const DynamicVertex * dynamicVertices() const;
       inline const StaticVertex * staticVertices() const;
       inline const Triangle * triangles() const;
@@ -114,6 +142,10 @@ class Mesh
       inline size_t triangleCount() const;
       inline size_t edgeCount() const;
 
+      inline size_t vertexCapacity() const;
+      inline size_t triangleCapacity() const;
+      inline size_t edgeCapacity() const;
+
       inline const TrianglesMap & trianglesMap() const;
 
       inline const StructureModification & structureMods() const;
@@ -136,18 +168,47 @@ class Mesh
 
       dt::Float tetrahedronVolume(const Tetrahedron & t) const;
 
+      // Buds can only grow from surface faces, a face covered by another
+      // tetrahedron never returns to the surface;
+      bool isSurfaceFace(const Tetrahedron & t, dt::TetrahedronFace face) const;
+
       dt::Pointf3 center() const;
       dt::Vectorf3 dimensions() const;
 
    protected:
+      // Storage shared with forks, see detach();
+      enum SHARED_STORAGE
+      {
+         SS_DYNAMIC_VERTICES = 1 << 0,
+         SS_STATIC_VERTICES = 1 << 1,
+         SS_TRIANGLES = 1 << 2,
+         SS_EDGES = 1 << 3,
+         SS_CONNECTIONS = 1 << 4,
+         SS_TRIANGLES_MAP = 1 << 5,
+         SS_ALL = (1 << 6) - 1
+      };
+
+      // Forks start without pending memory modifications;
+      Mesh(const Mesh & other);
+
       inline const MemoryModification & dynamicVertexMods() const;
       inline const MemoryModification & staticVertexMods() const;
       inline const MemoryModification & triangleMods() const;
       inline const MemoryModification & edgeMods() const;
       void clearMemoryModifications();
       void invalidateDimensions();
+      void invalidateTriangleGrid();
+      void calculateNormals();
+      // A bud only changes the neighbourhoods of its own vertices;
+      void calculateNormals(const Tetrahedron & bud);
+      void storeDynamicVertices(const SpringSolver & solver);
+
+      // Copies the given storage unless this mesh is its only owner, every
+      // write has to be preceded by it;
+      void detach(int storage);
 
    private:
+      void calculateNormal(size_t v);
       void clearSelection();
       dt::Float newEdgeLength(
          const dt::VertexId & v1,
@@ -184,6 +245,10 @@ class Mesh
          const dt::VertexId & v1,
          const dt::VertexId & v2
       );
+      // Fail without changes beyond the MBS limits;
+      bool reserveVertices(size_t count);
+      bool reserveTriangles(size_t count);
+      bool reserveEdges(size_t count);
       void removeAllConnections(const dt::VertexId & v);
       bool removeConnection(
          const dt::VertexId & v,
@@ -200,18 +265,23 @@ class Mesh
       void setVertexSelected(const dt::VertexId & v, bool s);
 
       void recalculateDimensions() const;
+      void rebuildTriangleGrid(const DynamicVertex * dv) const;
 
-      DynamicVertex * m_dynamicVertices;
-      StaticVertex * m_staticVertices;
-      Triangle * m_triangles;
-      Edge * m_edges;
-      Connections * m_connections;
+      boost::shared_array<DynamicVertex> m_dynamicVertices;
+      boost::shared_array<StaticVertex> m_staticVertices;
+      boost::shared_array<Triangle> m_triangles;
+      boost::shared_array<Edge> m_edges;
+      boost::shared_ptr<Connections> m_connections;
 
       size_t m_vertexCount;
       size_t m_triangleCount;
       size_t m_edgeCount;
 
-      TrianglesMap m_trianglesMap;
+      size_t m_vertexCapacity;
+      size_t m_triangleCapacity;
+      size_t m_edgeCapacity;
+
+      boost::shared_ptr<TrianglesMap> m_trianglesMap;
 
       MemoryModification m_dynamicVertexMods;
       MemoryModification m_staticVertexMods;
@@ -223,24 +293,30 @@ class Mesh
 
       mutable boost::optional<dt::Pointf3> m_center;
       mutable boost::optional<dt::Vectorf3> m_dimensions;
+
+      // Built from the actual vertex positions on the first collision check
+      // and maintained by the triangle operations until vertices are moved;
+      mutable TriangleGrid m_triangleGrid;
+      mutable size_t m_triangleGridSize;
+      mutable bool m_isTriangleGridValid;
 };
 
 
 inline const StaticVertex * Mesh::staticVertices() const
 {
-   return m_staticVertices;
+   return m_staticVertices.get();
 }
 
 
 inline const Triangle * Mesh::triangles() const
 {
-   return m_triangles;
+   return m_triangles.get();
 }
 
 
 inline const Edge * Mesh::edges() const
 {
-   return m_edges;
+   return m_edges.get();
 }
 
 
@@ -268,9 +344,27 @@ inline size_t Mesh::edgeCount() const
 }
 
 
+inline size_t Mesh::vertexCapacity() const
+{
+   return m_vertexCapacity;
+}
+
+
+inline size_t Mesh::triangleCapacity() const
+{
+   return m_triangleCapacity;
+}
+
+
+inline size_t Mesh::edgeCapacity() const
+{
+   return m_edgeCapacity;
+}
+
+
 inline const TrianglesMap & Mesh::trianglesMap() const
 {
-   return m_trianglesMap;
+   return *m_trianglesMap;
 }
 
 
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <algorithm>
+
+
+#include "Relaxation.hpp"
+#include "Vertex.hpp"
+
+
+namespace {
+
+// Time step of feedback.glslv;
+const dt::Float _timeStep = 0.01f;
+
+} // anonymous namespace;
+
+
+namespace mesh {
+
+
+/***************************************************************************
+ *   RelaxationParams structure implementation                             *
+ ***************************************************************************/
+
+
+RelaxationParams::RelaxationParams()
+   : maxIterations(20000),
+   batchSize(100),
+   maxKineticEnergy(1e-6f),
+   maxDisplacement(1e-6f)
+{
+}
+
+
+/***************************************************************************
+ *   RelaxationStats structure implementation                              *
+ ***************************************************************************/
+
+
+RelaxationStats::RelaxationStats()
+   : iterations(0),
+   batches(0),
+   isConverged(false),
+   kineticEnergy(0.0f),
+   maxDisplacement(0.0f),
+   seconds(0.0)
+{
+}
+
+
+RelaxationStats & RelaxationStats::operator+=(const RelaxationStats & other)
+{
+   iterations += other.iterations;
+   batches += other.batches;
+   isConverged = other.isConverged;
+   kineticEnergy = other.kineticEnergy;
+   maxDisplacement = other.maxDisplacement;
+   seconds += other.seconds;
+   return *this;
+}
+
+
+double RelaxationStats::iterationsPerSecond() const
+{
+   return seconds > 0.0 ? iterations / seconds : 0.0;
+}
+
+
+std::ostream & operator<<(std::ostream & os, const RelaxationStats & stats)
+{
+   os << "{iterations: " << stats.iterations <<
+      ", batches: " << stats.batches <<
+      ", kinetic energy: " << stats.kineticEnergy <<
+      ", max displacement: " << stats.maxDisplacement <<
+      ", iterations/s: " << stats.iterationsPerSecond();
+   if (stats.isConverged) os << ", converged";
+   os << "}";
+   return os;
+}
+
+
+void measureMotion(
+   const DynamicVertex * vertices,
+   size_t count,
+   RelaxationStats & stats
+)
+{
+   dt::Float kineticEnergy = 0.0f;
+   dt::Float maxSpeed = 0.0f;
+   for (size_t i = 0; i < count; ++i)
+   {
+      const dt::Float speed = vertices[i].speed();
+      kineticEnergy += 0.5f * vertices[i].mass * speed * speed;
+      maxSpeed = std::max(maxSpeed, speed);
+   }
+   stats.kineticEnergy = kineticEnergy;
+   stats.maxDisplacement = maxSpeed * _timeStep;
+}
+
+
+}
@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_RELAXATION_H
+#define MESH_RELAXATION_H
+
+
+#include <cstdlib>
+#include <ostream>
+
+
+#include "datatypes/geometry.hpp"
+
+
+namespace mesh {
+
+
+struct DynamicVertex;
+
+
+/***************************************************************************
+ *   RelaxationParams structure declaration                                *
+ ***************************************************************************/
+
+
+// Forces are applied batchSize iterations at a time, the motion is only
+// measured between batches. Relaxation stops once either the kinetic
+// energy or the largest displacement of a vertex per iteration drops to
+// its threshold, or after maxIterations;
+struct RelaxationParams
+{
+   explicit RelaxationParams();
+
+   size_t maxIterations;
+   size_t batchSize;
+   dt::Float maxKineticEnergy;
+   dt::Float maxDisplacement;
+};
+
+
+/***************************************************************************
+ *   RelaxationStats structure declaration                                 *
+ ***************************************************************************/
+
+
+struct RelaxationStats
+{
+   explicit RelaxationStats();
+
+   // Kinetic energy and displacement of the last measurement, the rest is
+   // accumulated;
+   RelaxationStats & operator+=(const RelaxationStats & other);
+
+   double iterationsPerSecond() const;
+
+   size_t iterations;
+   size_t batches;
+   bool isConverged;
+   dt::Float kineticEnergy;
+   dt::Float maxDisplacement;
+   double seconds;
+};
+
+
+std::ostream & operator<<(std::ostream & os, const RelaxationStats & stats);
+
+
+// Updates kinetic energy and displacement of the stats;
+void measureMotion(
+   const DynamicVertex * vertices,
+   size_t count,
+   RelaxationStats & stats
+);
+
+
+}
+
+
+#endif
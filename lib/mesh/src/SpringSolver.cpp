@@ -0,0 +1,459 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+#include "Connections.hpp"
+#include "Edge.hpp"
+#include "Mesh.hpp"
+#include "SpringSolver.hpp"
+#include "Vertex.hpp"
+
+
+namespace {
+
+// Smaller meshes are not worth waking up threads for;
+const size_t _minVerticesPerThread = 4096;
+
+
+// GLSL length() of a vector is the number of its components, not its
+// magnitude, so safeNormalize() of the shader divides by 3. The solver
+// reproduces that;
+const dt::Float _safeNormalizeDivisor = 3.0f;
+
+
+const dt::Float _damping = 0.25f;
+const dt::Float _timeStep = 0.01f;
+
+
+class _Barrier
+{
+   public:
+      explicit _Barrier(size_t count)
+         : m_count(count), m_waiting(0), m_generation(0)
+      {
+      }
+
+      void wait()
+      {
+         std::unique_lock<std::mutex> lock(m_mutex);
+         const size_t generation = m_generation;
+         if (++m_waiting == m_count)
+         {
+            m_waiting = 0;
+            ++m_generation;
+            m_condition.notify_all();
+         }
+         else
+         {
+            while (generation == m_generation)
+            {
+               m_condition.wait(lock);
+            }
+         }
+      }
+
+   private:
+      std::mutex m_mutex;
+      std::condition_variable m_condition;
+      const size_t m_count;
+      size_t m_waiting;
+      size_t m_generation;
+};
+
+
+// Spring of owner O, neighbor N and previous P: force along NO scaled by
+// the stretch, normal of OPN triangle;
+inline void _evaluateSpring(
+   dt::Float ox, dt::Float oy, dt::Float oz,
+   dt::Float nx, dt::Float ny, dt::Float nz,
+   dt::Float px, dt::Float py, dt::Float pz,
+   dt::Float length,
+   dt::Float * force,
+   dt::Float * normal
+)
+{
+   const dt::Float dx = ox - nx;
+   const dt::Float dy = oy - ny;
+   const dt::Float dz = oz - nz;
+   const dt::Float dl = length - std::sqrt(dx * dx + dy * dy + dz * dz);
+   force[0] = (dx / _safeNormalizeDivisor) * dl;
+   force[1] = (dy / _safeNormalizeDivisor) * dl;
+   force[2] = (dz / _safeNormalizeDivisor) * dl;
+
+   const dt::Float v1x = px - ox, v1y = py - oy, v1z = pz - oz;
+   const dt::Float v2x = nx - ox, v2y = ny - oy, v2z = nz - oz;
+   normal[0] = (v1y * v2z - v1z * v2y) / _safeNormalizeDivisor;
+   normal[1] = (v1z * v2x - v1x * v2z) / _safeNormalizeDivisor;
+   normal[2] = (v1x * v2y - v1y * v2x) / _safeNormalizeDivisor;
+}
+
+} // anonymous namespace;
+
+
+namespace mesh {
+
+
+/***************************************************************************
+ *   SpringSolver class implementation                                     *
+ ***************************************************************************/
+
+
+SpringSolver::SpringSolver()
+   : m_current(0),
+   m_rowStart(1, 0),
+   m_threadCount(0)
+{
+}
+
+
+void SpringSolver::load(const Mesh & mesh)
+{
+   const size_t vertexCount = mesh.vertexCount();
+   const DynamicVertex * dv = mesh.dynamicVertices();
+   const StaticVertex * sv = mesh.staticVertices();
+   const Edge * edges = mesh.edges();
+   const Connections & connections = mesh.connections();
+
+   m_current = 0;
+   for (int i = 0; i < 2; ++i)
+   {
+      m_x[i].resize(vertexCount);
+      m_y[i].resize(vertexCount);
+      m_z[i].resize(vertexCount);
+      m_vx[i].resize(vertexCount);
+      m_vy[i].resize(vertexCount);
+      m_vz[i].resize(vertexCount);
+   }
+   m_mass.resize(vertexCount);
+   m_nx.resize(vertexCount);
+   m_ny.resize(vertexCount);
+   m_nz.resize(vertexCount);
+   for (size_t v = 0; v < vertexCount; ++v)
+   {
+      m_x[0][v] = dv[v].x;
+      m_y[0][v] = dv[v].y;
+      m_z[0][v] = dv[v].z;
+      m_vx[0][v] = dv[v].vx;
+      m_vy[0][v] = dv[v].vy;
+      m_vz[0][v] = dv[v].vz;
+      m_mass[v] = dv[v].mass;
+      m_nx[v] = dv[v].nx;
+      m_ny[v] = dv[v].ny;
+      m_nz[v] = dv[v].nz;
+   }
+
+   // Same walk as getNormalsSum() of the shader: every entry after the
+   // first one is a spring, the normal is accumulated until the first
+   // internal entry, the list is closed by a spring to the first entry;
+   m_rowStart.assign(1, 0);
+   m_owner.clear();
+   m_neighbor.clear();
+   m_previous.clear();
+   m_length.clear();
+   for (size_t v = 0; v < vertexCount; ++v)
+   {
+      Connections::const_iterator it = connections.begin(sv[v].connection);
+      if (it.isValid())
+      {
+         const GLint first = it.get(Connections::VT_VERTEX);
+         const GLint firstEdge = it.get(Connections::VT_EDGE);
+         GLint prev = first;
+         GLint lastExternal = first;
+         bool adjustNormal = true;
+         for (++it; it.isValid(); ++it)
+         {
+            const GLint curr = it.get(Connections::VT_VERTEX);
+            if (it.get(Connections::VT_INTERNAL) > 0)
+            {
+               adjustNormal = false;
+            }
+            m_owner.push_back(v);
+            m_neighbor.push_back(curr);
+            m_previous.push_back(adjustNormal ? prev : v);
+            m_length.push_back(
+               edges[it.get(Connections::VT_EDGE)].equilibriumLength
+            );
+            prev = curr;
+            if (adjustNormal)
+            {
+               lastExternal = curr;
+            }
+         }
+
+         if (lastExternal != first)
+         {
+            m_owner.push_back(v);
+            m_neighbor.push_back(first);
+            m_previous.push_back(lastExternal);
+            m_length.push_back(edges[firstEdge].equilibriumLength);
+         }
+      }
+      m_rowStart.push_back(m_neighbor.size());
+   }
+
+   for (int i = 0; i < SA_COUNT; ++i)
+   {
+      m_springs[i].resize(m_neighbor.size());
+   }
+}
+
+
+void SpringSolver::step(bool applyForces, size_t count)
+{
+   const size_t vertexCount = this->vertexCount();
+   size_t threadCount = std::min(m_threadCount, vertexCount);
+   if (!m_threadCount)
+   {
+      threadCount = std::min<size_t>(
+         std::thread::hardware_concurrency(),
+         vertexCount / _minVerticesPerThread
+      );
+   }
+   threadCount = std::max<size_t>(threadCount, 1);
+
+   // Positions are only swapped when they change;
+   const size_t swaps = applyForces ? 1 : 0;
+   if (threadCount == 1)
+   {
+      for (size_t i = 0; i < count; ++i)
+      {
+         stepRange(0, vertexCount, (m_current + i * swaps) % 2, applyForces);
+      }
+   }
+   else
+   {
+      // Threads own a range of vertices each and meet after every step,
+      // as the next one reads positions of the others;
+      _Barrier barrier(threadCount);
+      std::vector<std::thread> threads;
+      for (size_t t = 0; t < threadCount; ++t)
+      {
+         const size_t begin = vertexCount * t / threadCount;
+         const size_t end = vertexCount * (t + 1) / threadCount;
+         threads.push_back(std::thread([=, &barrier]() {
+            for (size_t i = 0; i < count; ++i)
+            {
+               const size_t current = (m_current + i * swaps) % 2;
+               stepRange(begin, end, current, applyForces);
+               barrier.wait();
+            }
+         }));
+      }
+      for (size_t t = 0; t < threadCount; ++t)
+      {
+         threads[t].join();
+      }
+   }
+
+   m_current = (m_current + count * swaps) % 2;
+}
+
+
+void SpringSolver::store(DynamicVertex * vertices) const
+{
+   for (size_t v = 0, count = vertexCount(); v < count; ++v)
+   {
+      DynamicVertex & dv = vertices[v];
+      dv.x = m_x[m_current][v];
+      dv.y = m_y[m_current][v];
+      dv.z = m_z[m_current][v];
+      dv.nx = m_nx[v];
+      dv.ny = m_ny[v];
+      dv.nz = m_nz[v];
+      dv.vx = m_vx[m_current][v];
+      dv.vy = m_vy[m_current][v];
+      dv.vz = m_vz[m_current][v];
+   }
+}
+
+
+void SpringSolver::stepRange(
+   size_t begin,
+   size_t end,
+   size_t current,
+   bool applyForces
+)
+{
+   evaluateSprings(m_rowStart[begin], m_rowStart[end], current);
+
+   const size_t next = 1 - current;
+   const dt::Float * fx = m_springs[SA_FORCE_X].data();
+   const dt::Float * fy = m_springs[SA_FORCE_Y].data();
+   const dt::Float * fz = m_springs[SA_FORCE_Z].data();
+   const dt::Float * nx = m_springs[SA_NORMAL_X].data();
+   const dt::Float * ny = m_springs[SA_NORMAL_Y].data();
+   const dt::Float * nz = m_springs[SA_NORMAL_Z].data();
+   for (size_t v = begin; v < end; ++v)
+   {
+      dt::Float forceX = 0.0f, forceY = 0.0f, forceZ = 0.0f;
+      dt::Float normalX = 0.0f, normalY = 0.0f, normalZ = 0.0f;
+      for (size_t s = m_rowStart[v]; s < m_rowStart[v + 1]; ++s)
+      {
+         forceX += fx[s];
+         forceY += fy[s];
+         forceZ += fz[s];
+         normalX += nx[s];
+         normalY += ny[s];
+         normalZ += nz[s];
+      }
+
+      if (applyForces)
+      {
+         const dt::Float vx = m_vx[current][v];
+         const dt::Float vy = m_vy[current][v];
+         const dt::Float vz = m_vz[current][v];
+         forceX -= _damping * vx;
+         forceY -= _damping * vy;
+         forceZ -= _damping * vz;
+         m_x[next][v] = m_x[current][v] + vx * _timeStep;
+         m_y[next][v] = m_y[current][v] + vy * _timeStep;
+         m_z[next][v] = m_z[current][v] + vz * _timeStep;
+         m_vx[next][v] = vx + (forceX / m_mass[v]) * _timeStep;
+         m_vy[next][v] = vy + (forceY / m_mass[v]) * _timeStep;
+         m_vz[next][v] = vz + (forceZ / m_mass[v]) * _timeStep;
+      }
+
+      m_nx[v] = normalX / _safeNormalizeDivisor;
+      m_ny[v] = normalY / _safeNormalizeDivisor;
+      m_nz[v] = normalZ / _safeNormalizeDivisor;
+   }
+}
+
+
+void SpringSolver::evaluateSprings(size_t begin, size_t end, size_t current)
+{
+   dt::Float * springs[SA_COUNT];
+   for (int i = 0; i < SA_COUNT; ++i)
+   {
+      springs[i] = m_springs[i].data();
+   }
+
+   // Gather, the only random access part;
+   const dt::Float * x = m_x[current].data();
+   const dt::Float * y = m_y[current].data();
+   const dt::Float * z = m_z[current].data();
+   for (size_t i = begin; i < end; ++i)
+   {
+      const uint32_t o = m_owner[i];
+      const uint32_t n = m_neighbor[i];
+      const uint32_t p = m_previous[i];
+      springs[SA_OX][i] = x[o];
+      springs[SA_OY][i] = y[o];
+      springs[SA_OZ][i] = z[o];
+      springs[SA_NX][i] = x[n];
+      springs[SA_NY][i] = y[n];
+      springs[SA_NZ][i] = z[n];
+      springs[SA_PX][i] = x[p];
+      springs[SA_PY][i] = y[p];
+      springs[SA_PZ][i] = z[p];
+   }
+
+   const dt::Float * length = m_length.data();
+   size_t i = begin;
+#ifdef __SSE2__
+   const __m128 divisor = _mm_set1_ps(_safeNormalizeDivisor);
+   for (; i + 4 <= end; i += 4)
+   {
+      const __m128 ox = _mm_loadu_ps(springs[SA_OX] + i);
+      const __m128 oy = _mm_loadu_ps(springs[SA_OY] + i);
+      const __m128 oz = _mm_loadu_ps(springs[SA_OZ] + i);
+      const __m128 nx = _mm_loadu_ps(springs[SA_NX] + i);
+      const __m128 ny = _mm_loadu_ps(springs[SA_NY] + i);
+      const __m128 nz = _mm_loadu_ps(springs[SA_NZ] + i);
+
+      const __m128 dx = _mm_sub_ps(ox, nx);
+      const __m128 dy = _mm_sub_ps(oy, ny);
+      const __m128 dz = _mm_sub_ps(oz, nz);
+      const __m128 dl = _mm_sub_ps(
+         _mm_loadu_ps(length + i),
+         _mm_sqrt_ps(_mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+            _mm_mul_ps(dz, dz)
+         ))
+      );
+      _mm_storeu_ps(
+         springs[SA_FORCE_X] + i,
+         _mm_mul_ps(_mm_div_ps(dx, divisor), dl)
+      );
+      _mm_storeu_ps(
+         springs[SA_FORCE_Y] + i,
+         _mm_mul_ps(_mm_div_ps(dy, divisor), dl)
+      );
+      _mm_storeu_ps(
+         springs[SA_FORCE_Z] + i,
+         _mm_mul_ps(_mm_div_ps(dz, divisor), dl)
+      );
+
+      const __m128 v1x = _mm_sub_ps(_mm_loadu_ps(springs[SA_PX] + i), ox);
+      const __m128 v1y = _mm_sub_ps(_mm_loadu_ps(springs[SA_PY] + i), oy);
+      const __m128 v1z = _mm_sub_ps(_mm_loadu_ps(springs[SA_PZ] + i), oz);
+      const __m128 v2x = _mm_sub_ps(nx, ox);
+      const __m128 v2y = _mm_sub_ps(ny, oy);
+      const __m128 v2z = _mm_sub_ps(nz, oz);
+      _mm_storeu_ps(springs[SA_NORMAL_X] + i, _mm_div_ps(_mm_sub_ps(
+         _mm_mul_ps(v1y, v2z),
+         _mm_mul_ps(v1z, v2y)
+      ), divisor));
+      _mm_storeu_ps(springs[SA_NORMAL_Y] + i, _mm_div_ps(_mm_sub_ps(
+         _mm_mul_ps(v1z, v2x),
+         _mm_mul_ps(v1x, v2z)
+      ), divisor));
+      _mm_storeu_ps(springs[SA_NORMAL_Z] + i, _mm_div_ps(_mm_sub_ps(
+         _mm_mul_ps(v1x, v2y),
+         _mm_mul_ps(v1y, v2x)
+      ), divisor));
+   }
+#endif
+   for (; i < end; ++i)
+   {
+      dt::Float force[3];
+      dt::Float normal[3];
+      _evaluateSpring(
+         springs[SA_OX][i], springs[SA_OY][i], springs[SA_OZ][i],
+         springs[SA_NX][i], springs[SA_NY][i], springs[SA_NZ][i],
+         springs[SA_PX][i], springs[SA_PY][i], springs[SA_PZ][i],
+         length[i],
+         force,
+         normal
+      );
+      springs[SA_FORCE_X][i] = force[0];
+      springs[SA_FORCE_Y][i] = force[1];
+      springs[SA_FORCE_Z][i] = force[2];
+      springs[SA_NORMAL_X][i] = normal[0];
+      springs[SA_NORMAL_Y][i] = normal[1];
+      springs[SA_NORMAL_Z][i] = normal[2];
+   }
+}
+
+
+}
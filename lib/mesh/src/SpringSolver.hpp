@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_SPRINGSOLVER_H
+#define MESH_SPRINGSOLVER_H
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+
+#include "datatypes/geometry.hpp"
+
+
+namespace mesh {
+
+
+class Mesh;
+struct DynamicVertex;
+
+
+/***************************************************************************
+ *   SpringSolver class declaration                                        *
+ ***************************************************************************/
+
+
+// CPU counterpart of feedback.glslv. Vertices are copied into separate
+// arrays per coordinate, the connection lists are flattened into rows of
+// springs, one row per vertex, in the order the shader walks them. A step
+// gathers the spring ends, evaluates all the springs of a range of
+// vertices four at a time, sums them up per vertex and integrates. Ranges
+// of vertices are stepped on several threads;
+class SpringSolver
+{
+   public:
+      explicit SpringSolver();
+
+      inline size_t vertexCount() const {return m_rowStart.size() - 1;}
+      inline size_t springCount() const {return m_neighbor.size();}
+
+      // Zero means as many as the hardware runs, but only for meshes large
+      // enough to benefit from them;
+      inline size_t threadCount() const {return m_threadCount;}
+      inline void setThreadCount(size_t count) {m_threadCount = count;}
+
+      // Takes a copy of the vertices, edges and connections of the mesh;
+      void load(const Mesh & mesh);
+
+      // Same as count passes of the shader;
+      void step(bool applyForces, size_t count = 1);
+
+      // Positions, normals and velocities, other fields are left as is;
+      void store(DynamicVertex * vertices) const;
+
+   private:
+      void stepRange(
+         size_t begin,
+         size_t end,
+         size_t current,
+         bool applyForces
+      );
+      void evaluateSprings(size_t begin, size_t end, size_t current);
+
+      // Vertices, positions and velocities are double buffered;
+      std::vector<dt::Float> m_x[2];
+      std::vector<dt::Float> m_y[2];
+      std::vector<dt::Float> m_z[2];
+      std::vector<dt::Float> m_vx[2];
+      std::vector<dt::Float> m_vy[2];
+      std::vector<dt::Float> m_vz[2];
+      std::vector<dt::Float> m_mass;
+      std::vector<dt::Float> m_nx;
+      std::vector<dt::Float> m_ny;
+      std::vector<dt::Float> m_nz;
+      size_t m_current;
+
+      // Springs of vertex v are [m_rowStart[v], m_rowStart[v + 1]). The
+      // normal of a spring is the one of the triangle of owner, previous
+      // and neighbor, previous is the owner itself when the shader skips
+      // the normal;
+      std::vector<uint32_t> m_rowStart;
+      std::vector<uint32_t> m_owner;
+      std::vector<uint32_t> m_neighbor;
+      std::vector<uint32_t> m_previous;
+      std::vector<dt::Float> m_length;
+
+      // Per spring scratch, gathered positions and results;
+      enum SpringArray
+      {
+         SA_OX = 0, SA_OY, SA_OZ,
+         SA_NX, SA_NY, SA_NZ,
+         SA_PX, SA_PY, SA_PZ,
+         SA_FORCE_X, SA_FORCE_Y, SA_FORCE_Z,
+         SA_NORMAL_X, SA_NORMAL_Y, SA_NORMAL_Z,
+         SA_COUNT
+      };
+      std::vector<dt::Float> m_springs[SA_COUNT];
+
+      size_t m_threadCount;
+};
+
+
+}
+
+
+#endif
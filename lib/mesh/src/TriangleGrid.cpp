@@ -0,0 +1,212 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+#include "TriangleGrid.hpp"
+
+
+namespace {
+
+// Cell coordinates are packed into 21 bits each;
+const int32_t _coordMask = (1 << 21) - 1;
+
+
+uint64_t _key(int32_t x, int32_t y, int32_t z)
+{
+   return (static_cast<uint64_t>(x & _coordMask) << 42) |
+      (static_cast<uint64_t>(y & _coordMask) << 21) |
+      static_cast<uint64_t>(z & _coordMask);
+}
+
+
+int32_t _cellIndex(dt::Float coord, dt::Float cellSize)
+{
+   const dt::Float index = std::floor(coord / cellSize);
+   const dt::Float limit = static_cast<dt::Float>(_coordMask >> 1);
+   return static_cast<int32_t>(std::max(-limit, std::min(limit, index)));
+}
+
+} // anonymous namespace;
+
+
+namespace mesh {
+
+
+/***************************************************************************
+ *   TriangleGrid class implementation                                     *
+ ***************************************************************************/
+
+
+TriangleGrid::TriangleGrid()
+   : m_cellSize(1.0f)
+{
+}
+
+
+void TriangleGrid::reset(dt::Float cellSize)
+{
+   assert(cellSize > 0.0f);
+   m_cellSize = cellSize;
+   m_cells.clear();
+   m_bounds.clear();
+   m_isInserted.clear();
+}
+
+
+void TriangleGrid::insert(
+   size_t t,
+   const dt::Pointf3 & a,
+   const dt::Pointf3 & b,
+   const dt::Pointf3 & c
+)
+{
+   if (t >= m_bounds.size())
+   {
+      m_bounds.resize(t + 1);
+      m_isInserted.resize(t + 1, false);
+   }
+   assert(!m_isInserted[t]);
+
+   const Bounds & tb = m_bounds[t] = bounds(
+      dt::Pointf3(
+         std::min(a.x, std::min(b.x, c.x)),
+         std::min(a.y, std::min(b.y, c.y)),
+         std::min(a.z, std::min(b.z, c.z))
+      ),
+      dt::Pointf3(
+         std::max(a.x, std::max(b.x, c.x)),
+         std::max(a.y, std::max(b.y, c.y)),
+         std::max(a.z, std::max(b.z, c.z))
+      )
+   );
+   m_isInserted[t] = true;
+
+   for (uint64_t key : cellKeys(tb))
+   {
+      m_cells[key].push_back(t);
+   }
+}
+
+
+void TriangleGrid::remove(size_t t)
+{
+   assert(t < m_bounds.size() && m_isInserted[t]);
+   for (uint64_t key : cellKeys(m_bounds[t]))
+   {
+      auto it = m_cells.find(key);
+      assert(it != m_cells.end());
+      std::vector<size_t> & cell = it->second;
+      auto pos = std::find(cell.begin(), cell.end(), t);
+      assert(pos != cell.end());
+      *pos = cell.back();
+      cell.pop_back();
+      if (cell.empty())
+      {
+         m_cells.erase(it);
+      }
+   }
+   m_isInserted[t] = false;
+}
+
+
+void TriangleGrid::move(size_t from, size_t to)
+{
+   assert(from < m_bounds.size() && m_isInserted[from]);
+   if (to >= m_bounds.size())
+   {
+      m_bounds.resize(to + 1);
+      m_isInserted.resize(to + 1, false);
+   }
+   assert(!m_isInserted[to]);
+
+   for (uint64_t key : cellKeys(m_bounds[from]))
+   {
+      std::vector<size_t> & cell = m_cells[key];
+      auto pos = std::find(cell.begin(), cell.end(), from);
+      assert(pos != cell.end());
+      *pos = to;
+   }
+   m_bounds[to] = m_bounds[from];
+   m_isInserted[to] = true;
+   m_isInserted[from] = false;
+}
+
+
+std::vector<size_t> TriangleGrid::find(
+   const dt::Pointf3 & min,
+   const dt::Pointf3 & max
+) const
+{
+   std::vector<size_t> result;
+   for (uint64_t key : cellKeys(bounds(min, max)))
+   {
+      auto it = m_cells.find(key);
+      if (it != m_cells.end())
+      {
+         result.insert(result.end(), it->second.begin(), it->second.end());
+      }
+   }
+   std::sort(result.begin(), result.end());
+   result.erase(std::unique(result.begin(), result.end()), result.end());
+   return result;
+}
+
+
+TriangleGrid::Bounds TriangleGrid::bounds(
+   const dt::Pointf3 & min,
+   const dt::Pointf3 & max
+) const
+{
+   // Widen by a fraction of a cell, so touching boxes always share a cell;
+   const dt::Float margin = 0.01f * m_cellSize;
+   Bounds result;
+   result.min[0] = _cellIndex(min.x - margin, m_cellSize);
+   result.min[1] = _cellIndex(min.y - margin, m_cellSize);
+   result.min[2] = _cellIndex(min.z - margin, m_cellSize);
+   result.max[0] = _cellIndex(max.x + margin, m_cellSize);
+   result.max[1] = _cellIndex(max.y + margin, m_cellSize);
+   result.max[2] = _cellIndex(max.z + margin, m_cellSize);
+   return result;
+}
+
+
+std::vector<uint64_t> TriangleGrid::cellKeys(const Bounds & bounds) const
+{
+   std::vector<uint64_t> result;
+   for (int32_t x = bounds.min[0]; x <= bounds.max[0]; ++x)
+   {
+      for (int32_t y = bounds.min[1]; y <= bounds.max[1]; ++y)
+      {
+         for (int32_t z = bounds.min[2]; z <= bounds.max[2]; ++z)
+         {
+            result.push_back(_key(x, y, z));
+         }
+      }
+   }
+   return result;
+}
+
+
+}
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef MESH_TRIANGLEGRID_H
+#define MESH_TRIANGLEGRID_H
+
+
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+
+#include "datatypes/geometry.hpp"
+
+
+namespace mesh {
+
+
+/***************************************************************************
+ *   TriangleGrid class declaration                                        *
+ ***************************************************************************/
+
+
+// Uniform grid of cubic cells over the axis-aligned bounding boxes of
+// triangles. A triangle is registered in every cell its box overlaps, so
+// all the triangles whose boxes overlap a query box share a cell with it;
+class TriangleGrid
+{
+   public:
+      explicit TriangleGrid();
+
+      inline dt::Float cellSize() const {return m_cellSize;}
+
+      void reset(dt::Float cellSize);
+
+      void insert(
+         size_t t,
+         const dt::Pointf3 & a,
+         const dt::Pointf3 & b,
+         const dt::Pointf3 & c
+      );
+      void remove(size_t t);
+      void move(size_t from, size_t to);
+
+      // Triangles whose boxes may overlap the box, in ascending order;
+      std::vector<size_t> find(
+         const dt::Pointf3 & min,
+         const dt::Pointf3 & max
+      ) const;
+
+   private:
+      struct Bounds
+      {
+         int32_t min[3];
+         int32_t max[3];
+      };
+
+      Bounds bounds(const dt::Pointf3 & min, const dt::Pointf3 & max) const;
+      std::vector<uint64_t> cellKeys(const Bounds & bounds) const;
+
+      dt::Float m_cellSize;
+      std::unordered_map<uint64_t, std::vector<size_t> > m_cells;
+      std::vector<Bounds> m_bounds;
+      std::vector<bool> m_isInserted;
+};
+
+
+}
+
+
+#endif
@@ -34,6 +34,12 @@ TrianglesMap::TrianglesMap()
 }
 
 
+TrianglesMap::TrianglesMap(const TrianglesMap & other)
+   : m_map(other.m_map)
+{
+}
+
+
 TrianglesMap::TrianglesMap(TrianglesMap && other)
    : m_map(std::move(other.m_map))
 {
@@ -52,6 +52,7 @@ class TrianglesMap
 
       explicit TrianglesMap();
 
+      TrianglesMap(const TrianglesMap & other);
       TrianglesMap(TrianglesMap && other);
 
       TrianglesMap & operator=(TrianglesMap && other);
@@ -42,12 +42,12 @@ BOOST_AUTO_TEST_SUITE(suite_libmesh_ColorWrappedLists)
 
 BOOST_AUTO_TEST_CASE(test_constructor)
 {
-   ColorWrappedLists lists1x4(1, ColorWrappedLists::CC_RGBA);
+   ColorWrappedLists lists1x4(1, ColorWrappedLists::CC_RGBA, 16);
    int target1x4[] = {
       -1, -1, -1, -1
    };
 
-   ColorWrappedLists lists5x3(5, ColorWrappedLists::CC_RGB);
+   ColorWrappedLists lists5x3(5, ColorWrappedLists::CC_RGB, 16);
    int target5x3[] = {
       -1, -1, 1,
       -1, -1, 2,
@@ -96,7 +96,7 @@ BOOST_AUTO_TEST_CASE(test_constructor)
 
 BOOST_AUTO_TEST_CASE(test_createFirstColor)
 {
-   ColorWrappedLists lists(5, ColorWrappedLists::CC_RGB);
+   ColorWrappedLists lists(5, ColorWrappedLists::CC_RGB, 16);
 
    lists.startMemoryModificationLogging();
    ColorWrappedLists::iterator it = lists.createFirstColor();
@@ -204,15 +204,35 @@ BOOST_AUTO_TEST_CASE(test_createFirstColor)
 
    lists.startMemoryModificationLogging();
    it = lists.createFirstColor();
-   BOOST_REQUIRE(!it.isValid());
+   it.set(0, 40);
+   it.set(1, 41);
+   BOOST_REQUIRE(it.isValid());
+   BOOST_REQUIRE(it.color() == 5);
+   BOOST_REQUIRE(lists.colorCount() == 10);
+   BOOST_REQUIRE(lists.firstFreeColor() == 6);
    lists.stopMemoryModificationLogging();
 
-   if (!lists.memoryModification()->empty())
+   MemoryModification m4;
+   m4.insertArrayElement(5, sizeof(GLint) * lists.colorComponents());
+   if (*lists.memoryModification() != m4)
    {
       BOOST_FAIL(_modAccountingFailedMsg);
    }
 
-   if (memcmp(lists.data(), target3, sizeof(target3)))
+   int target4[] = {
+      10, 11, -1,
+      20, 21, 2,
+      22, 23, 3,
+      24, 25, -1,
+      30, 31, -1,
+      40, 41, -1,
+      -1, -1, 7,
+      -1, -1, 8,
+      -1, -1, 9,
+      -1, -1, -1
+   };
+
+   if (memcmp(lists.data(), target4, sizeof(target4)))
    {
       BOOST_FAIL("ColorWrappedLists(5, 3) contains wrong data "
          "after creating first color when container is full");
@@ -222,7 +242,7 @@ BOOST_AUTO_TEST_CASE(test_createFirstColor)
 
 BOOST_AUTO_TEST_CASE(test_removeFirst)
 {
-   ColorWrappedLists lists(5, ColorWrappedLists::CC_RGB);
+   ColorWrappedLists lists(5, ColorWrappedLists::CC_RGB, 16);
 
    ColorWrappedLists::iterator it = lists.createFirstColor();
    GLint firstColor1 = it.color();
@@ -388,7 +408,7 @@ BOOST_AUTO_TEST_CASE(test_removeFirst)
 
 BOOST_AUTO_TEST_CASE(test_removeAfter)
 {
-   ColorWrappedLists lists(5, ColorWrappedLists::CC_RGB);
+   ColorWrappedLists lists(5, ColorWrappedLists::CC_RGB, 16);
 
    ColorWrappedLists::iterator it = lists.createFirstColor();
    GLint firstColor = it.color();
@@ -498,7 +518,7 @@ BOOST_AUTO_TEST_CASE(test_removeAfter)
 
 BOOST_AUTO_TEST_CASE(test_removeAll)
 {
-   ColorWrappedLists lists(4, ColorWrappedLists::CC_RGB);
+   ColorWrappedLists lists(4, ColorWrappedLists::CC_RGB, 16);
 
    ColorWrappedLists::iterator it = lists.createFirstColor();
    it.set(0, 0);
@@ -545,4 +565,72 @@ BOOST_AUTO_TEST_CASE(test_removeAll)
 }
 
 
+BOOST_AUTO_TEST_CASE(test_maxColorCount)
+{
+   ColorWrappedLists lists(2, ColorWrappedLists::CC_RGB, 5);
+
+   ColorWrappedLists::iterator it = lists.createFirstColor();
+   for (GLint color = 1; color < 5; color ++)
+   {
+      it = lists.insertAfter(it);
+      BOOST_REQUIRE(it.isValid());
+      BOOST_REQUIRE(it.color() == color);
+   }
+   BOOST_REQUIRE(lists.colorCount() == 5);
+
+   // Full at the maximum, nothing is changed by the failed attempts;
+   BOOST_REQUIRE(!lists.insertAfter(it).isValid());
+   BOOST_REQUIRE(!lists.createFirstColor().isValid());
+   BOOST_REQUIRE(!lists.reserve(6));
+   BOOST_REQUIRE(lists.reserve(5));
+   BOOST_REQUIRE(lists.colorCount() == 5);
+   BOOST_REQUIRE(lists.firstFreeColor() == -1);
+
+   int target[] = {
+      -1, -1, 1,
+      -1, -1, 2,
+      -1, -1, 3,
+      -1, -1, 4,
+      -1, -1, -1
+   };
+
+   if (memcmp(lists.data(), target, sizeof(target)))
+   {
+      BOOST_FAIL("ColorWrappedLists(2, 3) contains wrong data "
+         "after failing to grow beyond 5 colors");
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_reserve)
+{
+   ColorWrappedLists lists(3, ColorWrappedLists::CC_RGB, 16);
+
+   ColorWrappedLists::iterator it = lists.createFirstColor();
+   it = lists.insertAfter(it);
+   lists.removeAfter(lists.begin(0));
+   BOOST_REQUIRE(lists.firstFreeColor() == 1);
+
+   // Added colors come first, the freed ones follow;
+   BOOST_REQUIRE(lists.reserve(5));
+   BOOST_REQUIRE(lists.colorCount() == 6);
+   BOOST_REQUIRE(lists.firstFreeColor() == 3);
+
+   int target[] = {
+      -1, -1, -1,
+      -1, -1, 2,
+      -1, -1, -1,
+      -1, -1, 4,
+      -1, -1, 5,
+      -1, -1, 1
+   };
+
+   if (memcmp(lists.data(), target, sizeof(target)))
+   {
+      BOOST_FAIL("ColorWrappedLists(3, 3) contains wrong data "
+         "after reserving 5 colors");
+   }
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -40,7 +40,7 @@ BOOST_AUTO_TEST_SUITE(suite_libmesh_Connections)
 
 BOOST_AUTO_TEST_CASE(test_create)
 {
-   Connections connections(5);
+   Connections connections(5, 64);
    GLint c;
 
    const Connections::Entry entries1[] = {
@@ -109,7 +109,7 @@ BOOST_AUTO_TEST_CASE(test_create)
 
 BOOST_AUTO_TEST_CASE(test_insertExternal)
 {
-   Connections connections(9);
+   Connections connections(9, 64);
    bool inserted;
 
    const Connections::Entry entries[] = {
@@ -267,7 +267,7 @@ BOOST_AUTO_TEST_CASE(test_insertExternal)
 
 BOOST_AUTO_TEST_CASE(test_insertInternal)
 {
-   Connections connections(6);
+   Connections connections(6, 64);
    bool inserted;
 
    const Connections::Entry entries[] = {
@@ -332,15 +332,27 @@ BOOST_AUTO_TEST_CASE(test_insertInternal)
    }
 
    inserted = connections.insertInternal(c, dt::VertexId(70), dt::EdgeId(700));
-   BOOST_REQUIRE(!inserted);
+   BOOST_REQUIRE(inserted);
+   BOOST_REQUIRE(connections.colorCount() == 12);
 
-   if (memcmp(connections.data(), target3, sizeof(target3)))
+   int target4[] = {
+      10, 100, 0, 1,
+      20, 200, 0, 2,
+      30, 300, 0, 6,
+      40, 400, 1, -1,
+      50, 500, 1, 3,
+      60, 600, 1, 4,
+      70, 700, 1, 5,
+      -1, -1, -1, 8
+   };
+
+   if (memcmp(connections.data(), target4, sizeof(target4)))
    {
       BOOST_FAIL("Connections(6) contains wrong data after inserting "
          "700 internal edge vith 70 vertex");
    }
 
-   Connections intConnections(3);
+   Connections intConnections(3, 64);
 
    const Connections::Entry intEntries[] = {
       Connections::Entry(dt::VertexId(10), dt::EdgeId(100), 1),
@@ -372,19 +384,22 @@ BOOST_AUTO_TEST_CASE(test_insertInternal)
       dt::VertexId(40),
       dt::EdgeId(400)
    );
-   BOOST_REQUIRE(!inserted);
+   BOOST_REQUIRE(inserted);
+   BOOST_REQUIRE(intConnections.colorCount() == 6);
 
-   if (memcmp(intConnections.data(), intTarget1, sizeof(intTarget1)))
-   {
-      BOOST_FAIL("Connections(3) contains wrong data after inserting "
-         "400 internal edge vith 40 vertex");
-   }
+   Connections::const_iterator it = intConnections.findFirst(
+      intC, 40, Connections::VT_VERTEX
+   );
+   BOOST_REQUIRE(it.isValid());
+   BOOST_REQUIRE(it.color() == 3);
+   BOOST_REQUIRE(it.get(Connections::VT_EDGE) == 400);
+   BOOST_REQUIRE(it.get(Connections::VT_INTERNAL) == 1);
 }
 
 
 BOOST_AUTO_TEST_CASE(test_replace)
 {
-   Connections connections(6);
+   Connections connections(6, 64);
    bool replaced;
 
    const Connections::Entry entries[] = {
@@ -491,7 +506,7 @@ BOOST_AUTO_TEST_CASE(test_replace)
 
 BOOST_AUTO_TEST_CASE(test_replaceEdge)
 {
-   Connections connections(6);
+   Connections connections(6, 64);
    bool replaced;
 
    const Connections::Entry entries[] = {
@@ -544,7 +559,7 @@ BOOST_AUTO_TEST_CASE(test_replaceEdge)
 
 BOOST_AUTO_TEST_CASE(test_convertToInternal)
 {
-   Connections connections(6);
+   Connections connections(6, 64);
    boost::optional<GLint> newFirstColor;
 
    const Connections::Entry entries[] = {
@@ -634,7 +649,7 @@ BOOST_AUTO_TEST_CASE(test_convertToInternal)
 
 BOOST_AUTO_TEST_CASE(test_findEdge)
 {
-   Connections connections(3);
+   Connections connections(3, 64);
 
    const Connections::Entry entries[] = {
       Connections::Entry(dt::VertexId(10), dt::EdgeId(100), 0),
@@ -652,7 +667,7 @@ BOOST_AUTO_TEST_CASE(test_findEdge)
 
 BOOST_AUTO_TEST_CASE(test_findFirst)
 {
-   Connections cn(3);
+   Connections cn(3, 64);
 
    const Connections::Entry entries[] = {
       Connections::Entry(dt::VertexId(1), dt::EdgeId(10), 0),
@@ -681,7 +696,7 @@ BOOST_AUTO_TEST_CASE(test_findFirst)
 
 BOOST_AUTO_TEST_CASE(test_getPrevExternalVertex)
 {
-   Connections cn(20);
+   Connections cn(20, 64);
    Connections::const_iterator it;
 
    const Connections::Entry entries1[] = {
@@ -798,7 +813,7 @@ BOOST_AUTO_TEST_CASE(test_getPrevExternalVertex)
 
 BOOST_AUTO_TEST_CASE(test_areExternalVerticesNextToEachOther)
 {
-   Connections cn(6);
+   Connections cn(6, 64);
    const Connections::Entry entries[] = {
       Connections::Entry(dt::VertexId(10), dt::EdgeId(100), 0),
       Connections::Entry(dt::VertexId(20), dt::EdgeId(200), 0),
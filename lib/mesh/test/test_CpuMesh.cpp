@@ -0,0 +1,253 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <vector>
+
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/test/unit_test.hpp>
+
+
+#include "BuddingParams.hpp"
+#include "Connections.hpp"
+#include "CpuMesh.hpp"
+#include "Vertex.hpp"
+
+
+using namespace mesh;
+
+
+namespace {
+
+
+CpuMesh * _createMesh()
+{
+   return new CpuMesh(
+      dt::Pointf3(0.0f, 0.5f, 0.0f),
+      dt::Pointf3(-0.5f, -0.5f, -0.5f),
+      dt::Pointf3(0.0f, -0.5f, 0.5f),
+      dt::Pointf3(0.5f, -0.5f, -0.5f)
+   );
+}
+
+
+void _requireOutwardNormals(const Mesh & mesh)
+{
+   const dt::Pointf3 center = mesh.center();
+   const DynamicVertex * dv = mesh.dynamicVertices();
+   for (size_t i = 0; i < mesh.vertexCount(); ++i)
+   {
+      const dt::Vectorf3 n(dv[i].nx, dv[i].ny, dv[i].nz);
+      BOOST_REQUIRE_CLOSE(n.length(), 1.0f, 0.01f);
+      const dt::Vectorf3 out(center, dv[i].point());
+      BOOST_REQUIRE(dt::dotProduct(n, out) > 0.0f);
+   }
+}
+
+
+}
+
+
+/***************************************************************************
+ *   CpuMesh class test                                                    *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libmesh_CpuMesh)
+
+
+BOOST_AUTO_TEST_CASE(test_constructor)
+{
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh());
+   BOOST_REQUIRE(mesh->vertexCount() == 4);
+   _requireOutwardNormals(*mesh);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_makeTetrahedronBud)
+{
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh());
+   const boost::optional<Tetrahedron> bud = mesh->makeTetrahedronBud(
+      Tetrahedron(0, 1, 2, 3),
+      BuddingParams(dt::TF_ABC)
+   );
+   BOOST_REQUIRE(bud);
+   BOOST_REQUIRE(mesh->vertexCount() == 5);
+   BOOST_REQUIRE(mesh->triangleCount() == 6);
+   _requireOutwardNormals(*mesh);
+
+   mesh->setVertexPosY(dt::VertexId(0), 1.0f);
+   _requireOutwardNormals(*mesh);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_capacity)
+{
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh());
+   BOOST_REQUIRE(mesh->vertexCapacity() == Mesh::IBS_VERTEX_COUNT);
+   BOOST_REQUIRE(mesh->triangleCapacity() == Mesh::IBS_TRIANGLE_COUNT);
+   BOOST_REQUIRE(mesh->edgeCapacity() == Mesh::IBS_EDGE_COUNT);
+   BOOST_REQUIRE(mesh->connections().colorCount() ==
+      Mesh::IBS_CONNECTION_COUNT);
+
+   // A chain of buds, every one on a face of the previous bud;
+   Tetrahedron t(0, 1, 2, 3);
+   const dt::TetrahedronFace faces[] = {dt::TF_BCD, dt::TF_ACD, dt::TF_ADB};
+   while (mesh->vertexCount() <= 2 * Mesh::IBS_VERTEX_COUNT)
+   {
+      boost::optional<Tetrahedron> bud;
+      for (size_t i = 0; !bud && i < sizeof(faces) / sizeof(faces[0]); ++i)
+      {
+         bud = mesh->makeTetrahedronBud(t, BuddingParams(faces[i]));
+      }
+      BOOST_REQUIRE(bud);
+      t = *bud;
+   }
+
+   BOOST_REQUIRE(mesh->vertexCapacity() >= mesh->vertexCount());
+   BOOST_REQUIRE(mesh->triangleCapacity() >= mesh->triangleCount());
+   BOOST_REQUIRE(mesh->edgeCapacity() >= mesh->edgeCount());
+   BOOST_REQUIRE(mesh->vertexCapacity() < Mesh::MBS_MAX_VERTEX_COUNT);
+   BOOST_REQUIRE(mesh->connections().colorCount() >
+      Mesh::IBS_CONNECTION_COUNT);
+
+   // Data written before the reallocations survives them;
+   for (size_t i = 0; i < mesh->triangleCount(); ++i)
+   {
+      const Triangle & tr = mesh->triangles()[i];
+      BOOST_REQUIRE(tr.a < mesh->vertexCount());
+      BOOST_REQUIRE(tr.b < mesh->vertexCount());
+      BOOST_REQUIRE(tr.c < mesh->vertexCount());
+      BOOST_REQUIRE(mesh->trianglesMap().findAny(tr));
+   }
+   for (size_t v = 0; v < mesh->vertexCount(); ++v)
+   {
+      Connections::const_iterator it = mesh->connections().begin(
+         mesh->staticVertices()[v].connection
+      );
+      BOOST_REQUIRE(it.isValid());
+      for (; it.isValid(); ++it)
+      {
+         BOOST_REQUIRE(static_cast<size_t>(it.get(Connections::VT_VERTEX)) <
+            mesh->vertexCount());
+         BOOST_REQUIRE(static_cast<size_t>(it.get(Connections::VT_EDGE)) <
+            mesh->edgeCount());
+      }
+   }
+   _requireOutwardNormals(*mesh);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_fork)
+{
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh());
+   const boost::optional<Tetrahedron> t = mesh->makeTetrahedronBud(
+      Tetrahedron(0, 1, 2, 3),
+      BuddingParams(dt::TF_ABC)
+   );
+   BOOST_REQUIRE(t);
+
+   // Nothing is copied until one of the meshes writes;
+   boost::scoped_ptr<Mesh> fork(mesh->fork());
+   BOOST_REQUIRE(fork->vertexCount() == mesh->vertexCount());
+   BOOST_REQUIRE(fork->dynamicVertices() == mesh->dynamicVertices());
+   BOOST_REQUIRE(fork->staticVertices() == mesh->staticVertices());
+   BOOST_REQUIRE(fork->triangles() == mesh->triangles());
+   BOOST_REQUIRE(fork->edges() == mesh->edges());
+   BOOST_REQUIRE(&fork->connections() == &mesh->connections());
+
+   const std::vector<DynamicVertex> vertices(
+      mesh->dynamicVertices(),
+      mesh->dynamicVertices() + mesh->vertexCount()
+   );
+   const std::vector<Triangle> triangles(
+      mesh->triangles(),
+      mesh->triangles() + mesh->triangleCount()
+   );
+
+   // Moving a vertex copies the vertices only;
+   fork->setVertexPosY(dt::VertexId(0), 1.0f);
+   BOOST_REQUIRE(fork->dynamicVertices() != mesh->dynamicVertices());
+   BOOST_REQUIRE(fork->triangles() == mesh->triangles());
+   BOOST_REQUIRE(mesh->dynamicVertices()[0].y == vertices[0].y);
+
+   BOOST_REQUIRE(fork->makeTetrahedronBud(*t, BuddingParams(dt::TF_BCD)));
+   BOOST_REQUIRE(fork->vertexCount() == 6);
+   BOOST_REQUIRE(&fork->connections() != &mesh->connections());
+   _requireOutwardNormals(*fork);
+
+   // The original is left as it was;
+   BOOST_REQUIRE(mesh->vertexCount() == vertices.size());
+   BOOST_REQUIRE(mesh->triangleCount() == triangles.size());
+   for (size_t i = 0; i < vertices.size(); ++i)
+   {
+      BOOST_REQUIRE(mesh->dynamicVertices()[i].point() == vertices[i].point());
+   }
+   for (size_t i = 0; i < triangles.size(); ++i)
+   {
+      BOOST_REQUIRE(mesh->triangles()[i] == triangles[i]);
+      BOOST_REQUIRE(mesh->trianglesMap().findAny(triangles[i]));
+   }
+   BOOST_REQUIRE(!mesh->trianglesMap().findAny(fork->triangles()[
+      fork->triangleCount() - 1
+   ]));
+   _requireOutwardNormals(*mesh);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_relax)
+{
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh());
+   const boost::optional<Tetrahedron> bud = mesh->makeTetrahedronBud(
+      Tetrahedron(0, 1, 2, 3),
+      BuddingParams(dt::TF_ABC)
+   );
+   BOOST_REQUIRE(bud);
+   mesh->setVertexPosY(dt::VertexId(0), 1.0f);
+
+   // Not enough iterations to settle;
+   RelaxationParams params;
+   params.maxIterations = 250;
+   params.batchSize = 100;
+   RelaxationStats stats = mesh->relax(params);
+   BOOST_REQUIRE(!stats.isConverged);
+   BOOST_REQUIRE(stats.iterations == 250);
+   BOOST_REQUIRE(stats.batches == 3);
+   BOOST_REQUIRE(stats.kineticEnergy > params.maxKineticEnergy);
+
+   params.maxIterations = 100000;
+   stats = mesh->relax(params);
+   BOOST_REQUIRE(stats.isConverged);
+   BOOST_REQUIRE(stats.iterations < params.maxIterations);
+   BOOST_REQUIRE(stats.iterations % params.batchSize == 0);
+   BOOST_REQUIRE(
+      stats.kineticEnergy <= params.maxKineticEnergy ||
+      stats.maxDisplacement <= params.maxDisplacement
+   );
+   BOOST_REQUIRE(dt::Vectorf3(
+      mesh->dynamicVertices()[0].point(),
+      dt::Pointf3(0.0f, 1.0f, 0.0f)
+   ).length() > 0.01f);
+   _requireOutwardNormals(*mesh);
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
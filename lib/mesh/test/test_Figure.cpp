@@ -0,0 +1,116 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <sstream>
+#include <string>
+
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/test/unit_test.hpp>
+
+
+#include "BuddingParams.hpp"
+#include "CpuMesh.hpp"
+#include "Figure.hpp"
+#include "Triangle.hpp"
+#include "Vertex.hpp"
+
+
+using namespace mesh;
+
+
+namespace {
+
+
+CpuMesh * _createMesh()
+{
+   return new CpuMesh(
+      dt::Pointf3(0.0f, 0.5f, 0.0f),
+      dt::Pointf3(-0.5f, -0.5f, -0.5f),
+      dt::Pointf3(0.0f, -0.5f, 0.5f),
+      dt::Pointf3(0.5f, -0.5f, -0.5f)
+   );
+}
+
+
+bool _equal(const Vertex & lhs, const Vertex & rhs)
+{
+   return lhs.x == rhs.x && lhs.y == rhs.y && lhs.z == rhs.z &&
+      lhs.w == rhs.w && lhs.nx == rhs.nx && lhs.ny == rhs.ny &&
+      lhs.nz == rhs.nz && lhs.nw == rhs.nw;
+}
+
+
+}
+
+
+/***************************************************************************
+ *   Figure class test                                                     *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libmesh_Figure)
+
+
+BOOST_AUTO_TEST_CASE(test_readWrite)
+{
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh());
+   Tetrahedron t(0, 1, 2, 3);
+   const dt::TetrahedronFace faces[] = {dt::TF_ABC, dt::TF_ACD, dt::TF_ADB};
+   for (dt::TetrahedronFace face : faces)
+   {
+      const boost::optional<Tetrahedron> bud =
+         mesh->makeTetrahedronBud(t, BuddingParams(face));
+      BOOST_REQUIRE(bud);
+      t = *bud;
+   }
+   const Figure figure(*mesh);
+
+   std::ostringstream os;
+   BOOST_REQUIRE(figure.write(os));
+   const std::string data = os.str();
+
+   // The figure comes back as it was;
+   std::istringstream is(data);
+   boost::scoped_ptr<Figure> restored(Figure::read(is));
+   BOOST_REQUIRE(restored);
+   BOOST_REQUIRE(restored->vertexCount() == figure.vertexCount());
+   BOOST_REQUIRE(restored->triangleCount() == figure.triangleCount());
+   BOOST_REQUIRE(restored->center() == figure.center());
+   BOOST_REQUIRE(restored->dimensions() == figure.dimensions());
+   for (size_t i = 0; i < figure.vertexCount(); ++i)
+   {
+      BOOST_REQUIRE(_equal(restored->vertices()[i], figure.vertices()[i]));
+   }
+   for (size_t i = 0; i < figure.triangleCount(); ++i)
+   {
+      BOOST_REQUIRE(restored->triangles()[i] == figure.triangles()[i]);
+   }
+
+   // Nothing is read from a stream cut short anywhere;
+   for (size_t size = 0; size < data.size(); size += 7)
+   {
+      std::istringstream cut(data.substr(0, size));
+      BOOST_REQUIRE(!boost::scoped_ptr<Figure>(Figure::read(cut)));
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,379 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/test/unit_test.hpp>
+
+
+#include "BuddingParams.hpp"
+#include "Connections.hpp"
+#include "CpuMesh.hpp"
+#include "Edge.hpp"
+#include "SpringSolver.hpp"
+#include "Vertex.hpp"
+
+
+using namespace mesh;
+
+
+namespace {
+
+CpuMesh * _createMesh(size_t budCount)
+{
+   CpuMesh * mesh = new CpuMesh(
+      dt::Pointf3(0.0f, 0.5f, 0.0f),
+      dt::Pointf3(-0.5f, -0.5f, -0.5f),
+      dt::Pointf3(0.0f, -0.5f, 0.5f),
+      dt::Pointf3(0.5f, -0.5f, -0.5f)
+   );
+
+   std::vector<Tetrahedron> tetrahedrons(1, Tetrahedron(0, 1, 2, 3));
+   const dt::TetrahedronFace faces[] = {
+      dt::TF_ABC, dt::TF_ACD, dt::TF_ADB, dt::TF_BCD
+   };
+   for (size_t i = 0; i < 20 * budCount && budCount; ++i)
+   {
+      const Tetrahedron & t = tetrahedrons[rand() % tetrahedrons.size()];
+      if (const auto bud = mesh->makeTetrahedronBud(
+         t,
+         BuddingParams(faces[rand() % 4])
+      ))
+      {
+         tetrahedrons.push_back(*bud);
+         if (!--budCount)
+         {
+            break;
+         }
+      }
+   }
+   return mesh;
+}
+
+
+dt::Vectorf3 _safeNormalize(const dt::Vectorf3 & v)
+{
+   // The shader divides by v.length(), the number of components;
+   return dt::Vectorf3(v.x / 3.0f, v.y / 3.0f, v.z / 3.0f);
+}
+
+
+// feedback.glslv, line by line;
+std::vector<DynamicVertex> _shaderPass(const Mesh & mesh, bool applyForces)
+{
+   const DynamicVertex * in = mesh.dynamicVertices();
+   const StaticVertex * sv = mesh.staticVertices();
+   const Edge * edges = mesh.edges();
+   std::vector<DynamicVertex> out(in, in + mesh.vertexCount());
+
+   for (size_t v = 0; v < mesh.vertexCount(); ++v)
+   {
+      const dt::Pointf3 pos0 = in[v].point();
+      dt::Vectorf3 normal(0.0f, 0.0f, 0.0f);
+      dt::Vectorf3 force(0.0f, 0.0f, 0.0f);
+
+      auto addNormal = [&](GLint v1, GLint v2, GLint e2, bool adjust)
+      {
+         const dt::Vectorf3 vec2(pos0, in[v2].point());
+         const dt::Float dl = edges[e2].equilibriumLength -
+            dt::Vectorf3(in[v2].point(), pos0).length();
+         const dt::Vectorf3 f = _safeNormalize(vec2 * -1.0f) * dl;
+         force = dt::Vectorf3(force.x + f.x, force.y + f.y, force.z + f.z);
+         if (adjust)
+         {
+            const dt::Vectorf3 n = _safeNormalize(dt::crossProduct(
+               dt::Vectorf3(pos0, in[v1].point()),
+               vec2
+            ));
+            normal = dt::Vectorf3(
+               normal.x + n.x,
+               normal.y + n.y,
+               normal.z + n.z
+            );
+         }
+      };
+
+      Connections::const_iterator it =
+         mesh.connections().begin(sv[v].connection);
+      if (it.isValid())
+      {
+         bool adjustNormal = true;
+         const GLint firstVertex = it.get(Connections::VT_VERTEX);
+         const GLint firstEdge = it.get(Connections::VT_EDGE);
+         GLint prev = firstVertex;
+         GLint lastExternal = firstVertex;
+         for (++it; it.isValid(); ++it)
+         {
+            if (it.get(Connections::VT_INTERNAL) > 0)
+            {
+               adjustNormal = false;
+            }
+            const GLint curr = it.get(Connections::VT_VERTEX);
+            addNormal(prev, curr, it.get(Connections::VT_EDGE), adjustNormal);
+            prev = curr;
+            if (adjustNormal)
+            {
+               lastExternal = curr;
+            }
+         }
+         if (lastExternal != firstVertex)
+         {
+            addNormal(lastExternal, firstVertex, firstEdge, true);
+         }
+      }
+
+      const dt::Vectorf3 n = _safeNormalize(normal);
+      out[v].nx = n.x;
+      out[v].ny = n.y;
+      out[v].nz = n.z;
+      if (applyForces)
+      {
+         const DynamicVertex & i = in[v];
+         force.x -= 0.25f * i.vx;
+         force.y -= 0.25f * i.vy;
+         force.z -= 0.25f * i.vz;
+         out[v].x = i.x + i.vx * 0.01f;
+         out[v].y = i.y + i.vy * 0.01f;
+         out[v].z = i.z + i.vz * 0.01f;
+         out[v].vx = i.vx + (force.x / i.mass) * 0.01f;
+         out[v].vy = i.vy + (force.y / i.mass) * 0.01f;
+         out[v].vz = i.vz + (force.z / i.mass) * 0.01f;
+      }
+   }
+   return out;
+}
+
+
+void _requireClose(dt::Float a, dt::Float b)
+{
+   BOOST_REQUIRE(fabs(a - b) <= 1e-5f * (1.0f + fabs(a) + fabs(b)));
+}
+
+
+void _requireClose(
+   const std::vector<DynamicVertex> & expected,
+   const std::vector<DynamicVertex> & actual
+)
+{
+   BOOST_REQUIRE(expected.size() == actual.size());
+   for (size_t v = 0; v < expected.size(); ++v)
+   {
+      _requireClose(expected[v].x, actual[v].x);
+      _requireClose(expected[v].y, actual[v].y);
+      _requireClose(expected[v].z, actual[v].z);
+      _requireClose(expected[v].nx, actual[v].nx);
+      _requireClose(expected[v].ny, actual[v].ny);
+      _requireClose(expected[v].nz, actual[v].nz);
+      _requireClose(expected[v].vx, actual[v].vx);
+      _requireClose(expected[v].vy, actual[v].vy);
+      _requireClose(expected[v].vz, actual[v].vz);
+   }
+}
+
+
+// Moves the mesh off its equilibrium and gives it some speed;
+void _shake(CpuMesh & mesh)
+{
+   for (size_t v = 0; v < mesh.vertexCount(); ++v)
+   {
+      const DynamicVertex & dv = mesh.dynamicVertices()[v];
+      mesh.setVertexPos(
+         dt::VertexId(v),
+         dv.x * (0.8f + 0.4f * rand() / RAND_MAX),
+         dv.y * (0.8f + 0.4f * rand() / RAND_MAX),
+         dv.z * (0.8f + 0.4f * rand() / RAND_MAX)
+      );
+   }
+   mesh.applyForces(3);
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   SpringSolver class test                                               *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libmesh_SpringSolver)
+
+
+BOOST_AUTO_TEST_CASE(test_load)
+{
+   srand(1);
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh(30));
+   SpringSolver solver;
+   solver.load(*mesh);
+   BOOST_REQUIRE(solver.vertexCount() == mesh->vertexCount());
+   BOOST_REQUIRE(solver.springCount() >= 2 * mesh->edgeCount());
+
+   std::vector<DynamicVertex> stored(
+      mesh->dynamicVertices(),
+      mesh->dynamicVertices() + mesh->vertexCount()
+   );
+   solver.store(stored.data());
+   for (size_t v = 0; v < stored.size(); ++v)
+   {
+      BOOST_REQUIRE(stored[v].point() == mesh->dynamicVertices()[v].point());
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_shaderEquivalence)
+{
+   srand(2);
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh(60));
+   _shake(*mesh);
+
+   for (int applyForces = 0; applyForces < 2; ++applyForces)
+   {
+      const std::vector<DynamicVertex> expected =
+         _shaderPass(*mesh, applyForces);
+
+      SpringSolver solver;
+      solver.load(*mesh);
+      solver.step(applyForces);
+      std::vector<DynamicVertex> actual(
+         mesh->dynamicVertices(),
+         mesh->dynamicVertices() + mesh->vertexCount()
+      );
+      solver.store(actual.data());
+      _requireClose(expected, actual);
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_threads)
+{
+   srand(3);
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh(60));
+   _shake(*mesh);
+
+   std::vector<DynamicVertex> results[2];
+   for (int i = 0; i < 2; ++i)
+   {
+      SpringSolver solver;
+      solver.setThreadCount(i ? 4 : 1);
+      solver.load(*mesh);
+      solver.step(true, 50);
+      results[i].assign(
+         mesh->dynamicVertices(),
+         mesh->dynamicVertices() + mesh->vertexCount()
+      );
+      solver.store(results[i].data());
+   }
+
+   // Every vertex is computed by the same operations on any thread;
+   for (size_t v = 0; v < mesh->vertexCount(); ++v)
+   {
+      BOOST_REQUIRE(results[0][v].point() == results[1][v].point());
+      BOOST_REQUIRE(results[0][v].vx == results[1][v].vx);
+      BOOST_REQUIRE(results[0][v].nx == results[1][v].nx);
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_applyForces)
+{
+   // Springs pull a shaken mesh back, the motion dies out;
+   srand(4);
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh(30));
+   _shake(*mesh);
+   mesh->applyForces(5000);
+   for (size_t v = 0; v < mesh->vertexCount(); ++v)
+   {
+      BOOST_REQUIRE(mesh->dynamicVertices()[v].speed() < 0.01f);
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   SpringSolver benchmark                                                *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libmesh_SpringSolver_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_step)
+{
+   srand(1);
+   boost::scoped_ptr<CpuMesh> mesh(_createMesh(12000));
+   const size_t steps = 200;
+
+   // Straight port of the shader walking the connection lists;
+   const auto referenceStart = std::chrono::steady_clock::now();
+   for (size_t i = 0; i < steps; ++i)
+   {
+      _shaderPass(*mesh, true);
+   }
+   const std::chrono::duration<double> reference =
+      std::chrono::steady_clock::now() - referenceStart;
+   std::cout << mesh->vertexCount() << " vertices, reference: " <<
+      (steps / reference.count()) << " steps/s" << std::endl;
+
+   // Timings are only meaningful if every thread count steps the same;
+   std::vector<DynamicVertex> expected;
+   const size_t threadCounts[] = {1, 2, 4, 0};
+   for (size_t threadCount : threadCounts)
+   {
+      SpringSolver solver;
+      solver.setThreadCount(threadCount);
+      solver.load(*mesh);
+      const auto start = std::chrono::steady_clock::now();
+      solver.step(true, steps);
+      const std::chrono::duration<double> time =
+         std::chrono::steady_clock::now() - start;
+      std::cout << mesh->vertexCount() << " vertices, " <<
+         solver.springCount() << " springs, " << threadCount <<
+         " threads: " << (steps / time.count()) << " steps/s" << std::endl;
+
+      std::vector<DynamicVertex> actual(
+         mesh->dynamicVertices(),
+         mesh->dynamicVertices() + mesh->vertexCount()
+      );
+      solver.store(actual.data());
+      if (expected.empty())
+      {
+         expected = actual;
+         continue;
+      }
+      for (size_t v = 0; v < actual.size(); ++v)
+      {
+         BOOST_REQUIRE(actual[v].point() == expected[v].point());
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
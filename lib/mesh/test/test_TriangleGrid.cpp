@@ -0,0 +1,192 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <algorithm>
+#include <cstdlib>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "utils3d/geometry.hpp"
+
+
+#include "TriangleGrid.hpp"
+
+
+using namespace mesh;
+
+
+namespace {
+
+struct _Triangle
+{
+   _Triangle();
+
+   dt::Pointf3 a;
+   dt::Pointf3 b;
+   dt::Pointf3 c;
+};
+
+
+dt::Float _random(dt::Float min, dt::Float max)
+{
+   return min + (max - min) * (static_cast<dt::Float>(rand()) / RAND_MAX);
+}
+
+
+dt::Pointf3 _randomPoint(const dt::Pointf3 & center, dt::Float radius)
+{
+   return dt::Pointf3(
+      center.x + _random(-radius, radius),
+      center.y + _random(-radius, radius),
+      center.z + _random(-radius, radius)
+   );
+}
+
+
+_Triangle::_Triangle()
+   : a(_randomPoint(dt::Pointf3(0.0f, 0.0f, 0.0f), 5.0f)),
+   b(_randomPoint(a, 1.0f)),
+   c(_randomPoint(a, 1.0f))
+{
+}
+
+
+bool _doBoxesOverlap(
+   const _Triangle & t,
+   const dt::Pointf3 & min,
+   const dt::Pointf3 & max
+)
+{
+   return
+      std::max(t.a.x, std::max(t.b.x, t.c.x)) >= min.x &&
+      std::min(t.a.x, std::min(t.b.x, t.c.x)) <= max.x &&
+      std::max(t.a.y, std::max(t.b.y, t.c.y)) >= min.y &&
+      std::min(t.a.y, std::min(t.b.y, t.c.y)) <= max.y &&
+      std::max(t.a.z, std::max(t.b.z, t.c.z)) >= min.z &&
+      std::min(t.a.z, std::min(t.b.z, t.c.z)) <= max.z;
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   TriangleGrid class test                                               *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libmesh_TriangleGrid)
+
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+   TriangleGrid grid;
+   BOOST_REQUIRE(grid.find(
+      dt::Pointf3(-1.0f, -1.0f, -1.0f),
+      dt::Pointf3(1.0f, 1.0f, 1.0f)
+   ).empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_random)
+{
+   // Triangles are kept in a dense array and removed the way Mesh does it,
+   // by moving the last triangle into the gap;
+   srand(1);
+   std::vector<_Triangle> triangles;
+   TriangleGrid grid;
+   grid.reset(0.7f);
+
+   for (int step = 0; step < 4000; ++step)
+   {
+      if (triangles.size() < 50 || rand() % 3)
+      {
+         triangles.push_back(_Triangle());
+         const _Triangle & t = triangles.back();
+         grid.insert(triangles.size() - 1, t.a, t.b, t.c);
+      }
+      else
+      {
+         const size_t t = rand() % triangles.size();
+         const size_t last = triangles.size() - 1;
+         grid.remove(t);
+         if (t != last)
+         {
+            grid.move(last, t);
+            triangles[t] = triangles[last];
+         }
+         triangles.pop_back();
+      }
+
+      // Box query, the grid may only add candidates;
+      const dt::Pointf3 center = _randomPoint(dt::Pointf3(0, 0, 0), 5.0f);
+      const dt::Pointf3 min = _randomPoint(center, 0.5f);
+      const dt::Pointf3 max(
+         min.x + _random(0.0f, 1.5f),
+         min.y + _random(0.0f, 1.5f),
+         min.z + _random(0.0f, 1.5f)
+      );
+      const std::vector<size_t> found = grid.find(min, max);
+      BOOST_REQUIRE(std::is_sorted(found.begin(), found.end()));
+      for (size_t i = 0; i < triangles.size(); ++i)
+      {
+         if (_doBoxesOverlap(triangles[i], min, max))
+         {
+            BOOST_REQUIRE(std::binary_search(found.begin(), found.end(), i));
+         }
+      }
+      for (size_t i : found)
+      {
+         BOOST_REQUIRE(i < triangles.size());
+      }
+
+      // Intersection with a query triangle is the same as by brute force;
+      const _Triangle q;
+      const std::vector<size_t> candidates = grid.find(
+         dt::Pointf3(
+            std::min(q.a.x, std::min(q.b.x, q.c.x)),
+            std::min(q.a.y, std::min(q.b.y, q.c.y)),
+            std::min(q.a.z, std::min(q.b.z, q.c.z))
+         ),
+         dt::Pointf3(
+            std::max(q.a.x, std::max(q.b.x, q.c.x)),
+            std::max(q.a.y, std::max(q.b.y, q.c.y)),
+            std::max(q.a.z, std::max(q.b.z, q.c.z))
+         )
+      );
+      for (size_t i = 0; i < triangles.size(); ++i)
+      {
+         const _Triangle & t = triangles[i];
+         if (utils3d::doTrianglesIntersect(q.a, q.b, q.c, t.a, t.b, t.c))
+         {
+            BOOST_REQUIRE(std::binary_search(
+               candidates.begin(),
+               candidates.end(),
+               i
+            ));
+         }
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1 @@
+#include "../../src/batch.hpp"
@@ -0,0 +1,208 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <cassert>
+
+
+#include "batch.hpp"
+#include "batch_kernel.hpp"
+#include "geometry.hpp"
+
+
+namespace utils3d {
+
+
+/***************************************************************************
+ *   TriangleBatch class implementation                                    *
+ ***************************************************************************/
+
+
+TriangleBatch::TriangleBatch()
+{
+}
+
+
+void TriangleBatch::clear()
+{
+   for (int i = 0; i < C_COUNT; ++i)
+   {
+      m_coords[i].clear();
+   }
+}
+
+
+void TriangleBatch::reserve(size_t size)
+{
+   for (int i = 0; i < C_COUNT; ++i)
+   {
+      m_coords[i].reserve(size);
+   }
+}
+
+
+void TriangleBatch::append(
+   const dt::Pointf3 & a,
+   const dt::Pointf3 & b,
+   const dt::Pointf3 & c
+)
+{
+   m_coords[C_AX].push_back(a.x);
+   m_coords[C_AY].push_back(a.y);
+   m_coords[C_AZ].push_back(a.z);
+   m_coords[C_BX].push_back(b.x);
+   m_coords[C_BY].push_back(b.y);
+   m_coords[C_BZ].push_back(b.z);
+   m_coords[C_CX].push_back(c.x);
+   m_coords[C_CY].push_back(c.y);
+   m_coords[C_CZ].push_back(c.z);
+}
+
+
+/***************************************************************************
+ *   Batch geometry utils implementation                                   *
+ ***************************************************************************/
+
+
+namespace {
+
+SimdLevel _detectSimdLevel()
+{
+#if (defined(__GNUC__) || defined(__clang__)) && \
+   (defined(__x86_64__) || defined(__i386__))
+   __builtin_cpu_init();
+   if (batch::isAvxCompiled() && __builtin_cpu_supports("avx"))
+   {
+      return SL_AVX;
+   }
+   if (batch::isSseCompiled() && __builtin_cpu_supports("sse2"))
+   {
+      return SL_SSE;
+   }
+#endif
+   return SL_SCALAR;
+}
+
+
+size_t _findScalar(
+   const dt::Pointf3 & x,
+   const dt::Pointf3 & y,
+   const dt::Pointf3 & z,
+   const TriangleBatch & batch
+)
+{
+   const dt::Float * ax = batch.coords(TriangleBatch::C_AX);
+   const dt::Float * ay = batch.coords(TriangleBatch::C_AY);
+   const dt::Float * az = batch.coords(TriangleBatch::C_AZ);
+   const dt::Float * bx = batch.coords(TriangleBatch::C_BX);
+   const dt::Float * by = batch.coords(TriangleBatch::C_BY);
+   const dt::Float * bz = batch.coords(TriangleBatch::C_BZ);
+   const dt::Float * cx = batch.coords(TriangleBatch::C_CX);
+   const dt::Float * cy = batch.coords(TriangleBatch::C_CY);
+   const dt::Float * cz = batch.coords(TriangleBatch::C_CZ);
+   for (size_t i = 0; i < batch.size(); ++i)
+   {
+      if (doTrianglesIntersect(
+         x, y, z,
+         dt::Pointf3(ax[i], ay[i], az[i]),
+         dt::Pointf3(bx[i], by[i], bz[i]),
+         dt::Pointf3(cx[i], cy[i], cz[i])
+      ))
+      {
+         return i;
+      }
+   }
+   return batch.size();
+}
+
+} // anonymous namespace;
+
+
+SimdLevel getSupportedSimdLevel()
+{
+   static const SimdLevel level = _detectSimdLevel();
+   return level;
+}
+
+
+boost::optional<size_t> findTriangleIntersection(
+   const dt::Pointf3 & x,
+   const dt::Pointf3 & y,
+   const dt::Pointf3 & z,
+   const TriangleBatch & batch
+)
+{
+   // Half empty AVX registers lose to SSE;
+   SimdLevel level = getSupportedSimdLevel();
+   if (level == SL_AVX && batch.size() <= 4)
+   {
+      level = SL_SSE;
+   }
+   return findTriangleIntersection(x, y, z, batch, level);
+}
+
+
+boost::optional<size_t> findTriangleIntersection(
+   const dt::Pointf3 & x,
+   const dt::Pointf3 & y,
+   const dt::Pointf3 & z,
+   const TriangleBatch & batch,
+   SimdLevel level
+)
+{
+   if (level > getSupportedSimdLevel())
+   {
+      level = getSupportedSimdLevel();
+   }
+
+   size_t result = batch.size();
+   if (level == SL_SCALAR)
+   {
+      result = _findScalar(x, y, z, batch);
+   }
+   else
+   {
+      const dt::Float query[9] = {x.x, x.y, x.z, y.x, y.y, y.z, z.x, z.y, z.z};
+      const dt::Float * coords[TriangleBatch::C_COUNT];
+      for (int i = 0; i < TriangleBatch::C_COUNT; ++i)
+      {
+         coords[i] = batch.coords(static_cast<TriangleBatch::Coord>(i));
+      }
+
+      if (level == SL_AVX)
+      {
+         result = batch::findAvx(query, coords, batch.size());
+      }
+      else
+      {
+         assert(level == SL_SSE);
+         result = batch::findSse(query, coords, batch.size());
+      }
+   }
+
+   if (result < batch.size())
+   {
+      return result;
+   }
+   return boost::none;
+}
+
+
+}
@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef UTILS3D_BATCH_HPP
+#define UTILS3D_BATCH_HPP
+
+
+#include <cstdlib>
+#include <vector>
+
+
+#include <boost/optional.hpp>
+
+#include "datatypes/geometry.hpp"
+
+
+namespace utils3d {
+
+
+/***************************************************************************
+ *   TriangleBatch class declaration                                       *
+ ***************************************************************************/
+
+
+// Triangles packed as structure of arrays, one array per coordinate, so
+// that a block of them can be loaded into vector registers at once;
+class TriangleBatch
+{
+   public:
+      enum Coord
+      {
+         C_AX = 0, C_AY, C_AZ,
+         C_BX, C_BY, C_BZ,
+         C_CX, C_CY, C_CZ,
+         C_COUNT
+      };
+
+      explicit TriangleBatch();
+
+      inline size_t size() const {return m_coords[C_AX].size();}
+      inline bool empty() const {return m_coords[C_AX].empty();}
+      inline const dt::Float * coords(Coord coord) const;
+
+      void clear();
+      void reserve(size_t size);
+      void append(
+         const dt::Pointf3 & a,
+         const dt::Pointf3 & b,
+         const dt::Pointf3 & c
+      );
+
+   private:
+      std::vector<dt::Float> m_coords[C_COUNT];
+};
+
+
+/***************************************************************************
+ *   Batch geometry utils declaration                                      *
+ ***************************************************************************/
+
+
+enum SimdLevel
+{
+   SL_SCALAR = 0, // One triangle at a time through doTrianglesIntersect;
+   SL_SSE,        // 4 triangles per step;
+   SL_AVX         // 8 triangles per step;
+};
+
+
+// The best level both compiled in and supported by the running CPU;
+SimdLevel getSupportedSimdLevel();
+
+
+// Index of the first triangle of the batch that intersects the XYZ
+// triangle, gives exactly the same answers as doTrianglesIntersect. Levels
+// above the supported one fall back to it;
+boost::optional<size_t> findTriangleIntersection(
+   const dt::Pointf3 & x,
+   const dt::Pointf3 & y,
+   const dt::Pointf3 & z,
+   const TriangleBatch & batch
+);
+boost::optional<size_t> findTriangleIntersection(
+   const dt::Pointf3 & x,
+   const dt::Pointf3 & y,
+   const dt::Pointf3 & z,
+   const TriangleBatch & batch,
+   SimdLevel level
+);
+
+
+/***************************************************************************
+ *   TriangleBatch class inline methods                                    *
+ ***************************************************************************/
+
+
+inline const dt::Float * TriangleBatch::coords(Coord coord) const
+{
+   return m_coords[coord].data();
+}
+
+
+}
+
+
+#endif
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <cassert>
+
+
+#ifdef __AVX__
+#include <immintrin.h>
+#endif
+
+
+#include "batch_kernel.hpp"
+
+
+namespace utils3d {
+namespace batch {
+
+
+/***************************************************************************
+ *   AVX batch kernel implementation                                       *
+ ***************************************************************************/
+
+
+#ifdef __AVX__
+
+
+namespace {
+
+struct _Mask
+{
+   __m256 v;
+};
+
+
+inline _Mask operator&(const _Mask & m1, const _Mask & m2)
+{
+   const _Mask m = {_mm256_and_ps(m1.v, m2.v)};
+   return m;
+}
+
+
+inline _Mask operator|(const _Mask & m1, const _Mask & m2)
+{
+   const _Mask m = {_mm256_or_ps(m1.v, m2.v)};
+   return m;
+}
+
+
+inline _Mask operator!(const _Mask & m)
+{
+   const __m256 ones = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+   const _Mask result = {_mm256_xor_ps(m.v, ones)};
+   return result;
+}
+
+
+inline int movemask(const _Mask & m)
+{
+   return _mm256_movemask_ps(m.v);
+}
+
+
+struct _Pack
+{
+   enum {SIZE = 8};
+
+   inline _Pack() {}
+   inline explicit _Pack(__m256 v) : v(v) {}
+   inline explicit _Pack(dt::Float f) : v(_mm256_set1_ps(f)) {}
+
+   static inline _Pack zero() {return _Pack(_mm256_setzero_ps());}
+   static inline _Pack load(const dt::Float * p)
+   {
+      return _Pack(_mm256_loadu_ps(p));
+   }
+
+   __m256 v;
+};
+
+
+inline _Pack operator+(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm256_add_ps(p1.v, p2.v));
+}
+
+
+inline _Pack operator-(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm256_sub_ps(p1.v, p2.v));
+}
+
+
+inline _Pack operator*(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm256_mul_ps(p1.v, p2.v));
+}
+
+
+inline _Pack operator/(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm256_div_ps(p1.v, p2.v));
+}
+
+
+inline _Pack sqrt(const _Pack & p)
+{
+   return _Pack(_mm256_sqrt_ps(p.v));
+}
+
+
+inline _Mask gt(const _Pack & p1, const _Pack & p2)
+{
+   const _Mask m = {_mm256_cmp_ps(p1.v, p2.v, _CMP_GT_OQ)};
+   return m;
+}
+
+
+inline _Mask le(const _Pack & p1, const _Pack & p2)
+{
+   const _Mask m = {_mm256_cmp_ps(p1.v, p2.v, _CMP_LE_OQ)};
+   return m;
+}
+
+
+inline _Mask neq(const _Pack & p1, const _Pack & p2)
+{
+   const _Mask m = {_mm256_cmp_ps(p1.v, p2.v, _CMP_NEQ_UQ)};
+   return m;
+}
+
+
+inline _Pack select(const _Mask & m, const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm256_or_ps(
+      _mm256_and_ps(m.v, p1.v),
+      _mm256_andnot_ps(m.v, p2.v)
+   ));
+}
+
+} // anonymous namespace;
+
+
+bool isAvxCompiled()
+{
+   return true;
+}
+
+
+size_t findAvx(
+   const dt::Float * query,
+   const dt::Float * const * coords,
+   size_t count
+)
+{
+   return find<_Pack>(query, coords, count);
+}
+
+
+#else
+
+
+bool isAvxCompiled()
+{
+   return false;
+}
+
+
+size_t findAvx(const dt::Float *, const dt::Float * const *, size_t count)
+{
+   assert(false);
+   return count;
+}
+
+
+#endif
+
+
+}
+}
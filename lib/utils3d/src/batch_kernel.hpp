@@ -0,0 +1,278 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef UTILS3D_BATCH_KERNEL_HPP
+#define UTILS3D_BATCH_KERNEL_HPP
+
+
+#include <cstdlib>
+
+
+#include "datatypes/geometry.hpp"
+
+#include "batch.hpp"
+
+
+// Vectorised kernels live in their own translation units built with their
+// own instruction set flags. They must not instantiate anything inline that
+// is shared with the rest of the program (std containers included), or the
+// linker may keep a copy that the running CPU does not support. Hence raw
+// pointers below, and packs defined in anonymous namespaces;
+
+
+namespace utils3d {
+namespace batch {
+
+
+/***************************************************************************
+ *   Batch kernels declaration                                             *
+ ***************************************************************************/
+
+
+// Query triangle is given as x, y, z coordinates of its three points,
+// coords are the arrays of TriangleBatch. Result is the index of the first
+// intersecting triangle or count;
+bool isSseCompiled();
+size_t findSse(
+   const dt::Float * query,
+   const dt::Float * const * coords,
+   size_t count
+);
+
+
+bool isAvxCompiled();
+size_t findAvx(
+   const dt::Float * query,
+   const dt::Float * const * coords,
+   size_t count
+);
+
+
+/***************************************************************************
+ *   Batch kernels implementation                                          *
+ ***************************************************************************/
+
+
+// Every operation repeats the one of the scalar version in the same order,
+// IEEE arithmetic makes the results bit for bit equal. Pack P provides
+// arithmetic operators, sqrt, comparisons (false on NaN except neq) giving
+// masks M, mask operators & and |, andNot and select;
+
+
+template <typename P>
+struct Vec3
+{
+   P x;
+   P y;
+   P z;
+};
+
+
+template <typename P>
+inline Vec3<P> vec3(const P & x, const P & y, const P & z)
+{
+   const Vec3<P> v = {x, y, z};
+   return v;
+}
+
+
+template <typename P>
+inline Vec3<P> operator-(const Vec3<P> & v1, const Vec3<P> & v2)
+{
+   return vec3(v1.x - v2.x, v1.y - v2.y, v1.z - v2.z);
+}
+
+
+template <typename P>
+inline Vec3<P> operator+(const Vec3<P> & v1, const Vec3<P> & v2)
+{
+   return vec3(v1.x + v2.x, v1.y + v2.y, v1.z + v2.z);
+}
+
+
+template <typename P>
+inline Vec3<P> crossProduct(const Vec3<P> & v1, const Vec3<P> & v2)
+{
+   return vec3(
+      v1.y * v2.z - v1.z * v2.y,
+      v1.z * v2.x - v1.x * v2.z,
+      v1.x * v2.y - v1.y * v2.x
+   );
+}
+
+
+template <typename P>
+inline P dotProduct(const Vec3<P> & v1, const Vec3<P> & v2)
+{
+   return ((v1.x * v2.x) + (v1.y * v2.y) + (v1.z * v2.z));
+}
+
+
+template <typename P>
+inline P length(const Vec3<P> & v)
+{
+   return sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+}
+
+
+template <typename P>
+inline Vec3<P> normalized(const Vec3<P> & v)
+{
+   const P n = length(v);
+   const auto isPositive = gt(n, P::zero());
+   return vec3(
+      select(isPositive, v.x / n, P::zero()),
+      select(isPositive, v.y / n, P::zero()),
+      select(isPositive, v.z / n, P::zero())
+   );
+}
+
+
+// Lanes of the mask where P lies on the inner side of the edge starting at
+// e, edgeNormal points outwards;
+template <typename P>
+inline auto isInsideEdge(
+   const Vec3<P> & e,
+   const Vec3<P> & edgeNormal,
+   const Vec3<P> & p
+) -> decltype(gt(P::zero(), P::zero()))
+{
+   const Vec3<P> pe = (e + edgeNormal) - p;
+   const Vec3<P> pen = vec3(
+      (e.x + (P::zero() - edgeNormal.x)) - p.x,
+      (e.y + (P::zero() - edgeNormal.y)) - p.y,
+      (e.z + (P::zero() - edgeNormal.z)) - p.z
+   );
+   return !gt(length(pe), length(pen));
+}
+
+
+// Counterpart of getLineSegmentTriangleIntersection;
+template <typename P>
+inline auto doesSegmentIntersectTriangle(
+   const Vec3<P> & s0,
+   const Vec3<P> & s1,
+   const Vec3<P> & a,
+   const Vec3<P> & b,
+   const Vec3<P> & c
+) -> decltype(gt(P::zero(), P::zero()))
+{
+   const Vec3<P> ab = b - a;
+   const Vec3<P> bc = c - b;
+   const Vec3<P> ac = c - a;
+   const Vec3<P> ad = normalized(crossProduct(ab, ac));
+
+   // Intersection with the plane;
+   const Vec3<P> y = s1 - s0;
+   const P v = dotProduct(ad, a - s0);
+   const P w = dotProduct(ad, y);
+   const P k = v / w;
+   const Vec3<P> p = vec3(s0.x + y.x * k, s0.y + y.y * k, s0.z + y.z * k);
+
+   // Within the segment;
+   const P segmentLength = length(y);
+   auto result = neq(w, P::zero());
+   result = result & le(length(s0 - p), segmentLength);
+   result = result & le(length(s1 - p), segmentLength);
+
+   // Within the triangle;
+   result = result & isInsideEdge(a, normalized(crossProduct(ac, ad)), p);
+   result = result & isInsideEdge(a, normalized(crossProduct(ad, ab)), p);
+   result = result & isInsideEdge(b, normalized(crossProduct(ad, bc)), p);
+   return result;
+}
+
+
+// Counterpart of doTrianglesIntersect;
+template <typename P>
+inline auto doTrianglesIntersect(
+   const Vec3<P> & x,
+   const Vec3<P> & y,
+   const Vec3<P> & z,
+   const Vec3<P> & a,
+   const Vec3<P> & b,
+   const Vec3<P> & c
+) -> decltype(gt(P::zero(), P::zero()))
+{
+   return
+      doesSegmentIntersectTriangle(x, y, a, b, c) |
+      doesSegmentIntersectTriangle(x, z, a, b, c) |
+      doesSegmentIntersectTriangle(y, z, a, b, c) |
+      doesSegmentIntersectTriangle(a, b, x, y, z) |
+      doesSegmentIntersectTriangle(a, c, x, y, z) |
+      doesSegmentIntersectTriangle(b, c, x, y, z);
+}
+
+
+// Walks the batch P::SIZE triangles at a time, the tail is loaded from
+// a zero-padded copy;
+template <typename P>
+inline size_t find(
+   const dt::Float * query,
+   const dt::Float * const * coords,
+   size_t count
+)
+{
+   const Vec3<P> x = vec3(P(query[0]), P(query[1]), P(query[2]));
+   const Vec3<P> y = vec3(P(query[3]), P(query[4]), P(query[5]));
+   const Vec3<P> z = vec3(P(query[6]), P(query[7]), P(query[8]));
+
+   for (size_t i = 0; i < count; i += P::SIZE)
+   {
+      const size_t n = count - i < P::SIZE ? count - i : P::SIZE;
+      dt::Float tail[TriangleBatch::C_COUNT][P::SIZE];
+      P lanes[TriangleBatch::C_COUNT];
+      for (int coord = 0; coord < TriangleBatch::C_COUNT; ++coord)
+      {
+         if (n == P::SIZE)
+         {
+            lanes[coord] = P::load(coords[coord] + i);
+         }
+         else
+         {
+            for (size_t lane = 0; lane < P::SIZE; ++lane)
+            {
+               tail[coord][lane] = lane < n ? coords[coord][i + lane] : 0.0f;
+            }
+            lanes[coord] = P::load(tail[coord]);
+         }
+      }
+
+      const int hits = movemask(doTrianglesIntersect(
+         x, y, z,
+         vec3(lanes[0], lanes[1], lanes[2]),
+         vec3(lanes[3], lanes[4], lanes[5]),
+         vec3(lanes[6], lanes[7], lanes[8])
+      )) & ((1 << n) - 1);
+      if (hits)
+      {
+         return i + __builtin_ctz(hits);
+      }
+   }
+   return count;
+}
+
+
+}
+}
+
+
+#endif
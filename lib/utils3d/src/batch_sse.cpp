@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <cassert>
+
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+#include "batch_kernel.hpp"
+
+
+namespace utils3d {
+namespace batch {
+
+
+/***************************************************************************
+ *   SSE batch kernel implementation                                       *
+ ***************************************************************************/
+
+
+#ifdef __SSE2__
+
+
+namespace {
+
+struct _Mask
+{
+   __m128 v;
+};
+
+
+inline _Mask operator&(const _Mask & m1, const _Mask & m2)
+{
+   const _Mask m = {_mm_and_ps(m1.v, m2.v)};
+   return m;
+}
+
+
+inline _Mask operator|(const _Mask & m1, const _Mask & m2)
+{
+   const _Mask m = {_mm_or_ps(m1.v, m2.v)};
+   return m;
+}
+
+
+inline _Mask operator!(const _Mask & m)
+{
+   const __m128 ones = _mm_castsi128_ps(_mm_set1_epi32(-1));
+   const _Mask result = {_mm_xor_ps(m.v, ones)};
+   return result;
+}
+
+
+inline int movemask(const _Mask & m)
+{
+   return _mm_movemask_ps(m.v);
+}
+
+
+struct _Pack
+{
+   enum {SIZE = 4};
+
+   inline _Pack() {}
+   inline explicit _Pack(__m128 v) : v(v) {}
+   inline explicit _Pack(dt::Float f) : v(_mm_set1_ps(f)) {}
+
+   static inline _Pack zero() {return _Pack(_mm_setzero_ps());}
+   static inline _Pack load(const dt::Float * p)
+   {
+      return _Pack(_mm_loadu_ps(p));
+   }
+
+   __m128 v;
+};
+
+
+inline _Pack operator+(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm_add_ps(p1.v, p2.v));
+}
+
+
+inline _Pack operator-(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm_sub_ps(p1.v, p2.v));
+}
+
+
+inline _Pack operator*(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm_mul_ps(p1.v, p2.v));
+}
+
+
+inline _Pack operator/(const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm_div_ps(p1.v, p2.v));
+}
+
+
+inline _Pack sqrt(const _Pack & p)
+{
+   return _Pack(_mm_sqrt_ps(p.v));
+}
+
+
+inline _Mask gt(const _Pack & p1, const _Pack & p2)
+{
+   const _Mask m = {_mm_cmpgt_ps(p1.v, p2.v)};
+   return m;
+}
+
+
+inline _Mask le(const _Pack & p1, const _Pack & p2)
+{
+   const _Mask m = {_mm_cmple_ps(p1.v, p2.v)};
+   return m;
+}
+
+
+inline _Mask neq(const _Pack & p1, const _Pack & p2)
+{
+   const _Mask m = {_mm_cmpneq_ps(p1.v, p2.v)};
+   return m;
+}
+
+
+inline _Pack select(const _Mask & m, const _Pack & p1, const _Pack & p2)
+{
+   return _Pack(_mm_or_ps(
+      _mm_and_ps(m.v, p1.v),
+      _mm_andnot_ps(m.v, p2.v)
+   ));
+}
+
+} // anonymous namespace;
+
+
+bool isSseCompiled()
+{
+   return true;
+}
+
+
+size_t findSse(
+   const dt::Float * query,
+   const dt::Float * const * coords,
+   size_t count
+)
+{
+   return find<_Pack>(query, coords, count);
+}
+
+
+#else
+
+
+bool isSseCompiled()
+{
+   return false;
+}
+
+
+size_t findSse(const dt::Float *, const dt::Float * const *, size_t count)
+{
+   assert(false);
+   return count;
+}
+
+
+#endif
+
+
+}
+}
@@ -0,0 +1,241 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+
+#include <boost/test/unit_test.hpp>
+
+
+#include "batch.hpp"
+#include "geometry.hpp"
+
+
+using namespace utils3d;
+
+
+namespace {
+
+struct _Triangle
+{
+   dt::Pointf3 a;
+   dt::Pointf3 b;
+   dt::Pointf3 c;
+};
+
+
+dt::Float _random(dt::Float min, dt::Float max)
+{
+   return min + (max - min) * (static_cast<dt::Float>(rand()) / RAND_MAX);
+}
+
+
+dt::Pointf3 _randomPoint(dt::Float radius)
+{
+   return dt::Pointf3(
+      _random(-radius, radius),
+      _random(-radius, radius),
+      _random(-radius, radius)
+   );
+}
+
+
+// Random triangles close to each other, a few of them degenerate or sharing
+// points with the query to exercise the corner cases of the scalar code;
+_Triangle _randomTriangle(const _Triangle & query)
+{
+   _Triangle t = {_randomPoint(1.0f), _randomPoint(1.0f), _randomPoint(1.0f)};
+   switch (rand() % 16)
+   {
+      case 0: t.a = query.a; break;
+      case 1: t.b = query.b; t.c = query.c; break;
+      case 2: t.c = t.a; break;
+      case 3: t.a = t.b = t.c; break;
+      case 4: t.a.z = t.b.z = t.c.z = query.a.z; break;
+   }
+   return t;
+}
+
+
+std::vector<SimdLevel> _supportedLevels()
+{
+   std::vector<SimdLevel> levels;
+   for (int level = SL_SCALAR; level <= getSupportedSimdLevel(); ++level)
+   {
+      levels.push_back(static_cast<SimdLevel>(level));
+   }
+   return levels;
+}
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   Batch geometry utils test                                             *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(suite_libutils3d_batch)
+
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+   const dt::Pointf3 x(0.0f, 0.0f, 0.0f);
+   const dt::Pointf3 y(1.0f, 0.0f, 0.0f);
+   const dt::Pointf3 z(0.0f, 1.0f, 0.0f);
+   for (SimdLevel level : _supportedLevels())
+   {
+      BOOST_REQUIRE(!findTriangleIntersection(x, y, z, TriangleBatch(), level));
+   }
+}
+
+
+BOOST_AUTO_TEST_CASE(test_single)
+{
+   srand(1);
+   size_t hits = 0;
+   for (int i = 0; i < 20000; ++i)
+   {
+      _Triangle q = {
+         _randomPoint(1.0f),
+         _randomPoint(1.0f),
+         _randomPoint(1.0f)
+      };
+      if (i % 8 == 0)
+      {
+         q.b.z = q.c.z = q.a.z;
+      }
+      const _Triangle t = _randomTriangle(q);
+      const bool expected =
+         doTrianglesIntersect(q.a, q.b, q.c, t.a, t.b, t.c);
+      hits += expected;
+
+      TriangleBatch batch;
+      batch.append(t.a, t.b, t.c);
+      for (SimdLevel level : _supportedLevels())
+      {
+         const auto result =
+            findTriangleIntersection(q.a, q.b, q.c, batch, level);
+         BOOST_REQUIRE(bool(result) == expected);
+         BOOST_REQUIRE(!result || *result == 0);
+      }
+   }
+   BOOST_REQUIRE(hits > 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_first)
+{
+   srand(2);
+   for (int i = 0; i < 2000; ++i)
+   {
+      const _Triangle q = {
+         _randomPoint(3.0f),
+         _randomPoint(3.0f),
+         _randomPoint(3.0f)
+      };
+      TriangleBatch batch;
+      const size_t count = rand() % 40;
+      size_t expected = count;
+      for (size_t j = 0; j < count; ++j)
+      {
+         const _Triangle t = _randomTriangle(q);
+         batch.append(t.a, t.b, t.c);
+         if (expected == count &&
+            doTrianglesIntersect(q.a, q.b, q.c, t.a, t.b, t.c))
+         {
+            expected = j;
+         }
+      }
+
+      for (SimdLevel level : _supportedLevels())
+      {
+         const auto result =
+            findTriangleIntersection(q.a, q.b, q.c, batch, level);
+         BOOST_REQUIRE(result ? *result == expected : expected == count);
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+/***************************************************************************
+ *   Batch geometry utils benchmark                                        *
+ ***************************************************************************/
+
+
+BOOST_AUTO_TEST_SUITE(
+   suite_libutils3d_batch_benchmark,
+   * boost::unit_test::disabled()
+)
+
+
+BOOST_AUTO_TEST_CASE(benchmark_findTriangleIntersection)
+{
+   // Far apart triangles, so every one of them is tested;
+   srand(1);
+   const _Triangle q = {
+      dt::Pointf3(10.0f, 10.0f, 10.0f),
+      dt::Pointf3(11.0f, 10.0f, 10.0f),
+      dt::Pointf3(10.0f, 11.0f, 10.0f)
+   };
+   const size_t batchSizes[] = {4, 8, 16, 64};
+   for (size_t batchSize : batchSizes)
+   {
+      TriangleBatch batch;
+      for (size_t i = 0; i < batchSize; ++i)
+      {
+         batch.append(
+            _randomPoint(1.0f),
+            _randomPoint(1.0f),
+            _randomPoint(1.0f)
+         );
+      }
+
+      const size_t tests = 4000000;
+      for (SimdLevel level : _supportedLevels())
+      {
+         size_t hits = 0;
+         const auto start = std::chrono::steady_clock::now();
+         for (size_t i = 0; i < tests / batchSize; ++i)
+         {
+            if (findTriangleIntersection(q.a, q.b, q.c, batch, level))
+            {
+               ++hits;
+            }
+         }
+         const std::chrono::duration<double> time =
+            std::chrono::steady_clock::now() - start;
+
+         BOOST_REQUIRE(hits == 0);
+         std::cout << "batch of " << batchSize << ", level " << level <<
+            ": " << (tests / time.count() / 1e6) << " M tests/s" << std::endl;
+      }
+   }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,11 @@
  ***************************************************************************/
 
 
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+
+
 #include <QtCore/QtGlobal>
 
 
@@ -29,6 +34,7 @@ static const char * _tetrahedrosaur = QT_TRANSLATE_NOOP("Application", "Tetrahed
 
 
 #include "Application.hpp"
+#include "FigureCache.hpp"
 #include "MainWindow.hpp"
 #include "Project.hpp"
 #include "SharedGLWidget.hpp"
@@ -41,8 +47,60 @@ static const char * _tetrahedrosaur = QT_TRANSLATE_NOOP("Application", "Tetrahed
 
 
 Application::Application(int & argc, char ** argv)
-   : QApplication(argc, argv), m_initializationTimer(0)
+   : QApplication(argc, argv),
+   m_initializationTimer(0),
+   m_developmentBackend(DevelopmentEngine::B_GL),
+   m_developmentThreadCount(0),
+   m_relaxationBudInterval(0),
+   m_matingSeed(std::time(0))
 {
+   const QStringList args = arguments();
+   if (args.contains("--cpu-development"))
+   {
+      m_developmentBackend = DevelopmentEngine::B_CPU;
+   }
+   // Zero keeps the default of the engine, one thread per core;
+   const int threadsIndex = args.indexOf("--development-threads");
+   if (threadsIndex >= 0 && threadsIndex + 1 < args.size())
+   {
+      m_developmentThreadCount = std::max(0, args[threadsIndex + 1].toInt());
+   }
+   // Organisms are relaxed after development, optionally every K buds too;
+   const int relaxEveryIndex = args.indexOf("--relax-every");
+   if (relaxEveryIndex >= 0 && relaxEveryIndex + 1 < args.size())
+   {
+      m_relaxationBudInterval =
+         std::max(0, args[relaxEveryIndex + 1].toInt());
+   }
+   if (args.contains("--relax") || m_relaxationBudInterval > 0)
+   {
+      m_relaxationParams = mesh::RelaxationParams();
+   }
+   // Developed figures are held within a budget of megabytes, optionally
+   // stored in a directory for later sessions;
+   const int cacheSizeIndex = args.indexOf("--figure-cache-size");
+   if (cacheSizeIndex >= 0 && cacheSizeIndex + 1 < args.size())
+   {
+      FigureCache::instance().setBudget(
+         static_cast<size_t>(std::max(0, args[cacheSizeIndex + 1].toInt()))
+            << 20
+      );
+   }
+   const int cacheDirIndex = args.indexOf("--figure-cache-dir");
+   if (cacheDirIndex >= 0 && cacheDirIndex + 1 < args.size())
+   {
+      FigureCache::instance().setDirectory(args[cacheDirIndex + 1]);
+   }
+
+   // The seed is logged, so that a session can be mated again with the
+   // same random draws;
+   const int seedIndex = args.indexOf("--mating-seed");
+   if (seedIndex >= 0 && seedIndex + 1 < args.size())
+   {
+      m_matingSeed = args[seedIndex + 1].toULongLong();
+   }
+   std::cout << "{mating seed: " << m_matingSeed << "}" << std::endl;
+
    QIcon icon;
    icon.addFile(":/Tetrahedrosaur_24x24.png", QSize(24, 24));
    icon.addFile(":/Tetrahedrosaur_32x32.png", QSize(32, 32));
@@ -77,6 +135,36 @@ void Application::setProject(boost::shared_ptr<Project> project)
 }
 
 
+DevelopmentEngine::Backend Application::developmentBackend()
+{
+   return reinterpret_cast<Application *>(qApp)->m_developmentBackend;
+}
+
+
+int Application::developmentThreadCount()
+{
+   return reinterpret_cast<Application *>(qApp)->m_developmentThreadCount;
+}
+
+
+boost::optional<mesh::RelaxationParams> Application::relaxationParams()
+{
+   return reinterpret_cast<Application *>(qApp)->m_relaxationParams;
+}
+
+
+int Application::relaxationBudInterval()
+{
+   return reinterpret_cast<Application *>(qApp)->m_relaxationBudInterval;
+}
+
+
+uint64_t Application::matingSeed()
+{
+   return reinterpret_cast<Application *>(qApp)->m_matingSeed;
+}
+
+
 MainWindow * Application::mainWindow() const
 {
    return m_mainWindow;
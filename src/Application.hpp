@@ -22,6 +22,10 @@
 #define APPLICATION_HPP
 
 
+#include <cstdint>
+
+
+#include <boost/optional.hpp>
 #include <boost/shared_ptr.hpp>
 
 
@@ -29,6 +33,9 @@
 #include <QtWidgets/QApplication>
 
 
+#include "DevelopmentEngine.hpp"
+
+
 struct GuiOrganismDesc;
 class MainWindow;
 class Project;
@@ -50,6 +57,13 @@ class Application : public QApplication
       static boost::shared_ptr<Project> project();
       static void setProject(boost::shared_ptr<Project> project);
 
+      static DevelopmentEngine::Backend developmentBackend();
+      static int developmentThreadCount();
+      static boost::optional<mesh::RelaxationParams> relaxationParams();
+      static int relaxationBudInterval();
+      // Seeds the random generator of mating, the start time unless given;
+      static uint64_t matingSeed();
+
       MainWindow * mainWindow() const;
 
       void addOrganismTab(boost::shared_ptr<const GuiOrganismDesc> desc);
@@ -62,6 +76,11 @@ class Application : public QApplication
       void initialize();
 
       int m_initializationTimer;
+      DevelopmentEngine::Backend m_developmentBackend;
+      int m_developmentThreadCount;
+      boost::optional<mesh::RelaxationParams> m_relaxationParams;
+      int m_relaxationBudInterval;
+      uint64_t m_matingSeed;
       QPointer<MainWindow> m_mainWindow;
       boost::shared_ptr<Project> m_project;
 };
@@ -223,9 +223,8 @@ void ChromosomeDiffModel::setChromosomes(
          const bio::Instruction *leftData = leftCode.data();
          const bio::Instruction *rightData = rightCode.data();
          const algo::Alignment alignment(
-            leftCode,
-            rightCode,
-            *m_instructionEquals
+            chromosomes[left->get()].keys(*m_instructionEquals),
+            chromosomes[right->get()].keys(*m_instructionEquals)
          );
          m_items.reserve(std::max(alignment.leftSize(), alignment.rightSize()));
          algo::Alignment::const_iterator it = alignment.begin();
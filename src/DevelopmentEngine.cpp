@@ -18,18 +18,22 @@
  ***************************************************************************/
 
 
+#include <algorithm>
 #include <iostream>
 
 
+#include <QtCore/QThread>
 #include <QtCore/QTimerEvent>
 
 
 #include "DevelopmentEngine.hpp"
+#include "DevelopmentTask.hpp"
 #include "GuiOrganismDesc.hpp"
 #include "OrganismPixelBuffer.hpp"
 #include "SharedGLWidget.hpp"
 
 
+#include "bio/development.hpp"
 #include "bio/Organism.hpp"
 #include "mesh/Figure.hpp"
 #include "mesh/GLMesh.hpp"
@@ -44,20 +48,43 @@
 DevelopmentEngine::DevelopmentEngine(QObject * parent)
    : QObject(parent),
    m_isReady(true),
+   m_backend(B_GL),
    m_processingDesc(0),
    m_lastProgress(0),
-   m_timerId(0)
+   m_timerId(0),
+   m_relaxationBudInterval(0),
+   m_finishedTaskCount(0)
 {
+   m_pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount()));
 }
 
 
 DevelopmentEngine::~DevelopmentEngine()
 {
+   abort();
+}
+
+
+void DevelopmentEngine::setMaxThreadCount(int count)
+{
+   Q_ASSERT(count > 0);
+   m_pool.setMaxThreadCount(count);
+}
+
+
+void DevelopmentEngine::setRelaxation(
+   const boost::optional<mesh::RelaxationParams> & params,
+   size_t budInterval
+)
+{
+   m_relaxation = params;
+   m_relaxationBudInterval = budInterval;
 }
 
 
 void DevelopmentEngine::start(
-   const std::vector<boost::shared_ptr<GuiOrganismDesc> > & descs
+   const std::vector<boost::shared_ptr<GuiOrganismDesc> > & descs,
+   Backend backend
 )
 {
    if (m_isReady)
@@ -65,14 +92,57 @@ void DevelopmentEngine::start(
       Q_ASSERT(!m_buffer);
       Q_ASSERT(!m_processingOrganism);
       Q_ASSERT(!m_timerId);
+      Q_ASSERT(m_tasks.empty());
       if (!descs.empty())
       {
          m_isReady = false;
+         m_backend = backend;
          m_descs = descs;
          m_processingDesc = 0;
          m_lastProgress = 0;
-         m_buffer.reset(new OrganismPixelBuffer(512, 512));
-         m_timerId = startTimer(0);
+         m_keys.clear();
+         m_keys.reserve(m_descs.size());
+         for (const boost::shared_ptr<GuiOrganismDesc> & desc : m_descs)
+         {
+            m_keys.push_back(bio::developmentKey(
+               *desc,
+               m_backend,
+               m_relaxation,
+               m_relaxationBudInterval
+            ));
+         }
+         if (m_backend == B_GL)
+         {
+            m_buffer.reset(new OrganismPixelBuffer(512, 512));
+            m_timerId = startTimer(0);
+         }
+         else
+         {
+            m_finishedTaskCount = 0;
+            m_taskProgress.assign(m_descs.size(), -1);
+            m_cachedEntries.assign(m_descs.size(), boost::none);
+            FigureCache & cache = FigureCache::instance();
+            for (size_t i = 0; i < m_descs.size(); ++i)
+            {
+               // Cached descs are reported by the first poll;
+               m_cachedEntries[i] = cache.find(m_keys[i]);
+               if (m_cachedEntries[i])
+               {
+                  m_tasks.push_back(boost::shared_ptr<DevelopmentTask>());
+                  continue;
+               }
+               m_tasks.push_back(boost::shared_ptr<DevelopmentTask>(
+                  new DevelopmentTask(
+                     m_descs[i],
+                     m_relaxation,
+                     m_relaxationBudInterval
+                  )
+               ));
+               m_pool.start(m_tasks.back().get());
+            }
+            // Workers do not talk to the engine, their state is polled;
+            m_timerId = startTimer(25);
+         }
       }
       else
       {
@@ -88,11 +158,25 @@ void DevelopmentEngine::abort()
    {
       killTimer(m_timerId);
       m_timerId = 0;
+      for (size_t i = 0; i < m_tasks.size(); ++i)
+      {
+         if (m_tasks[i])
+         {
+            m_tasks[i]->cancel();
+         }
+      }
+      m_pool.clear();
+      m_pool.waitForDone();
+      m_tasks.clear();
+      m_taskProgress.clear();
+      m_cachedEntries.clear();
+      m_finishedTaskCount = 0;
       m_processingOrganism.reset(0);
       m_buffer.reset(0);
       m_processingDesc = 0;
       m_lastProgress = 0;
       m_descs.clear();
+      m_keys.clear();
       m_isReady = true;
    }
 }
@@ -102,67 +186,213 @@ void DevelopmentEngine::timerEvent(QTimerEvent * event)
 {
    if (m_timerId && event->timerId() == m_timerId)
    {
-      if (m_processingOrganism)
+      if (m_backend == B_GL)
       {
-         if (m_processingOrganism->isFinished())
+         stepOverProcessingOrganism();
+      }
+      else
+      {
+         pollTasks();
+      }
+   }
+}
+
+
+void DevelopmentEngine::stepOverProcessingOrganism()
+{
+   if (m_processingOrganism)
+   {
+      if (m_processingOrganism->isFinished())
+      {
+         completeDesc(m_processingDesc, *m_processingOrganism);
+         m_processingOrganism.reset(0);
+         nextProcessingDesc();
+      }
+      else
+      {
+         m_buffer->makeCurrent();
+         m_processingOrganism->stepOver();
+         const int progress = m_processingOrganism->progress();
+         if (m_lastProgress != progress)
          {
-            boost::shared_ptr<mesh::Figure> figure(
-               new mesh::Figure(m_processingOrganism->mesh())
-            );
-            const QImage image = m_buffer->paintFigure(figure).scaled(
-               128, 128, Qt::IgnoreAspectRatio, Qt::SmoothTransformation
-            );
-            emit descProgressChanged(m_processingDesc, 100);
-            emit descFinished(
-               m_processingDesc, figure, QPixmap::fromImage(image)
-            );
-
-            m_processingOrganism.reset(0);
-            if ((m_processingDesc + 1) < m_descs.size())
-            {
-               ++m_processingDesc;
-            }
-            else
-            {
-               killTimer(m_timerId);
-               m_timerId = 0;
-               m_buffer.reset(0);
-               m_processingDesc = 0;
-               m_lastProgress = 0;
-               m_descs.clear();
-               m_isReady = true;
-               emit allFinished();
-            }
+            m_lastProgress = progress;
+            emit descProgressChanged(m_processingDesc, progress);
          }
-         else
+      }
+   }
+   else if (!stepOverCachedDesc())
+   {
+      std::cout << *m_descs[m_processingDesc] << std::endl << std::flush;
+      m_processingOrganism.reset(new bio::Organism(
+         createMesh(),
+         m_descs[m_processingDesc]
+      ));
+      m_processingOrganism->setRelaxation(
+         m_relaxation,
+         m_relaxationBudInterval
+      );
+      m_lastProgress = 0;
+      emit descStarted(m_processingDesc);
+      emit descProgressChanged(m_processingDesc, 0);
+   }
+}
+
+
+bool DevelopmentEngine::stepOverCachedDesc()
+{
+   // Descs are looked up one by one, as equal ones of the same run are
+   // found after the first of them is grown;
+   const boost::optional<FigureCache::Entry> entry =
+      FigureCache::instance().find(m_keys[m_processingDesc]);
+   if (!entry)
+   {
+      return false;
+   }
+
+   emit descStarted(m_processingDesc);
+   completeDesc(m_processingDesc, *entry);
+   if (m_timerId)
+   {
+      nextProcessingDesc();
+   }
+   return true;
+}
+
+
+void DevelopmentEngine::nextProcessingDesc()
+{
+   if ((m_processingDesc + 1) < m_descs.size())
+   {
+      ++m_processingDesc;
+   }
+   else
+   {
+      finish();
+   }
+}
+
+
+void DevelopmentEngine::pollTasks()
+{
+   // Slots may abort the engine, so the bounds are rechecked every time;
+   for (size_t i = 0; m_timerId && i < m_tasks.size(); ++i)
+   {
+      if (m_cachedEntries[i])
+      {
+         const FigureCache::Entry entry = *m_cachedEntries[i];
+         m_cachedEntries[i] = boost::none;
+         emit descStarted(i);
+         completeDesc(i, entry);
+         if (m_timerId && ++m_finishedTaskCount == m_tasks.size())
          {
-            m_buffer->makeCurrent();
-            m_processingOrganism->stepOver();
-            const int progress = m_processingOrganism->progress();
-            if (m_lastProgress != progress)
-            {
-               m_lastProgress = progress;
-               emit descProgressChanged(m_processingDesc, progress);
-            }
+            finish();
+         }
+         continue;
+      }
+
+      const boost::shared_ptr<DevelopmentTask> task = m_tasks[i];
+      if (!task)
+      {
+         continue;
+      }
+
+      if (m_taskProgress[i] < 0)
+      {
+         if (!task->isStarted())
+         {
+            continue;
+         }
+         m_taskProgress[i] = 0;
+         emit descStarted(i);
+         emit descProgressChanged(i, 0);
+      }
+
+      if (task->isFinished())
+      {
+         const boost::shared_ptr<bio::Organism> organism = task->organism();
+         m_tasks[i].reset();
+         if (organism)
+         {
+            completeDesc(i, *organism);
+         }
+         if (m_timerId && ++m_finishedTaskCount == m_tasks.size())
+         {
+            finish();
          }
       }
       else
       {
-         const shader::Collection * sh = SharedGLWidget::instance()->shaders();
-         m_buffer->makeCurrent();
-         std::cout << *m_descs[m_processingDesc] << std::endl << std::flush;
-         m_processingOrganism.reset(new bio::Organism(
-            new mesh::GLMesh(
-               dt::Pointf3(0.0f, 0.5f, 0.0f),
-               dt::Pointf3(-0.5f, -0.5f, -0.5f),
-               dt::Pointf3(0.0f, -0.5f, 0.5f),
-               dt::Pointf3(0.5f, -0.5f, -0.5f),
-               *sh->feedbackShader()),
-            m_descs[m_processingDesc]
-         ));
-         m_lastProgress = 0;
-         emit descStarted(m_processingDesc);
-         emit descProgressChanged(m_processingDesc, 0);
+         const int progress = task->progress();
+         if (m_taskProgress[i] != progress)
+         {
+            m_taskProgress[i] = progress;
+            emit descProgressChanged(i, progress);
+         }
       }
    }
 }
+
+
+void DevelopmentEngine::completeDesc(
+   size_t descIndex,
+   const bio::Organism & organism
+)
+{
+   FigureCache::Entry entry;
+   entry.figure.reset(new mesh::Figure(organism.mesh()));
+   if (!m_buffer)
+   {
+      m_buffer.reset(new OrganismPixelBuffer(512, 512));
+   }
+   entry.portrait = m_buffer->paintFigure(entry.figure).scaled(
+      128, 128, Qt::IgnoreAspectRatio, Qt::SmoothTransformation
+   );
+   FigureCache::instance().insert(m_keys[descIndex], entry);
+   completeDesc(descIndex, entry);
+}
+
+
+void DevelopmentEngine::completeDesc(
+   size_t descIndex,
+   const FigureCache::Entry & entry
+)
+{
+   emit descProgressChanged(descIndex, 100);
+   emit descFinished(
+      descIndex,
+      entry.figure,
+      QPixmap::fromImage(entry.portrait)
+   );
+}
+
+
+void DevelopmentEngine::finish()
+{
+   killTimer(m_timerId);
+   m_timerId = 0;
+   m_pool.waitForDone();
+   m_tasks.clear();
+   m_taskProgress.clear();
+   m_cachedEntries.clear();
+   m_finishedTaskCount = 0;
+   m_buffer.reset(0);
+   m_processingDesc = 0;
+   m_lastProgress = 0;
+   m_descs.clear();
+   m_keys.clear();
+   m_isReady = true;
+   emit allFinished();
+}
+
+
+mesh::Mesh * DevelopmentEngine::createMesh() const
+{
+   const dt::Pointf3 a(0.0f, 0.5f, 0.0f);
+   const dt::Pointf3 b(-0.5f, -0.5f, -0.5f);
+   const dt::Pointf3 c(0.0f, -0.5f, 0.5f);
+   const dt::Pointf3 d(0.5f, -0.5f, -0.5f);
+
+   const shader::Collection * sh = SharedGLWidget::instance()->shaders();
+   m_buffer->makeCurrent();
+   return new mesh::GLMesh(a, b, c, d, *sh->feedbackShader());
+}
@@ -22,14 +22,26 @@
 #define DEVELOPMENTENGINE_HPP
 
 
+#include <vector>
+
+
+#include <boost/optional.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <boost/shared_ptr.hpp>
 
 
 #include <QtCore/QObject>
+#include <QtCore/QThreadPool>
 #include <QtGui/QPixmap>
 
 
+#include "mesh/Relaxation.hpp"
+
+
+#include "FigureCache.hpp"
+
+
+class DevelopmentTask;
 struct GuiOrganismDesc;
 class OrganismPixelBuffer;
 
@@ -39,6 +51,7 @@ class Organism;
 }
 namespace mesh {
 class Figure;
+class Mesh;
 }
 
 
@@ -52,13 +65,31 @@ class DevelopmentEngine : public QObject
    Q_OBJECT
 
    public:
+      enum Backend
+      {
+         B_GL = 0, // Meshes live in video memory, requires a GL context;
+         B_CPU     // Headless development, GL is used for portraits only,
+                   // organisms are grown concurrently on a worker pool;
+      };
+
       explicit DevelopmentEngine(QObject * parent = 0);
       virtual ~DevelopmentEngine();
 
       inline bool isReady() const {return m_isReady;}
 
+      inline int maxThreadCount() const {return m_pool.maxThreadCount();}
+      void setMaxThreadCount(int count);
+
+      // Organisms are relaxed after development and, given an interval,
+      // after every that many buds;
+      void setRelaxation(
+         const boost::optional<mesh::RelaxationParams> & params,
+         size_t budInterval = 0
+      );
+
       void start(
-         const std::vector<boost::shared_ptr<GuiOrganismDesc> > & descs
+         const std::vector<boost::shared_ptr<GuiOrganismDesc> > & descs,
+         Backend backend = B_GL
       );
       void abort();
 
@@ -76,13 +107,36 @@ class DevelopmentEngine : public QObject
       void allFinished();
 
    private:
+      mesh::Mesh * createMesh() const;
+      void stepOverProcessingOrganism();
+      void pollTasks();
+      bool stepOverCachedDesc();
+      void nextProcessingDesc();
+      void completeDesc(size_t descIndex, const bio::Organism & organism);
+      void completeDesc(size_t descIndex, const FigureCache::Entry & entry);
+      void finish();
+
       bool m_isReady;
+      Backend m_backend;
       std::vector<boost::shared_ptr<GuiOrganismDesc> > m_descs;
       boost::scoped_ptr<OrganismPixelBuffer> m_buffer;
       boost::scoped_ptr<bio::Organism> m_processingOrganism;
       size_t m_processingDesc;
       int m_lastProgress;
       int m_timerId;
+      boost::optional<mesh::RelaxationParams> m_relaxation;
+      size_t m_relaxationBudInterval;
+      // Keys of the descs in the figure cache;
+      std::vector<uint64_t> m_keys;
+
+      // CPU backend, one task per desc, null once the desc is reported
+      // finished or when its figure is cached. Progress of -1 means the task
+      // has not been started yet;
+      QThreadPool m_pool;
+      std::vector<boost::shared_ptr<DevelopmentTask> > m_tasks;
+      std::vector<boost::optional<FigureCache::Entry> > m_cachedEntries;
+      std::vector<int> m_taskProgress;
+      size_t m_finishedTaskCount;
 };
 
 
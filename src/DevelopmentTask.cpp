@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#include "DevelopmentTask.hpp"
+
+
+#include "bio/Organism.hpp"
+#include "mesh/CpuMesh.hpp"
+
+
+/***************************************************************************
+ *   DevelopmentTask class implementation                                  *
+ ***************************************************************************/
+
+
+DevelopmentTask::DevelopmentTask(
+   boost::shared_ptr<const bio::OrganismDesc> desc,
+   const boost::optional<mesh::RelaxationParams> & relaxation,
+   size_t relaxationBudInterval
+)
+   : QRunnable(),
+   m_desc(desc),
+   m_relaxation(relaxation),
+   m_relaxationBudInterval(relaxationBudInterval),
+   m_isStarted(false),
+   m_isFinished(false),
+   m_isCanceled(false),
+   m_progress(0)
+{
+   setAutoDelete(false);
+}
+
+
+DevelopmentTask::~DevelopmentTask()
+{
+}
+
+
+void DevelopmentTask::cancel()
+{
+   m_isCanceled.store(true);
+}
+
+
+void DevelopmentTask::run()
+{
+   m_isStarted.store(true);
+   if (!m_isCanceled.load())
+   {
+      // Figures of another initial mesh need another DEVELOPMENT_VERSION;
+      m_organism.reset(new bio::Organism(
+         new mesh::CpuMesh(
+            dt::Pointf3(0.0f, 0.5f, 0.0f),
+            dt::Pointf3(-0.5f, -0.5f, -0.5f),
+            dt::Pointf3(0.0f, -0.5f, 0.5f),
+            dt::Pointf3(0.5f, -0.5f, -0.5f)
+         ),
+         m_desc
+      ));
+      m_organism->setRelaxation(m_relaxation, m_relaxationBudInterval);
+      while (!m_organism->isFinished() && !m_isCanceled.load())
+      {
+         m_organism->stepOver();
+         m_progress.store(m_organism->progress());
+      }
+      if (!m_organism->isFinished())
+      {
+         m_organism.reset();
+      }
+   }
+   m_isFinished.store(true);
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+
+#ifndef DEVELOPMENTTASK_HPP
+#define DEVELOPMENTTASK_HPP
+
+
+#include <atomic>
+
+
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+
+
+#include <QtCore/QRunnable>
+
+
+#include "mesh/Relaxation.hpp"
+
+
+namespace bio {
+class Organism;
+struct OrganismDesc;
+}
+
+
+/***************************************************************************
+ *   DevelopmentTask class declaration                                     *
+ ***************************************************************************/
+
+
+// Grows a single organism on a headless mesh from start to finish, it is
+// meant to be run by a worker thread. State is published through atomics,
+// the organism may be accessed only once isFinished() has returned true;
+class DevelopmentTask : public QRunnable
+{
+   public:
+      explicit DevelopmentTask(
+         boost::shared_ptr<const bio::OrganismDesc> desc,
+         const boost::optional<mesh::RelaxationParams> & relaxation =
+            boost::none,
+         size_t relaxationBudInterval = 0
+      );
+      virtual ~DevelopmentTask();
+
+      inline bool isStarted() const {return m_isStarted.load();}
+      inline bool isFinished() const {return m_isFinished.load();}
+      inline int progress() const {return m_progress.load();}
+
+      void cancel();
+
+      inline boost::shared_ptr<bio::Organism> organism() const;
+
+      virtual void run();
+
+   private:
+      boost::shared_ptr<const bio::OrganismDesc> m_desc;
+      boost::optional<mesh::RelaxationParams> m_relaxation;
+      size_t m_relaxationBudInterval;
+      boost::shared_ptr<bio::Organism> m_organism;
+      std::atomic<bool> m_isStarted;
+      std::atomic<bool> m_isFinished;
+      std::atomic<bool> m_isCanceled;
+      std::atomic<int> m_progress;
+};
+
+
+inline boost::shared_ptr<bio::Organism> DevelopmentTask::organism() const
+{
+   Q_ASSERT(isFinished());
+   return m_organism;
+}
+
+
+#endif
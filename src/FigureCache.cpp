@@ -0,0 +1,340 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#include <sstream>
+#include <string>
+
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+
+#include "FigureCache.hpp"
+
+
+#include "mesh/Figure.hpp"
+#include "mesh/Triangle.hpp"
+#include "mesh/Vertex.hpp"
+
+
+namespace {
+
+
+#define _FIGURE_MAGIC_NUMBER 0x43474946
+#define _FIGURE_VERSION 2
+
+
+#pragma pack(push)
+#pragma pack(1)
+
+
+struct _FigureHeader
+{
+   explicit _FigureHeader()
+      : magicNumber(0), version(0), key(0), portraitSize(0)
+   {}
+   explicit _FigureHeader(uint64_t key, uint32_t portraitSize)
+      : magicNumber(_FIGURE_MAGIC_NUMBER),
+      version(_FIGURE_VERSION),
+      key(key),
+      portraitSize(portraitSize)
+   {}
+   uint32_t magicNumber;
+   uint16_t version;
+   uint64_t key;
+   uint32_t portraitSize;
+};
+
+
+#pragma pack(pop)
+
+
+size_t _byteCount(const FigureCache::Entry & entry)
+{
+   return sizeof(entry) +
+      entry.figure->vertexCount() * sizeof(mesh::Vertex) +
+      entry.figure->triangleCount() * sizeof(mesh::Triangle) +
+      static_cast<size_t>(entry.portrait.sizeInBytes());
+}
+
+
+// Stored figures are the header, the PNG portrait and the figure as
+// mesh::Figure::write() puts it;
+boost::optional<FigureCache::Entry> _readFigure(
+   QIODevice & file,
+   uint64_t key
+)
+{
+   // Read header;
+   _FigureHeader hdr;
+   qint64 size = file.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+   if (size != sizeof(hdr) ||
+      hdr.magicNumber != _FIGURE_MAGIC_NUMBER ||
+      hdr.version != _FIGURE_VERSION ||
+      hdr.key != key
+   )
+   {
+      return boost::none;
+   }
+
+   // Read portrait;
+   const QByteArray png = file.read(hdr.portraitSize);
+   FigureCache::Entry entry;
+   if (png.size() != static_cast<int>(hdr.portraitSize) ||
+      !entry.portrait.loadFromData(png, "PNG")
+   )
+   {
+      return boost::none;
+   }
+
+   // Read figure;
+   const QByteArray data = file.readAll();
+   std::istringstream is(std::string(data.constData(), data.size()));
+   entry.figure.reset(mesh::Figure::read(is));
+   if (!entry.figure)
+   {
+      return boost::none;
+   }
+   return entry;
+}
+
+
+bool _writeFigure(
+   QIODevice & file,
+   uint64_t key,
+   const FigureCache::Entry & entry
+)
+{
+   QByteArray png;
+   QBuffer buffer(&png);
+   if (!buffer.open(QIODevice::WriteOnly) ||
+      !entry.portrait.save(&buffer, "PNG")
+   )
+   {
+      return false;
+   }
+   std::ostringstream os;
+   if (!entry.figure->write(os))
+   {
+      return false;
+   }
+   const std::string data = os.str();
+
+   // Write header;
+   const _FigureHeader header(key, png.size());
+   if (file.write(reinterpret_cast<const char *>(&header), sizeof(header)) !=
+      sizeof(header)
+   )
+   {
+      return false;
+   }
+
+   // Write portrait and figure;
+   if (file.write(png) != png.size() ||
+      file.write(data.data(), data.size()) !=
+         static_cast<qint64>(data.size())
+   )
+   {
+      return false;
+   }
+
+   return true;
+}
+
+
+} // anonymous namespace;
+
+
+/***************************************************************************
+ *   FigureCache class implementation                                      *
+ ***************************************************************************/
+
+
+FigureCache::FigureCache(size_t budget)
+   : m_entries(budget), m_hitCount(0), m_missCount(0)
+{
+}
+
+
+FigureCache::~FigureCache()
+{
+}
+
+
+FigureCache & FigureCache::instance()
+{
+   static FigureCache cache;
+   return cache;
+}
+
+
+boost::optional<FigureCache::Entry> FigureCache::find(uint64_t key)
+{
+   QString path;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      const boost::optional<Entry> held = m_entries.find(key);
+      if (held)
+      {
+         ++m_hitCount;
+         return held;
+      }
+      if (m_directory.isEmpty())
+      {
+         ++m_missCount;
+         return boost::none;
+      }
+      path = filePath(key);
+   }
+
+   // Stored figures are read without the lock held;
+   boost::optional<Entry> entry;
+   QFile file(path);
+   if (file.open(QIODevice::ReadOnly))
+   {
+      entry = _readFigure(file, key);
+   }
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+   if (entry)
+   {
+      ++m_hitCount;
+      hold(key, *entry);
+   }
+   else
+   {
+      ++m_missCount;
+   }
+   return entry;
+}
+
+
+void FigureCache::insert(uint64_t key, const Entry & entry)
+{
+   QString path;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      hold(key, entry);
+      if (m_directory.isEmpty())
+      {
+         return;
+      }
+      path = filePath(key);
+   }
+
+   // A partially written figure never replaces the file;
+   QSaveFile file(path);
+   if (file.open(QIODevice::WriteOnly) && _writeFigure(file, key, entry))
+   {
+      file.commit();
+   }
+   else
+   {
+      file.cancelWriting();
+   }
+}
+
+
+void FigureCache::clear()
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_entries.clear();
+   m_hitCount = 0;
+   m_missCount = 0;
+}
+
+
+size_t FigureCache::budget() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_entries.budget();
+}
+
+
+void FigureCache::setBudget(size_t budget)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_entries.setBudget(budget);
+}
+
+
+QString FigureCache::directory() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_directory;
+}
+
+
+void FigureCache::setDirectory(const QString & directory)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   m_directory = directory;
+   if (!m_directory.isEmpty())
+   {
+      QDir().mkpath(m_directory);
+   }
+}
+
+
+size_t FigureCache::size() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_entries.size();
+}
+
+
+size_t FigureCache::byteCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_entries.cost();
+}
+
+
+uint64_t FigureCache::hitCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_hitCount;
+}
+
+
+uint64_t FigureCache::missCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_missCount;
+}
+
+
+void FigureCache::hold(uint64_t key, const Entry & entry)
+{
+   // Development is deterministic, a figure held under the key already is
+   // the same;
+   m_entries.insert(key, entry, _byteCount(entry));
+}
+
+
+QString FigureCache::filePath(uint64_t key) const
+{
+   const QString name = QString("%1.fig").arg(
+      static_cast<qulonglong>(key), 16, 16, QChar('0')
+   );
+   return QDir(m_directory).filePath(name);
+}
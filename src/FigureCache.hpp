@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2015 Andrey Timashov                                    *
+ *                                                                         *
+ *   This file is part of Tetrahedrosaur.                                  *
+ *                                                                         *
+ *   Tetrahedrosaur is free software: you can redistribute it and/or       *
+ *   modify it under the terms of the GNU General Public License as        *
+ *   published by the Free Software Foundation, either version 3 of the    *
+ *   License, or (at your option) any later version.                       *
+ *                                                                         *
+ *   Tetrahedrosaur is distributed in the hope that it will be useful,     *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU      *
+ *   General Public License for more details.                              *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with Tetrahedrosaur. If not, see <http://www.gnu.org/licenses/> *
+ ***************************************************************************/
+
+
+#ifndef FIGURECACHE_HPP
+#define FIGURECACHE_HPP
+
+
+#include <cstdint>
+#include <mutex>
+
+
+#include <boost/optional.hpp>
+#include <boost/shared_ptr.hpp>
+
+
+#include <QtCore/QString>
+#include <QtGui/QImage>
+
+
+#include "algo/LruCache.hpp"
+
+
+namespace mesh {
+class Figure;
+}
+
+
+/***************************************************************************
+ *   FigureCache class declaration                                         *
+ ***************************************************************************/
+
+
+// Keeps developed figures with their portraits under their development keys,
+// see bio::developmentKey(); offspring equal to their parents or to each
+// other are not grown again. Figures are held within a budget of bytes, the
+// least recently used ones are dropped first. Given a directory, figures are
+// stored there as well and are found again by later sessions;
+class FigureCache
+{
+   public:
+      struct Entry
+      {
+         boost::shared_ptr<mesh::Figure> figure;
+         QImage portrait;
+      };
+
+      explicit FigureCache(size_t budget = 256 << 20);
+      virtual ~FigureCache();
+
+      // The cache shared by all development engines;
+      static FigureCache & instance();
+
+      boost::optional<Entry> find(uint64_t key);
+      void insert(uint64_t key, const Entry & entry);
+
+      // Drops all figures held in memory and resets the counts, stored ones
+      // are kept;
+      void clear();
+
+      size_t budget() const;
+      void setBudget(size_t budget);
+
+      // An empty directory turns storing off;
+      QString directory() const;
+      void setDirectory(const QString & directory);
+
+      size_t size() const;
+      size_t byteCount() const;
+      uint64_t hitCount() const;
+      uint64_t missCount() const;
+
+   private:
+      void hold(uint64_t key, const Entry & entry);
+      QString filePath(uint64_t key) const;
+
+      mutable std::mutex m_mutex;
+      QString m_directory;
+      // Costs are the byte counts of the entries;
+      algo::LruCache<uint64_t, Entry> m_entries;
+      uint64_t m_hitCount;
+      uint64_t m_missCount;
+};
+
+
+#endif
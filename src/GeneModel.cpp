@@ -22,6 +22,7 @@
 
 
 static const char * _context = "GeneModel";
+static const char * _copies = QT_TRANSLATE_NOOP("GeneModel", "Copies");
 static const char * _generation = QT_TRANSLATE_NOOP("GeneModel", "Generation");
 static const char * _budAbc = QT_TRANSLATE_NOOP("GeneModel", "Bud ABC");
 static const char * _budAcd = QT_TRANSLATE_NOOP("GeneModel", "Bud ACD");
@@ -141,6 +142,8 @@ QVariant GeneModel::data(const QModelIndex & index, int role) const
             const bio::Gene & gene = genes[row];
             switch (index.column())
             {
+               case CID_COPIES:
+                  return m_genome->geneWeights()[row];
                case CID_GENERATION:
                   return QString::fromStdString(
                      gene.generationCondition.toString()
@@ -212,6 +215,8 @@ QVariant GeneModel::headerData(
       {
          switch (section)
          {
+            case CID_COPIES:
+               return TSLC(_copies);
             case CID_GENERATION:
                return TSLC(_generation);
             case CID_X:
@@ -59,9 +59,12 @@ class GeneModel : public QAbstractTableModel
       virtual int rowCount(const QModelIndex & parent = QModelIndex()) const;
 
    private:
+      // Genes are unique, the copies column tells how many times the
+      // chromosomes carry each one;
       enum COLUMN_ID
       {
-         CID_GENERATION = 0,
+         CID_COPIES = 0,
+         CID_GENERATION,
          CID_X,
          CID_Y,
          CID_BUD_ABC,
@@ -31,6 +31,7 @@ static const char * _swap = QT_TRANSLATE_NOOP("MatingWidget", "Swap");
 #include <QtWidgets/QStyleOptionFrame>
 
 
+#include "Application.hpp"
 #include "GuiOrganismDesc.hpp"
 #include "MatingWidget.hpp"
 #include "translation.hpp"
@@ -61,7 +62,8 @@ bio::OrganismDesc * _createGuiOrganismDesc()
 MatingWidget::MatingWidget(QWidget * parent)
    : QWidget(parent),
    m_clearButton(0),
-   m_swapButton(0)
+   m_swapButton(0),
+   m_random(Application::matingSeed())
 {
    m_clearButton = new QPushButton(
       QIcon(style()->standardPixmap(QStyle::SP_TrashIcon)),
@@ -118,7 +120,7 @@ void MatingWidget::setRightParent(
 std::vector<boost::shared_ptr<GuiOrganismDesc> > MatingWidget::mate(
    size_t count,
    const bio::MutationParams & params
-) const
+)
 {
    std::vector<boost::shared_ptr<const bio::OrganismDesc> > parents;
    parents.reserve(2);
@@ -139,10 +141,11 @@ std::vector<boost::shared_ptr<GuiOrganismDesc> > MatingWidget::mate(
       {
          boost::shared_ptr<GuiOrganismDesc> desc(new GuiOrganismDesc());
          desc->initialConditions.cellLimit = 100;
-         desc->initialConditions.applyMutations(params);
+         desc->initialConditions.applyMutations(params, m_random);
          desc->genome.reset(new bio::Genome(
             boost::shared_ptr<const bio::Config>(new bio::Config()),
-            params
+            params,
+            m_random
          ));
          result.push_back(desc);
       }
@@ -154,7 +157,8 @@ std::vector<boost::shared_ptr<GuiOrganismDesc> > MatingWidget::mate(
          _createGuiOrganismDesc, // TODO: use lambda;
          count,
          boost::shared_ptr<const bio::Config>(new bio::Config()),
-         params
+         params,
+         m_random
       ));
       result.reserve(offsprings.size());
       for (boost::shared_ptr<bio::OrganismDesc> offspring : offsprings)
@@ -33,6 +33,9 @@
 QT_FORWARD_DECLARE_CLASS(QPushButton)
 
 
+#include "algo/random_generators.hpp"
+
+
 struct GuiOrganismDesc;
 
 
@@ -62,7 +65,7 @@ class MatingWidget : public QWidget
       std::vector<boost::shared_ptr<GuiOrganismDesc> > mate(
          size_t count,
          const bio::MutationParams & params
-      ) const;
+      );
 
    public slots:
       void clear();
@@ -78,6 +81,7 @@ class MatingWidget : public QWidget
       QPixmap m_rightPortrait;
       boost::shared_ptr<const GuiOrganismDesc> m_leftParent;
       boost::shared_ptr<const GuiOrganismDesc> m_rightParent;
+      algo::CounterRandomGenerator m_random; // See Application::matingSeed();
 };
 
 
@@ -18,6 +18,7 @@
  ***************************************************************************/
 
 
+#include "Application.hpp"
 #include "custom_enums.hpp"
 #include "DevelopmentEngine.hpp"
 #include "GuiOrganismDesc.hpp"
@@ -38,6 +39,14 @@ OffspringModel::OffspringModel(QObject * parent)
    m_baseItemIndex(0)
 {
    m_engine = new DevelopmentEngine(this);
+   if (Application::developmentThreadCount())
+   {
+      m_engine->setMaxThreadCount(Application::developmentThreadCount());
+   }
+   m_engine->setRelaxation(
+      Application::relaxationParams(),
+      Application::relaxationBudInterval()
+   );
    connect(
       m_engine,
       SIGNAL(descStarted(size_t)),
@@ -89,7 +98,7 @@ void OffspringModel::append(
       }
       endInsertColumns();
 
-      m_engine->start(offsprings);
+      m_engine->start(offsprings, Application::developmentBackend());
    }
 }
 
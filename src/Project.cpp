@@ -42,31 +42,38 @@ namespace {
 #define _CHROMOSOME_MAGIC_NUMBER 0x454d4843
 #define _ORGANISM_DESC_MAGIC_NUMBER 0x4e47524f
 #define _PROJECT_MAGIC_NUMBER 0x374b4c45
-#define _PROJECT_VERSION 4
+#define _PROJECT_VERSION 5
+#define _PROJECT_VERSION_16BIT_CELL_LIMIT 4
 
 
 #pragma pack(push)
 #pragma pack(1)
 
 
-struct _InitialConditionsHeader
+template <typename CellLimit>
+struct _InitialConditionsHeaderT
 {
-   explicit _InitialConditionsHeader()
+   explicit _InitialConditionsHeaderT()
       : magicNumber(0), cellLimit(0), x(0), y(0)
    {}
-   explicit _InitialConditionsHeader(uint16_t cellLimit, int16_t x, int16_t y)
+   explicit _InitialConditionsHeaderT(CellLimit cellLimit, int16_t x, int16_t y)
       : magicNumber(_INITIALCONDITIONS_MAGIC_NUMBER),
       cellLimit(cellLimit),
       x(x),
       y(y)
    {}
    uint32_t magicNumber;
-   uint16_t cellLimit;
+   CellLimit cellLimit;
    int16_t x;
    int16_t y;
 };
 
 
+typedef _InitialConditionsHeaderT<uint32_t> _InitialConditionsHeader;
+// Version 4 projects store a 16-bit cell limit;
+typedef _InitialConditionsHeaderT<uint16_t> _InitialConditionsHeader16;
+
+
 struct _ChromosomeHeader
 {
    explicit _ChromosomeHeader() : magicNumber(0), count(0) {}
@@ -115,10 +122,11 @@ struct _ProjectHeader
 #pragma pack(pop)
 
 
+template <typename Header>
 bool _readInitialConditions(QIODevice & file, bio::InitialConditions & ic)
 {
    // Read header;
-   _InitialConditionsHeader hdr;
+   Header hdr;
    qint64 size = file.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
    if (size != sizeof(hdr) ||
       hdr.magicNumber != _INITIALCONDITIONS_MAGIC_NUMBER
@@ -205,7 +213,10 @@ bool _writeChromosome(QIODevice & file, const bio::Chromosome & cr)
 }
 
 
-boost::shared_ptr<GuiOrganismDesc> _readOrganismDesc(QIODevice & file)
+boost::shared_ptr<GuiOrganismDesc> _readOrganismDesc(
+   QIODevice & file,
+   uint16_t version
+)
 {
    // Read header;
    _OrganismDescHeader hdr;
@@ -218,7 +229,14 @@ boost::shared_ptr<GuiOrganismDesc> _readOrganismDesc(QIODevice & file)
    boost::shared_ptr<GuiOrganismDesc> desc(new GuiOrganismDesc);
 
    // Read initial conditions;
-   if (!_readInitialConditions(file, desc->initialConditions))
+   const bool ok = (version > _PROJECT_VERSION_16BIT_CELL_LIMIT) ?
+      _readInitialConditions<_InitialConditionsHeader>(
+         file, desc->initialConditions
+      ) :
+      _readInitialConditions<_InitialConditionsHeader16>(
+         file, desc->initialConditions
+      );
+   if (!ok)
    {
       return boost::shared_ptr<GuiOrganismDesc>();
    }
@@ -347,7 +365,8 @@ boost::shared_ptr<Project> Project::open(const QString & fileName)
          _ProjectHeader hdr;
          qint64 size = file.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
          if (size == sizeof(hdr) && hdr.magicNumber == _PROJECT_MAGIC_NUMBER &&
-            hdr.version == _PROJECT_VERSION)
+            hdr.version >= _PROJECT_VERSION_16BIT_CELL_LIMIT &&
+            hdr.version <= _PROJECT_VERSION)
          {
             QByteArray projectName = file.read(hdr.nameSize);
             if (projectName.size() == hdr.nameSize)
@@ -358,7 +377,7 @@ boost::shared_ptr<Project> Project::open(const QString & fileName)
                project->m_population.reserve(hdr.populationSize);
                for (uint32_t i = 0; i < hdr.populationSize; ++i)
                {
-                  auto desc = _readOrganismDesc(file);
+                  auto desc = _readOrganismDesc(file, hdr.version);
                   if (!desc)
                   {
                      project.reset();
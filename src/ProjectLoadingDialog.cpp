@@ -30,6 +30,7 @@ static const char * _loadingProject = QT_TRANSLATE_NOOP("ProjectLoadingDialog",
 #include <QtWidgets/QVBoxLayout>
 
 
+#include "Application.hpp"
 #include "DevelopmentEngine.hpp"
 #include "Project.hpp"
 #include "ProjectLoadingDialog.hpp"
@@ -90,6 +91,14 @@ void ProjectLoadingDialog::showEvent(QShowEvent * event)
    if (!m_engine)
    {
       m_engine = new DevelopmentEngine(this);
+      if (Application::developmentThreadCount())
+      {
+         m_engine->setMaxThreadCount(Application::developmentThreadCount());
+      }
+      m_engine->setRelaxation(
+         Application::relaxationParams(),
+         Application::relaxationBudInterval()
+      );
       connect(
          m_engine,
          SIGNAL(descProgressChanged(size_t, int)),
@@ -101,7 +110,10 @@ void ProjectLoadingDialog::showEvent(QShowEvent * event)
          SLOT(setDescFigure(size_t, boost::shared_ptr<mesh::Figure>, QPixmap))
       );
       connect(m_engine, SIGNAL(allFinished()), SLOT(accept()));
-      m_engine->start(m_project->population());
+      m_engine->start(
+         m_project->population(),
+         Application::developmentBackend()
+      );
    }
 }
 
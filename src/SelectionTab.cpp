@@ -29,15 +29,18 @@ static const char * _mateCustom = QT_TRANSLATE_NOOP("SelectionTab", "Mate with c
 static const char * _setCustomMutationRate = QT_TRANSLATE_NOOP("SelectionTab", "Set custom mutation rate");
 static const char * _clearOffspringsButton = QT_TRANSLATE_NOOP("SelectionTab", "Clear offsprings");
 static const char * _customMutationRate = QT_TRANSLATE_NOOP("SelectionTab", "Custom mutation rate");
+static const char * _matingRound = QT_TRANSLATE_NOOP("SelectionTab", "Similarity cache: %1 hits, %2 misses. Figure cache: %3 hits, %4 misses");
 
 
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QGridLayout>
 #include <QtWidgets/QHBoxLayout>
 #include <QtWidgets/QMenu>
+#include <QtWidgets/QStatusBar>
 #include <QtWidgets/QToolButton>
 
 #include "Application.hpp"
+#include "FigureCache.hpp"
 #include "FigureViewport.hpp"
 #include "GuiOrganismDesc.hpp"
 #include "MainWindow.hpp"
@@ -50,6 +53,9 @@ static const char * _customMutationRate = QT_TRANSLATE_NOOP("SelectionTab", "Cus
 #include "translation.hpp"
 
 
+#include "bio/SimilarityCache.hpp"
+
+
 SelectionTab::SelectionTab(QWidget * parent)
    : MainWindowTab(parent),
    m_projectView(0),
@@ -63,7 +69,11 @@ SelectionTab::SelectionTab(QWidget * parent)
    m_clearOffspringsButton(0),
    m_viewport(0),
    m_previewFigureCausedByClearSelection(false),
-   m_customMutationParams(bio::MutationParams::medium())
+   m_customMutationParams(bio::MutationParams::medium()),
+   m_similarityHitCount(0),
+   m_similarityMissCount(0),
+   m_figureHitCount(0),
+   m_figureMissCount(0)
 {
    m_project = Application::project();
    m_offspringModel = new OffspringModel(this);
@@ -124,6 +134,7 @@ SelectionTab::SelectionTab(QWidget * parent)
       m_offspringView, SLOT(scrollToIndex(const QModelIndex &))
    );
    connect(m_offspringModel, SIGNAL(finished()), SLOT(updateState()));
+   connect(m_offspringModel, SIGNAL(finished()), SLOT(reportMatingRound()));
    connect(m_mateLowButton, SIGNAL(clicked()), SLOT(mateLow()));
    connect(m_mateMediumButton, SIGNAL(clicked()), SLOT(mateMedium()));
    connect(m_mateHighButton, SIGNAL(clicked()), SLOT(mateHigh()));
@@ -256,6 +267,21 @@ void SelectionTab::previewFigure()
 }
 
 
+void SelectionTab::reportMatingRound()
+{
+   const bio::SimilarityCache & similarityCache =
+      bio::SimilarityCache::instance();
+   const FigureCache & figureCache = FigureCache::instance();
+   Application::instance()->mainWindow()->statusBar()->showMessage(
+      TSLC(_matingRound)
+         .arg(similarityCache.hitCount() - m_similarityHitCount)
+         .arg(similarityCache.missCount() - m_similarityMissCount)
+         .arg(figureCache.hitCount() - m_figureHitCount)
+         .arg(figureCache.missCount() - m_figureMissCount)
+   );
+}
+
+
 QToolButton * SelectionTab::createToolButton(
    const QIcon & icon,
    const char * tip
@@ -273,6 +299,14 @@ void SelectionTab::mate(const bio::MutationParams & mutationParams)
 {
    if (m_offspringModel->isReady())
    {
+      const bio::SimilarityCache & similarityCache =
+         bio::SimilarityCache::instance();
+      const FigureCache & figureCache = FigureCache::instance();
+      m_similarityHitCount = similarityCache.hitCount();
+      m_similarityMissCount = similarityCache.missCount();
+      m_figureHitCount = figureCache.hitCount();
+      m_figureMissCount = figureCache.missCount();
+
       const auto offsprings = m_matingWidget->mate(1, mutationParams);
       if (!offsprings.empty())
       {
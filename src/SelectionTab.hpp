@@ -22,6 +22,9 @@
 #define SELECTIONTAB_HPP
 
 
+#include <cstdint>
+
+
 #include <boost/shared_ptr.hpp>
 
 
@@ -60,6 +63,7 @@ class SelectionTab : public MainWindowTab
       void setMate(const QModelIndex & index);
       void moveToPopulation(const QModelIndex & index);
       void previewFigure();
+      void reportMatingRound();
 
    private:
       QToolButton * createToolButton(const QIcon & icon, const char * tip);
@@ -78,6 +82,12 @@ class SelectionTab : public MainWindowTab
       FigureViewport * m_viewport;
       bool m_previewFigureCausedByClearSelection;
       bio::MutationParams m_customMutationParams;
+      // Cache counters at the start of the mating round, the round reports
+      // the lookups it made;
+      uint64_t m_similarityHitCount;
+      uint64_t m_similarityMissCount;
+      uint64_t m_figureHitCount;
+      uint64_t m_figureMissCount;
 };
 
 
@@ -18,16 +18,11 @@
  ***************************************************************************/
 
 
-#include <cstdlib>
-#include <ctime>
-
-
 #include "Application.hpp"
 
 
 int main(int argc, char ** argv)
 {
-   srand(time(0));
    Application application(argc, argv);
    return application.exec();
 }